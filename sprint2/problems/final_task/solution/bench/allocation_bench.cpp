@@ -0,0 +1,186 @@
+// Проверка того, что сетевой уровень в установившемся режиме не обращается к куче. Глобальные
+// operator new/delete этой программы подсчитывают выделения памяти в потоке сервера. Клиент
+// отправляет запросы по постоянному соединению на loopback, сервер отвечает заранее
+// сериализованным ответом. Замер завершается ошибкой, если после прогрева сервер хотя бы раз
+// обратился к operator new:
+//   ./build/bin/allocation_bench
+#include "http_server.h"
+#include "recycling_allocator.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/log/core.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Подсчитываются только выделения потока, в котором работает сервер
+thread_local bool count_allocations = false;
+std::atomic<uint64_t> server_allocations{0};
+
+void* CountedAllocate(std::size_t size, std::size_t alignment) {
+    if(count_allocations) {
+        server_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* pointer = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+        ? std::malloc(size == 0 ? 1 : size)
+        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if(pointer == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return CountedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new[](std::size_t size) {
+    return CountedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+const size_t WARMUP_REQUESTS = 1000;
+
+// Отвечает на любой запрос одним и тем же заранее сериализованным ответом
+struct PreparedRequestHandler {
+    http_server::PreparedResponsePtr response;
+
+    template <typename Request, typename Send>
+    void operator()(Request&& request, Send&& send) const {
+        send(http_server::PreparedResponseRef{response, request.keep_alive()});
+    }
+};
+
+class Server {
+public:
+    Server() {
+        // Журнал форматирует сообщения в куче, в замере он не нужен
+        boost::log::core::get()->set_logging_enabled(false);
+        http::response<http::string_body> response{http::status::ok, 11};
+        response.set(http::field::content_type, "application/json");
+        response.body() = R"({"status":"ok"})";
+        response.prepare_payload();
+
+        // Свободный порт выбирает ядро
+        tcp::endpoint endpoint{net::ip::make_address("127.0.0.1"), 0};
+        {
+            tcp::acceptor probe{ioc_, endpoint};
+            endpoint = probe.local_endpoint();
+        }
+        endpoint_ = endpoint;
+        http_server::ServeHttp(ioc_, endpoint_, http_server::SessionConfig{}, false,
+                               PreparedRequestHandler{http_server::PreparedResponse::Create(std::move(response))});
+        thread_ = std::thread([this] {
+            count_allocations = true;
+            ioc_.run();
+        });
+    }
+
+    ~Server() {
+        ioc_.stop();
+        thread_.join();
+    }
+
+    const tcp::endpoint& GetEndpoint() const noexcept {
+        return endpoint_;
+    }
+
+private:
+    net::io_context ioc_;
+    tcp::endpoint endpoint_;
+    std::thread thread_;
+};
+
+class Client {
+public:
+    explicit Client(const tcp::endpoint& endpoint)
+        : socket_(ioc_) {
+        socket_.connect(endpoint);
+        request_.set(http::field::host, "127.0.0.1");
+        request_.keep_alive(true);
+    }
+
+    void Exchange() {
+        http::write(socket_, request_);
+        http::response<http::string_body> response;
+        http::read(socket_, buffer_, response);
+        benchmark::DoNotOptimize(response.body().data());
+    }
+
+private:
+    net::io_context ioc_;
+    tcp::socket socket_;
+    http::request<http::empty_body> request_{http::verb::get, "/api/v1/maps", 11};
+    beast::flat_buffer buffer_;
+};
+
+void BM_KeepAliveRequest(benchmark::State& state) {
+    static Server server;
+    Client client{server.GetEndpoint()};
+    for(size_t i = 0; i < WARMUP_REQUESTS; ++i) {
+        client.Exchange();
+    }
+    const uint64_t allocations_before = server_allocations.load(std::memory_order_relaxed);
+    const uint64_t pool_misses_before = utils::RecyclingPool::GetHeapAllocationsCount();
+    for(auto _ : state) {
+        client.Exchange();
+    }
+    const uint64_t allocations = server_allocations.load(std::memory_order_relaxed) - allocations_before;
+    const uint64_t pool_misses = utils::RecyclingPool::GetHeapAllocationsCount() - pool_misses_before;
+    state.counters["server_heap_allocations"] = static_cast<double>(allocations);
+    state.counters["pool_heap_allocations"] = static_cast<double>(pool_misses);
+    state.SetItemsProcessed(state.iterations());
+    if(allocations != 0) {
+        state.SkipWithError(("server thread called operator new " + std::to_string(allocations) + " times").c_str());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_KeepAliveRequest)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+// Замер перемещения собак на одном потоке при прежнем и новом хранении состояния.
+// BM_PointerChasingTick воспроизводит прежнюю раскладку: игрок -> shared_ptr на сеанс -> shared_ptr
+// на карту и игрок -> shared_ptr на собаку с виртуальным деструктором, все объекты в куче.
+// BM_DogStoreTick перемещает те же собаки из массивов DogStore. Промахи кэша можно снять
+// счетчиками производительности, если библиотека собрана с libpfm:
+//   ./build/bin/dog_store_bench --benchmark_perf_counters=CYCLES,CACHE-MISSES
+// или через perf: perf stat -e cache-misses ./build/bin/dog_store_bench --benchmark_filter=DogStore
+#include "grid_map.h"
+#include "dog.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+
+const std::chrono::milliseconds TICK_PERIOD = 50ms;
+
+struct HeapDog {
+    virtual ~HeapDog() = default;
+    std::string name;
+    model::Direction direction;
+    model::Position position;
+    model::Velocity velocity;
+};
+
+struct HeapSession {
+    std::shared_ptr<model::Map> map;
+};
+
+struct HeapPlayer {
+    std::string name;
+    std::shared_ptr<HeapSession> session;
+    std::shared_ptr<HeapDog> dog;
+};
+
+model::Velocity MakeVelocity(model::Direction direction, double velocity) {
+    switch(direction) {
+        case model::Direction::NORTH:
+            return {0, -velocity};
+        case model::Direction::SOUTH:
+            return {0, velocity};
+        case model::Direction::WEST:
+            return {-velocity, 0};
+        case model::Direction::EAST:
+            return {velocity, 0};
+        default:
+            return {0, 0};
+    }
+}
+
+/*Игроки создаются вперемешку с другими выделениями и перемешиваются, как после долгой работы
+сервера, чтобы собаки не оказались в куче подряд*/
+std::vector< std::shared_ptr<HeapPlayer> > MakeHeapPlayers(size_t count) {
+    auto session = std::make_shared<HeapSession>(
+        HeapSession{std::make_shared<model::Map>(bench_utils::MakeGridMap())});
+    const double velocity = session->map->GetDogVelocity();
+    std::vector< std::shared_ptr<HeapPlayer> > players;
+    std::vector< std::unique_ptr<std::string> > garbage;
+    players.reserve(count);
+    bench_utils::PlaceDogs(count, [&](const bench_utils::DogPlacement& placement) {
+        auto dog = std::make_shared<HeapDog>();
+        dog->name = "bench"s;
+        dog->direction = placement.direction;
+        dog->position = placement.position;
+        dog->velocity = MakeVelocity(placement.direction, velocity);
+        garbage.push_back(std::make_unique<std::string>(64, 'x'));
+        players.push_back(std::make_shared<HeapPlayer>(HeapPlayer{"bench"s, session, dog}));
+    });
+    std::shuffle(players.begin(), players.end(), std::mt19937{static_cast<unsigned>(count)});
+    return players;
+}
+
+void BM_PointerChasingTick(benchmark::State& state) {
+    auto players = MakeHeapPlayers(static_cast<size_t>(state.range(0)));
+    const double seconds = TICK_PERIOD.count() / model::MILLISECONDS_IN_SECOND;
+    for(auto _ : state) {
+        for(const auto& player : players) {
+            auto& dog = *player->dog;
+            if(dog.velocity.vx == 0 && dog.velocity.vy == 0) {
+                continue;
+            }
+            model::Position target{dog.position.x + dog.velocity.vx * seconds,
+                                   dog.position.y + dog.velocity.vy * seconds};
+            auto [position, velocity] = player->session->map->GetValidMove(dog.position, target, dog.velocity);
+            dog.position = position;
+            dog.velocity = velocity;
+        }
+    }
+    state.counters["dogs"] = benchmark::Counter(static_cast<double>(state.iterations() * players.size()),
+                                                benchmark::Counter::kIsRate);
+}
+
+void BM_DogStoreTick(benchmark::State& state) {
+    const auto dogs_count = static_cast<size_t>(state.range(0));
+    const auto& map = bench_utils::GetGridMap();
+    model::DogStore dogs;
+    bench_utils::PlaceDogs(dogs_count, [&dogs, &map](const bench_utils::DogPlacement& placement) {
+        model::Dog dog{dogs, dogs.Add("bench"s)};
+        dog.SetPosition(placement.position);
+        dog.SetAction(placement.direction, map.GetDogVelocity());
+    });
+    for(auto _ : state) {
+        dogs.Move(map, TICK_PERIOD, 0, dogs.Size());
+    }
+    state.counters["dogs"] = benchmark::Counter(static_cast<double>(state.iterations() * dogs_count),
+                                                benchmark::Counter::kIsRate);
+}
+
+}
+
+BENCHMARK(BM_PointerChasingTick)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DogStoreTick)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,53 @@
+#pragma once
+// Общие для замеров синтетическая карта и расстановка собак
+#include "map.h"
+
+#include <random>
+#include <string>
+
+namespace bench_utils {
+
+const int GRID_SIZE = 20;
+const int GRID_STEP = 10;
+const double GRID_DOG_VELOCITY = 3.0;
+const model::Direction MOVE_DIRECTIONS[] = {model::Direction::NORTH, model::Direction::SOUTH,
+                                            model::Direction::WEST, model::Direction::EAST};
+
+// Сетка из GRID_SIZE + 1 горизонтальных и вертикальных дорог с шагом GRID_STEP
+inline model::Map MakeGridMap() {
+    model::Map map{model::Map::Id{"bench"}, "bench"};
+    const int grid_end = GRID_SIZE * GRID_STEP;
+    for(int i = 0; i <= GRID_SIZE; ++i) {
+        map.AddRoad(model::Road{model::Road::HORIZONTAL, {0, i * GRID_STEP}, grid_end});
+        map.AddRoad(model::Road{model::Road::VERTICAL, {i * GRID_STEP, 0}, grid_end});
+    }
+    map.BuildIndex();
+    map.SetDogVelocity(GRID_DOG_VELOCITY);
+    return map;
+}
+
+inline const model::Map& GetGridMap() {
+    static const model::Map map = MakeGridMap();
+    return map;
+}
+
+struct DogPlacement {
+    model::Position position;
+    model::Direction direction;
+};
+
+/*Собаки стоят на перекрестках сетки и бегут в случайных направлениях. Генератор заводится
+числом собак, поэтому расстановка одинакова между запусками*/
+template <typename Fn>
+void PlaceDogs(size_t count, Fn&& fn) {
+    std::mt19937 generator(static_cast<unsigned>(count));
+    std::uniform_int_distribution<int> node_dist(0, GRID_SIZE);
+    std::uniform_int_distribution<size_t> direction_dist(0, std::size(MOVE_DIRECTIONS) - 1);
+    for(size_t i = 0; i < count; ++i) {
+        model::Position position{static_cast<double>(node_dist(generator) * GRID_STEP),
+                                 static_cast<double>(node_dist(generator) * GRID_STEP)};
+        fn(DogPlacement{position, MOVE_DIRECTIONS[direction_dist(generator)]});
+    }
+}
+
+}
@@ -0,0 +1,89 @@
+# Сравнение режимов работы сервера: общий io_context и io_context на поток (SO_REUSEPORT).
+# Пример запуска из каталога решения:
+#   python3 bench/io_mode_bench.py ./build/bin/game_server --config-file data/config.json --www-root static
+import argparse
+import http.client
+import multiprocessing
+import subprocess
+import threading
+import time
+
+HOST = '127.0.0.1'
+PORT = 8080
+AMMUNITION = [
+    '/api/v1/maps',
+    '/api/v1/maps/map1'
+]
+THREADS = [1, 4, 16]
+MODES = {
+    'shared': [],
+    'per-thread': ['--io-context-per-thread']
+}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('server', type=str)
+    parser.add_argument('--config-file', type=str, required=True)
+    parser.add_argument('--www-root', type=str, required=True)
+    parser.add_argument('--clients', type=int, default=32)
+    parser.add_argument('--duration', type=float, default=10.0)
+    parser.add_argument('--pin-threads', action='store_true')
+    return parser.parse_args()
+
+
+def start_server(args, mode, threads):
+    command = [args.server, '--config-file', args.config_file, '--www-root', args.www_root,
+               '--threads', str(threads)] + MODES[mode]
+    if args.pin_threads:
+        command.append('--pin-threads')
+    process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+    for line in process.stdout:
+        if 'Server has started' in line:
+            break
+    # Дочитываем журнал сервера в фоне, чтобы его вывод не заполнил канал
+    threading.Thread(target=process.stdout.read, daemon=True).start()
+    return process
+
+
+def shoot(duration, result):
+    # Каждый клиент использует одно постоянное соединение
+    connection = http.client.HTTPConnection(HOST, PORT)
+    deadline = time.monotonic() + duration
+    count = 0
+    while time.monotonic() < deadline:
+        connection.request('GET', AMMUNITION[count % len(AMMUNITION)])
+        connection.getresponse().read()
+        count += 1
+    connection.close()
+    result.put(count)
+
+
+def measure(args):
+    result = multiprocessing.Queue()
+    clients = [multiprocessing.Process(target=shoot, args=(args.duration, result)) for _ in range(args.clients)]
+    for client in clients:
+        client.start()
+    total = sum(result.get() for _ in clients)
+    for client in clients:
+        client.join()
+    return total / args.duration
+
+
+def main():
+    args = parse_args()
+    print(f'{"mode":>12} {"threads":>8} {"rps":>12}')
+    for threads in THREADS:
+        for mode in MODES:
+            server = start_server(args, mode, threads)
+            try:
+                rps = measure(args)
+            finally:
+                server.terminate()
+                server.wait()
+            print(f'{mode:>12} {threads:>8} {rps:>12.0f}')
+            time.sleep(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,274 @@
+#pragma once
+/*Прежний способ выбора обработчика API для сравнения в замерах: список узлов перебирается
+по порядку, активатор каждого узла заново разбивает путь запроса на сегменты или сравнивает
+его со строками, а активаторы запросов с телом заново разбирают JSON. Обработчики общие
+с ApiV1Router, поэтому для выбранного узла RequestContext строится еще раз - разница
+в замерах приходится только на выбор обработчика и повторный разбор запроса.*/
+#include "api_v1_request_handlers_storage.h"
+#include "request_handler_node.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace bench_utils {
+
+namespace http = boost::beast::http;
+
+const size_t SIZE_OF_TWO_SEGMENT_URL = 2;
+const size_t SIZE_OF_THREE_SEGMENT_URL = 3;
+const size_t SIZE_OF_FOUR_SEGMENT_URL = 4;
+const size_t SIZE_OF_FIVE_SEGMENT_URL = 5;
+
+const std::unordered_set<std::string> GAME_API_URLS_WITH_AUTHORIZATION = {
+    api_urls::GET_PLAYERS_LIST_API,
+    api_urls::GET_PLAYERS_LIST_API + "/",
+    api_urls::GET_GAME_STATE_API,
+    api_urls::GET_GAME_STATE_API + "/",
+    api_urls::MAKE_ACTION_API,
+    api_urls::MAKE_ACTION_API + "/"
+};
+
+const std::unordered_set<std::string> GAME_API_URLS_WITH_JSON_REQ = {
+    api_urls::JOIN_TO_GAME_API,
+    api_urls::JOIN_TO_GAME_API + "/",
+    api_urls::MAKE_ACTION_API,
+    api_urls::MAKE_ACTION_API + "/"
+};
+
+inline std::vector<std::string_view> SplitUrl(std::string_view str) {
+    std::vector<std::string_view> result;
+    std::string delim = "/";
+    if(str.empty() or str == delim) return result;
+    auto start = 1U; // Ignore first slash
+    auto end = str.find(delim, start);
+    while (end != std::string::npos) {
+        result.push_back(str.substr(start, end - start));
+        start = end + delim.length();
+        end = str.find(delim, start);
+    }
+    result.push_back(str.substr(start, end));
+    return result;
+}
+
+template <typename Request>
+bool BadRequestActivator(const Request& req) {
+    auto url = SplitUrl(req.target());
+    return !url.empty() &&
+            url[0] == "api" &&
+            (
+                url.size() > SIZE_OF_FIVE_SEGMENT_URL ||
+                url.size() < SIZE_OF_THREE_SEGMENT_URL ||
+                (url.size() >= SIZE_OF_TWO_SEGMENT_URL &&
+                    url[1] != "v1") ||
+                (url.size() >= SIZE_OF_THREE_SEGMENT_URL &&
+                    url[2] != "maps" &&
+                    url[2] != "game" &&
+                    url[3] != "join" &&
+                    url[3] != "players" &&
+                    url[3] != "state" &&
+                    url[3] != "player" &&
+                    url[3] != "tick" &&
+                    (url.size() == SIZE_OF_FIVE_SEGMENT_URL && url[4] != "action"))
+            );
+}
+
+template <typename Request>
+bool GetMapListActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::GET_MAPS_LIST_API, req.target());
+}
+
+template <typename Request>
+bool GetMapByIdActivator(const Request& req) {
+    auto url = SplitUrl(req.target());
+    return url.size() == SIZE_OF_FOUR_SEGMENT_URL &&
+            url[0] == "api" &&
+            url[1] == "v1" &&
+            url[2] == "maps";
+}
+
+template <typename Request>
+bool InvalidContentTypeActivator(const Request& req) {
+    return (GAME_API_URLS_WITH_JSON_REQ.count(std::string(req.target())) > 0) &&
+            (req[http::field::content_type].empty() ||
+            req[http::field::content_type] != rh_storage::CONTENT_TYPE_APPLICATION_JSON);
+}
+
+template <typename Request>
+bool JoinToGameInvalidJsonReqActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::JOIN_TO_GAME_API, req.target()) &&
+        !json_converter::ParseJoinToGameRequest(req.body());
+}
+
+template <typename Request>
+bool JoinToGameEmptyPlayerNameActivator(const Request& req) {
+    if(rh_storage::IsEqualUrls(api_urls::JOIN_TO_GAME_API, req.target())) {
+        auto res = json_converter::ParseJoinToGameRequest(req.body());
+        if(!res) {
+            return false;
+        }
+        auto [player_name, map_id] = res.value();
+        return player_name.empty();
+    }
+    return false;
+}
+
+template <typename Request>
+bool JoinToGameActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::JOIN_TO_GAME_API, req.target());
+}
+
+template <typename Request>
+bool EmptyAuthorizationActivator(const Request& req) {
+    return (GAME_API_URLS_WITH_AUTHORIZATION.count(std::string(req.target())) > 0) &&
+            (req[http::field::authorization].empty() ||
+            rh_storage::GetTokenString(req[http::field::authorization]).empty());
+}
+
+template <typename Request>
+bool GetPlayersListActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::GET_PLAYERS_LIST_API, req.target());
+}
+
+template <typename Request>
+bool GetGameStateActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::GET_GAME_STATE_API, req.target());
+}
+
+template <typename Request>
+bool PlayerActionInvalidActionActivator(const Request& req) {
+    if(rh_storage::IsEqualUrls(api_urls::MAKE_ACTION_API, req.target())) {
+        auto res = json_converter::ParsePlayerActionRequest(req.body());
+        if(res.has_value()) {
+            return !model::STRING_TO_DIRECTION.contains(res.value());
+        }
+    }
+    return false;
+}
+
+template <typename Request>
+bool PlayerActionActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::MAKE_ACTION_API, req.target());
+}
+
+template <typename Request>
+bool TimeTickInvalidMsgActivator(const Request& req) {
+    if(rh_storage::IsEqualUrls(api_urls::MAKE_TIME_TICK_API, req.target())) {
+        auto res = json_converter::ParseSetDeltaTimeRequest(req.body());
+        return !res.has_value();
+    }
+    return false;
+}
+
+template <typename Request>
+bool TimeTickActivator(const Request& req) {
+    return rh_storage::IsEqualUrls(api_urls::MAKE_TIME_TICK_API, req.target());
+}
+
+template<typename Request, typename Send>
+class LegacyApiV1Executor {
+    using ActivatorType = bool(*)(const Request&);
+    using HandlerType = std::optional<size_t>(*)(const Request&, const rh_storage::RequestContext&,
+                                                 app::Application&, Send&&);
+    using Node = rh_storage::RequestHandlerNode<ActivatorType, HandlerType>;
+
+    struct Entry {
+        Node node;
+        rh_storage::RequestBodyType body_type;
+    };
+public:
+    LegacyApiV1Executor(const LegacyApiV1Executor&) = delete;
+    LegacyApiV1Executor& operator=(const LegacyApiV1Executor&) = delete;
+
+    static LegacyApiV1Executor& GetInstance() {
+        static LegacyApiV1Executor obj;
+        return obj;
+    }
+
+    bool Execute(const Request& req, app::Application& application, Send&& send) {
+        for(auto item : storage_) {
+            if(item.node.GetActivator()(req)) {
+                auto context = rh_storage::MakeRequestContext(req.target(), req[http::field::authorization],
+                                                              req.body(), item.body_type);
+                auto res = item.node.GetHandler(req.method())(req, context, application, std::forward<Send>(send));
+                while(res.has_value()) {
+                    res = item.node.GetEmergeHandlerByIndex(res.value())(req, context, application, std::forward<Send>(send));
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    using BodyType = rh_storage::RequestBodyType;
+
+    std::vector<Entry> storage_ = {
+        {Node(BadRequestActivator,
+                {{http::verb::get, rh_storage::BadRequestHandler}},
+                rh_storage::BadRequestHandler), BodyType::NONE},
+
+        {Node(GetMapListActivator,
+                {{http::verb::get, rh_storage::GetMapListHandler}},
+                rh_storage::BadRequestHandler), BodyType::NONE},
+
+        {Node(GetMapByIdActivator,
+                {{http::verb::get, rh_storage::GetMapByIdHandler}},
+                rh_storage::BadRequestHandler,
+                {rh_storage::MapNotFoundHandler}), BodyType::NONE},
+
+        {Node(InvalidContentTypeActivator,
+                {{http::verb::post, rh_storage::InvalidContentTypeHandler}},
+                rh_storage::InvalidContentTypeHandler), BodyType::NONE},
+
+        {Node(JoinToGameInvalidJsonReqActivator,
+                {{http::verb::post, rh_storage::JoinToGameInvalidJsonReqHandler}},
+                rh_storage::OnlyPostMethodAllowedHandler), BodyType::JOIN_TO_GAME},
+        {Node(JoinToGameEmptyPlayerNameActivator,
+                {{http::verb::post, rh_storage::JoinToGameEmptyPlayerNameHandler}},
+                rh_storage::OnlyPostMethodAllowedHandler), BodyType::JOIN_TO_GAME},
+        {Node(JoinToGameActivator,
+                {{http::verb::post, rh_storage::JoinToGameHandler}},
+                rh_storage::OnlyPostMethodAllowedHandler,
+                {rh_storage::JoinToGameMapNotFoundHandler}), BodyType::JOIN_TO_GAME},
+
+        {Node(EmptyAuthorizationActivator,
+                {{http::verb::get, rh_storage::EmptyAuthorizationHandler},
+                {http::verb::head, rh_storage::EmptyAuthorizationHandler}},
+                rh_storage::InvalidMethodHandler), BodyType::NONE},
+
+        {Node(GetPlayersListActivator,
+                {{http::verb::get, rh_storage::GetPlayersListHandler},
+                {http::verb::head, rh_storage::GetPlayersListHandler}},
+                rh_storage::InvalidMethodHandler,
+                {rh_storage::UnknownTokenHandler}), BodyType::NONE},
+        {Node(GetGameStateActivator,
+                {{http::verb::get, rh_storage::GetGameStateHandler},
+                {http::verb::head, rh_storage::GetGameStateHandler}},
+                rh_storage::InvalidMethodHandler,
+                {rh_storage::UnknownTokenHandler}), BodyType::NONE},
+
+        {Node(PlayerActionInvalidActionActivator,
+                {{http::verb::post, rh_storage::PlayerActionInvalidActionHandler}},
+                rh_storage::OnlyPostMethodAllowedHandler), BodyType::PLAYER_ACTION},
+        {Node(PlayerActionActivator,
+                {{http::verb::post, rh_storage::PlayerActionHandler}},
+                rh_storage::InvalidMethodHandler,
+                {rh_storage::UnknownTokenHandler}), BodyType::PLAYER_ACTION},
+
+        {Node(TimeTickInvalidMsgActivator,
+                {{http::verb::post, rh_storage::TimeTickInvalidMsgHandler}},
+                rh_storage::InvalidMethodHandler,
+                {rh_storage::InvalidEndpointHandler}), BodyType::SET_DELTA_TIME},
+        {Node(TimeTickActivator,
+                {{http::verb::post, rh_storage::TimeTickHandler}},
+                rh_storage::InvalidMethodHandler,
+                {rh_storage::InvalidEndpointHandler}), BodyType::SET_DELTA_TIME}
+    };
+
+    LegacyApiV1Executor() = default;
+};
+
+}  // namespace bench_utils
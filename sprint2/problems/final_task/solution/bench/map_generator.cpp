@@ -0,0 +1,61 @@
+// Записывает конфигурацию игры с синтетическими картами заданного размера, по карте на каждую раскладку:
+//   ./build/bin/map_generator --roads 10000 --output maps_10000.json
+//   ./build/bin/map_generator --roads 100000 --layout highways --output highways.json
+// Цель generate_maps собирает конфигурации на 10^2-10^5 дорог в каталоге сборки.
+#include "map_generator.h"
+
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, const char* argv[]) {
+    namespace po = boost::program_options;
+    using namespace std::literals;
+
+    size_t roads_count = 1000;
+    std::vector<std::string> layouts;
+    std::string output;
+    unsigned seed = 1;
+
+    po::options_description desc{"All options"s};
+    desc.add_options()
+        ("help,h", "produce help message")
+        ("roads", po::value(&roads_count)->value_name("count"s), "set number of roads in each map")
+        ("layout", po::value(&layouts)->value_name("grid|highways|random"s),
+            "add map with this layout, may be repeated (default - all layouts)")
+        ("seed", po::value(&seed)->value_name("number"s), "set random generator seed")
+        ("output,o", po::value(&output)->value_name("file"s)->required(), "set config file path");
+    try {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if(vm.contains("help"s)) {
+            std::cout << desc;
+            return EXIT_SUCCESS;
+        }
+        po::notify(vm);
+
+        std::vector<model::Map> maps;
+        if(layouts.empty()) {
+            for(auto layout : bench_utils::MAP_LAYOUTS) {
+                maps.push_back(bench_utils::GenerateMap(layout, roads_count, seed));
+            }
+        } else {
+            for(const auto& name : layouts) {
+                maps.push_back(bench_utils::GenerateMap(bench_utils::ParseLayout(name), roads_count, seed));
+            }
+        }
+        std::ofstream file(output);
+        file << boost::json::serialize(bench_utils::MakeConfig(maps));
+        if(!file) {
+            std::cerr << "Can't write "s << output << std::endl;
+            return EXIT_FAILURE;
+        }
+    } catch(const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+#pragma once
+/*Генератор больших синтетических карт для замеров масштабирования модели. Все координаты
+неотрицательные, дороги пересекаются только в целых точках, как в конфигурациях игры.
+Одинаковые параметры дают одинаковую карту.*/
+#include "map.h"
+#include "model_key_storage.h"
+
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench_utils {
+
+enum class MapLayout {
+    // Городская сетка: улицы во всю ширину города с шагом в квартал
+    GRID,
+    // Магистрали: длинные параллельные линии, каждая из нескольких участков, и съезды между ними
+    HIGHWAYS,
+    // Случайные перекрестки: каждая новая дорога начинается в точке уже построенной
+    RANDOM_JUNCTIONS
+};
+
+const std::array<MapLayout, 3> MAP_LAYOUTS{MapLayout::GRID, MapLayout::HIGHWAYS, MapLayout::RANDOM_JUNCTIONS};
+
+inline std::string_view GetLayoutName(MapLayout layout) {
+    switch(layout) {
+        case MapLayout::GRID:
+            return "grid";
+        case MapLayout::HIGHWAYS:
+            return "highways";
+        default:
+            return "random";
+    }
+}
+
+inline MapLayout ParseLayout(std::string_view name) {
+    for(auto layout : MAP_LAYOUTS) {
+        if(GetLayoutName(layout) == name) {
+            return layout;
+        }
+    }
+    throw std::invalid_argument("Unknown map layout: " + std::string(name));
+}
+
+namespace detail {
+
+const int BLOCK_SIZE = 10;
+const int HIGHWAY_STEP = 20;
+const int HIGHWAY_SEGMENT = 200;
+const int MAX_JUNCTION_ROAD = 50;
+
+inline void AddGridRoads(std::vector<model::Road>& roads, size_t roads_count) {
+    const int streets = static_cast<int>((roads_count + 1) / 2);
+    const int city_size = std::max(streets - 1, 1) * BLOCK_SIZE;
+    for(int i = 0; roads.size() < roads_count; ++i) {
+        roads.emplace_back(model::Road::HORIZONTAL, model::Point{0, i * BLOCK_SIZE}, city_size);
+        if(roads.size() < roads_count) {
+            roads.emplace_back(model::Road::VERTICAL, model::Point{i * BLOCK_SIZE, 0}, city_size);
+        }
+    }
+}
+
+// Участки магистрали стыкуются концами, после каждого десятого участка съезд ведет на соседнюю магистраль
+inline void AddHighwayRoads(std::vector<model::Road>& roads, size_t roads_count, std::mt19937& generator) {
+    const int highways = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(roads_count) / 10)));
+    std::uniform_int_distribution<int> ramp_dist(0, HIGHWAY_SEGMENT / BLOCK_SIZE);
+    for(int segment = 0; roads.size() < roads_count; ++segment) {
+        const int x = segment * HIGHWAY_SEGMENT;
+        for(int highway = 0; highway < highways && roads.size() < roads_count; ++highway) {
+            const int y = highway * HIGHWAY_STEP;
+            roads.emplace_back(model::Road::HORIZONTAL, model::Point{x, y}, x + HIGHWAY_SEGMENT);
+            if(segment % 10 == 9 && highway + 1 < highways && roads.size() < roads_count) {
+                const int ramp_x = x + ramp_dist(generator) * BLOCK_SIZE;
+                roads.emplace_back(model::Road::VERTICAL, model::Point{ramp_x, y}, y + HIGHWAY_STEP);
+            }
+        }
+    }
+}
+
+inline void AddRandomJunctionRoads(std::vector<model::Road>& roads, size_t roads_count, std::mt19937& generator) {
+    std::uniform_int_distribution<int> length_dist(1, MAX_JUNCTION_ROAD);
+    std::uniform_real_distribution<double> along_dist(0.0, 1.0);
+    roads.emplace_back(model::Road::HORIZONTAL, model::Point{0, 0}, MAX_JUNCTION_ROAD);
+    while(roads.size() < roads_count) {
+        // Перекресток - целая точка на случайной построенной дороге
+        const auto& base = roads[generator() % roads.size()];
+        const auto along = along_dist(generator);
+        const model::Point junction{
+            base.GetStart().x + static_cast<int>(std::lround(along * (base.GetEnd().x - base.GetStart().x))),
+            base.GetStart().y + static_cast<int>(std::lround(along * (base.GetEnd().y - base.GetStart().y)))};
+        const int length = length_dist(generator) * ((generator() % 2) ? 1 : -1);
+        if(generator() % 2) {
+            roads.emplace_back(model::Road::HORIZONTAL, junction, std::max(junction.x + length, 0));
+        } else {
+            roads.emplace_back(model::Road::VERTICAL, junction, std::max(junction.y + length, 0));
+        }
+    }
+}
+
+}  // namespace detail
+
+inline std::vector<model::Road> GenerateRoads(MapLayout layout, size_t roads_count, unsigned seed) {
+    std::vector<model::Road> roads;
+    roads.reserve(roads_count);
+    std::mt19937 generator(seed);
+    switch(layout) {
+        case MapLayout::GRID:
+            detail::AddGridRoads(roads, roads_count);
+            break;
+        case MapLayout::HIGHWAYS:
+            detail::AddHighwayRoads(roads, roads_count, generator);
+            break;
+        case MapLayout::RANDOM_JUNCTIONS:
+            detail::AddRandomJunctionRoads(roads, roads_count, generator);
+            break;
+    }
+    return roads;
+}
+
+// Карта с дорогами, зданием и офисами на концах первых дорог
+inline model::Map GenerateMap(MapLayout layout, size_t roads_count, unsigned seed) {
+    const std::string id = std::string(GetLayoutName(layout)) + "_" + std::to_string(roads_count);
+    model::Map map{model::Map::Id{id}, id};
+    map.AddRoads(GenerateRoads(layout, roads_count, seed));
+    const auto& roads = map.GetRoads();
+    for(size_t i = 0; i < std::min<size_t>(roads.size(), 10); ++i) {
+        map.AddOffice(model::Office{model::Office::Id{"o" + std::to_string(i)}, roads[i].GetEnd(), {5, 0}});
+    }
+    map.AddBuilding(model::Building{{{1, 1}, {8, 8}}});
+    map.SetDogVelocity(3.0);
+    return map;
+}
+
+// Конфигурация игры в формате data/config.json
+inline boost::json::value MakeConfig(const std::vector<model::Map>& maps) {
+    boost::json::array json_maps;
+    for(const auto& map : maps) {
+        auto json_map = boost::json::value_from(map);
+        json_map.as_object()[model::MAP_DOG_VELOCITY] = map.GetDogVelocity();
+        json_maps.push_back(std::move(json_map));
+    }
+    return boost::json::object{{model::DEFAULT_DOG_VELOCITY, 3.0}, {model::MAPS, std::move(json_maps)}};
+}
+
+}  // namespace bench_utils
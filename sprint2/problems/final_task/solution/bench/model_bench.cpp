@@ -0,0 +1,298 @@
+// Замеры масштабирования модели на синтетических картах из map_generator.h (10^2-10^5 дорог):
+// построение индекса дорог, перемещение собаки, копирование и перемещение карты, выбор точек
+// появления, загрузка игры из JSON и из артефакта карт. Счетчик rss_delta_mb - прирост резидентной
+// памяти процесса (/proc/self/statm) от начала замера до момента, когда объекты итерации еще живы.
+// Перед начальным замером свободная память кучи возвращается системе, поэтому память, оставшаяся
+// от предыдущих замеров, не скрывает прирост текущего. Запуск:
+//   ./build/bin/model_bench --benchmark_counters_tabular=true
+#include "map_generator.h"
+#include "json_loader.h"
+#include "map_artifact.h"
+
+#include <benchmark/benchmark.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace std::literals;
+
+const unsigned GENERATOR_SEED = 1;
+const size_t MOVES_COUNT = 4096;
+const double MAX_MOVE_TIME = 1.0;
+
+const double BYTES_IN_MB = 1024.0 * 1024.0;
+
+// Резидентная память процесса: второе поле /proc/self/statm в страницах
+size_t ReadRssBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    statm >> total_pages >> resident_pages;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/*Прирост резидентной памяти за замер. Создается после подготовки данных замера, Sample вызывается
+в итерации, пока ее объекты живы. RSS читается только в первой итерации: остальные выделяют
+столько же, а чтение файла не должно попадать в измеряемое время*/
+class RssMeter {
+public:
+    RssMeter() {
+        malloc_trim(0);
+        before_ = ReadRssBytes();
+        peak_ = before_;
+    }
+
+    void Sample(benchmark::State& state) {
+        if(sampled_) {
+            return;
+        }
+        state.PauseTiming();
+        peak_ = std::max(peak_, ReadRssBytes());
+        sampled_ = true;
+        state.ResumeTiming();
+    }
+
+    void Report(benchmark::State& state) {
+        peak_ = std::max(peak_, ReadRssBytes());
+        state.counters["rss_delta_mb"] = static_cast<double>(peak_ - before_) / BYTES_IN_MB;
+    }
+
+private:
+    size_t before_ = 0;
+    size_t peak_ = 0;
+    bool sampled_ = false;
+};
+
+bench_utils::MapLayout GetLayout(benchmark::State& state) {
+    const auto layout = bench_utils::MAP_LAYOUTS.at(static_cast<size_t>(state.range(0)));
+    state.SetLabel(std::string(bench_utils::GetLayoutName(layout)));
+    return layout;
+}
+
+// Карты строятся один раз на раскладку и размер и переиспользуются замерами
+const model::Map& GetMap(bench_utils::MapLayout layout, size_t roads_count) {
+    static std::map<std::pair<bench_utils::MapLayout, size_t>, model::Map> maps;
+    auto it = maps.find({layout, roads_count});
+    if(it == maps.end()) {
+        it = maps.emplace(std::pair{layout, roads_count},
+                          bench_utils::GenerateMap(layout, roads_count, GENERATOR_SEED)).first;
+    }
+    return it->second;
+}
+
+struct Move {
+    model::Position position;
+    model::Position target;
+    model::Velocity velocity;
+};
+
+// Собаки стоят в случайных точках дорог и бегут вдоль или поперек дороги не дольше MAX_MOVE_TIME
+std::vector<Move> MakeMoves(const model::Map& map) {
+    std::mt19937 generator(GENERATOR_SEED);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+    const auto& roads = map.GetRoads();
+    const double speed = map.GetDogVelocity();
+    const model::Velocity velocities[] = {{speed, 0}, {-speed, 0}, {0, speed}, {0, -speed}};
+    std::vector<Move> moves;
+    moves.reserve(MOVES_COUNT);
+    while(moves.size() < MOVES_COUNT) {
+        const auto& road = roads[generator() % roads.size()];
+        const double along = unit_dist(generator);
+        const model::Position position{road.GetStart().x + along * (road.GetEnd().x - road.GetStart().x),
+                                       road.GetStart().y + along * (road.GetEnd().y - road.GetStart().y)};
+        const auto velocity = velocities[generator() % std::size(velocities)];
+        const double dt = unit_dist(generator) * MAX_MOVE_TIME;
+        moves.push_back({position, {position.x + velocity.vx * dt, position.y + velocity.vy * dt}, velocity});
+    }
+    return moves;
+}
+
+void BM_RoadmapAddRoad(benchmark::State& state) {
+    const auto layout = GetLayout(state);
+    const auto roads = bench_utils::GenerateRoads(layout, static_cast<size_t>(state.range(1)), GENERATOR_SEED);
+    RssMeter rss;
+    for(auto _ : state) {
+        model::Roadmap roadmap;
+        for(const auto& road : roads) {
+            roadmap.AddRoad(road);
+        }
+        roadmap.BuildIndex();
+        benchmark::DoNotOptimize(roadmap);
+        rss.Sample(state);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(roads.size()));
+    rss.Report(state);
+}
+
+void BM_RoadmapGetValidMove(benchmark::State& state) {
+    const auto& map = GetMap(GetLayout(state), static_cast<size_t>(state.range(1)));
+    const auto moves = MakeMoves(map);
+    RssMeter rss;
+    size_t index = 0;
+    for(auto _ : state) {
+        const auto& move = moves[index];
+        benchmark::DoNotOptimize(map.GetValidMove(move.position, move.target, move.velocity));
+        index = (index + 1) % moves.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    rss.Report(state);
+}
+
+void BM_MapCopy(benchmark::State& state) {
+    const auto& map = GetMap(GetLayout(state), static_cast<size_t>(state.range(1)));
+    RssMeter rss;
+    for(auto _ : state) {
+        model::Map copy = map;
+        benchmark::DoNotOptimize(copy);
+        rss.Sample(state);
+    }
+    rss.Report(state);
+}
+
+// Карта перемещается туда и обратно, чтобы не копировать ее на каждой итерации
+void BM_MapMove(benchmark::State& state) {
+    model::Map source = GetMap(GetLayout(state), static_cast<size_t>(state.range(1)));
+    RssMeter rss;
+    for(auto _ : state) {
+        model::Map moved = std::move(source);
+        benchmark::DoNotOptimize(moved);
+        source = std::move(moved);
+    }
+    rss.Report(state);
+}
+
+void BM_SpawnSamplerBuild(benchmark::State& state) {
+    const auto& map = GetMap(GetLayout(state), static_cast<size_t>(state.range(1)));
+    RssMeter rss;
+    for(auto _ : state) {
+        model::SpawnSampler sampler(map.GetRoads());
+        benchmark::DoNotOptimize(sampler);
+        rss.Sample(state);
+    }
+    rss.Report(state);
+}
+
+// Прежний выбор точки появления: копия списка дорог и равновероятный выбор дороги без учета длины
+void BM_LegacySpawnPosition(benchmark::State& state) {
+    const auto& map = GetMap(GetLayout(state), static_cast<size_t>(state.range(1)));
+    std::mt19937_64 generator(GENERATOR_SEED);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+    for(auto _ : state) {
+        auto roads = map.GetRoads();
+        const auto& road = roads[std::uniform_int_distribution<size_t>(0, roads.size() - 1)(generator)];
+        const double along = unit_dist(generator);
+        benchmark::DoNotOptimize(model::Position{road.GetStart().x + along * (road.GetEnd().x - road.GetStart().x),
+                                                 road.GetStart().y + along * (road.GetEnd().y - road.GetStart().y)});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_SpawnPosition(benchmark::State& state) {
+    const auto& sampler = GetMap(GetLayout(state), static_cast<size_t>(state.range(1))).GetSpawnSampler();
+    std::mt19937_64 generator(GENERATOR_SEED);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+    for(auto _ : state) {
+        const double road_pick = unit_dist(generator);
+        benchmark::DoNotOptimize(sampler.GetPosition(road_pick, unit_dist(generator)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Пачка точек появления на тик, как для трофеев всего сеанса
+void BM_SpawnPositionsBatch(benchmark::State& state) {
+    const auto& sampler = GetMap(bench_utils::MapLayout::RANDOM_JUNCTIONS, 10000).GetSpawnSampler();
+    const auto batch_size = static_cast<size_t>(state.range(0));
+    std::mt19937_64 generator(GENERATOR_SEED);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+    std::vector<model::Position> positions;
+    for(auto _ : state) {
+        positions.clear();
+        sampler.GetPositions(batch_size, [&] { return unit_dist(generator); }, positions);
+        benchmark::DoNotOptimize(positions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch_size));
+}
+
+/*Конфигурация из карт всех раскладок заданного размера и собранный из нее артефакт карт. Файлы
+пишутся во временный каталог один раз на размер*/
+std::pair<fs::path, fs::path> GetConfigFiles(size_t roads_count) {
+    const fs::path dir = fs::temp_directory_path() / "game_server_model_bench"s;
+    const fs::path config = dir / ("config_"s + std::to_string(roads_count) + ".json"s);
+    const fs::path artifact = dir / ("maps_"s + std::to_string(roads_count) + ".bin"s);
+    static std::map<size_t, bool> written;
+    if(!written[roads_count]) {
+        fs::create_directories(dir);
+        std::vector<model::Map> maps;
+        for(auto layout : bench_utils::MAP_LAYOUTS) {
+            maps.push_back(GetMap(layout, roads_count));
+        }
+        std::ofstream(config) << boost::json::serialize(bench_utils::MakeConfig(maps));
+        map_artifact::SaveGame(json_loader::LoadGame(config), map_artifact::HashConfigFile(config), artifact);
+        written[roads_count] = true;
+    }
+    return {config, artifact};
+}
+
+void BM_LoadGameJson(benchmark::State& state) {
+    const auto [config, artifact] = GetConfigFiles(static_cast<size_t>(state.range(0)));
+    RssMeter rss;
+    for(auto _ : state) {
+        auto game = json_loader::LoadGame(config);
+        benchmark::DoNotOptimize(game);
+        rss.Sample(state);
+    }
+    state.counters["file_mb"] = static_cast<double>(fs::file_size(config)) / BYTES_IN_MB;
+    rss.Report(state);
+}
+
+void BM_LoadGameArtifact(benchmark::State& state) {
+    const auto [config, artifact] = GetConfigFiles(static_cast<size_t>(state.range(0)));
+    // Хэш конфигурации сервер считает при каждом запуске, поэтому он входит в замер
+    RssMeter rss;
+    for(auto _ : state) {
+        auto game = map_artifact::LoadGame(artifact, map_artifact::HashConfigFile(config));
+        if(!game) {
+            state.SkipWithError("map artifact was not loaded");
+            return;
+        }
+        benchmark::DoNotOptimize(game);
+        rss.Sample(state);
+    }
+    state.counters["file_mb"] = static_cast<double>(fs::file_size(artifact)) / BYTES_IN_MB;
+    rss.Report(state);
+}
+
+// Раскладка (индекс в MAP_LAYOUTS) x число дорог
+void LayoutsAndSizes(benchmark::internal::Benchmark* benchmark) {
+    for(int64_t layout = 0; layout < static_cast<int64_t>(bench_utils::MAP_LAYOUTS.size()); ++layout) {
+        for(int64_t roads = 100; roads <= 100000; roads *= 10) {
+            benchmark->Args({layout, roads});
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_RoadmapAddRoad)->Apply(LayoutsAndSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RoadmapGetValidMove)->Apply(LayoutsAndSizes);
+BENCHMARK(BM_MapCopy)->Apply(LayoutsAndSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MapMove)->Apply(LayoutsAndSizes);
+BENCHMARK(BM_SpawnSamplerBuild)->Apply(LayoutsAndSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LegacySpawnPosition)->Apply(LayoutsAndSizes);
+BENCHMARK(BM_SpawnPosition)->Apply(LayoutsAndSizes);
+BENCHMARK(BM_SpawnPositionsBatch)->RangeMultiplier(8)->Range(1, 4096);
+BENCHMARK(BM_LoadGameJson)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadGameArtifact)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+// Нагрузочный замер индекса токенов PlayerTokens: поиск токенов из нескольких потоков
+// одновременно со входом новых игроков. Счетчики joins и lookups показывают число
+// добавлений и поисков в секунду по всем потокам. Пример запуска из каталога решения:
+//   ./build/bin/player_tokens_bench --benchmark_filter='JoinsWithLookups'
+#include "player_tokens.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t PRELOADED_PLAYERS_COUNT = 10000;
+const std::string BENCH_PLAYER_NAME = "bench";
+
+class Fixture {
+public:
+    static Fixture& GetInstance() {
+        static Fixture obj;
+        return obj;
+    }
+
+    authentication::PlayerTokens& GetTokens() {
+        return tokens_;
+    }
+
+    const std::vector<authentication::Token>& GetKnownTokens() const {
+        return known_tokens_;
+    }
+
+    // Вызывается только из пишущего потока замера
+    void AddPlayer() {
+        auto& player = players_.emplace_back(std::make_shared<app::Player>(BENCH_PLAYER_NAME));
+        benchmark::DoNotOptimize(tokens_.AddPlayer(player));
+    }
+
+private:
+    authentication::PlayerTokens tokens_;
+    std::vector< std::shared_ptr<app::Player> > players_;
+    std::vector<authentication::Token> known_tokens_;
+
+    Fixture() {
+        players_.reserve(PRELOADED_PLAYERS_COUNT);
+        known_tokens_.reserve(PRELOADED_PLAYERS_COUNT);
+        for(size_t i = 0; i < PRELOADED_PLAYERS_COUNT; ++i) {
+            auto& player = players_.emplace_back(std::make_shared<app::Player>(BENCH_PLAYER_NAME));
+            known_tokens_.push_back(tokens_.AddPlayer(player));
+        }
+    }
+};
+
+// Каждый поток ищет известные токены в своем случайном порядке
+bool LookupKnownToken(std::mt19937& generator) {
+    auto& fixture = Fixture::GetInstance();
+    const auto& known_tokens = fixture.GetKnownTokens();
+    std::uniform_int_distribution<size_t> dist(0, known_tokens.size() - 1);
+    return !fixture.GetTokens().FindPlayerBy(known_tokens[dist(generator)]).expired();
+}
+
+void BM_Lookups(benchmark::State& state) {
+    std::mt19937 generator(state.thread_index());
+    for(auto _ : state) {
+        if(!LookupKnownToken(generator)) {
+            state.SkipWithError("Known token is not found");
+            break;
+        }
+    }
+    state.counters["lookups"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+void BM_UnknownTokenLookups(benchmark::State& state) {
+    const authentication::Token unknown_token{std::string(32, '0')};
+    auto& tokens = Fixture::GetInstance().GetTokens();
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(tokens.FindPlayerBy(unknown_token));
+    }
+    state.counters["lookups"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/*Нулевой поток добавляет игроков, остальные ищут токены. Смешанная нагрузка показывает,
+сколько поисков выдерживает индекс, пока идет вход в игру*/
+void BM_JoinsWithLookups(benchmark::State& state) {
+    Fixture::GetInstance();
+    const bool is_writer = state.thread_index() == 0;
+    std::mt19937 generator(state.thread_index());
+    for(auto _ : state) {
+        if(is_writer) {
+            Fixture::GetInstance().AddPlayer();
+        } else if(!LookupKnownToken(generator)) {
+            state.SkipWithError("Known token is not found");
+            break;
+        }
+    }
+    state.counters[is_writer ? "joins" : "lookups"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+}
+
+BENCHMARK(BM_Lookups)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_UnknownTokenLookups)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_JoinsWithLookups)->DenseThreadRange(2, 8, 2)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+// Замер генераторов случайных чисел: прежний способ с std::random_device на каждый вызов,
+// генераторы потоков и сеансов RandomService и криптостойкие байты для токенов. Генератор
+// сеанса засевается одним зерном, поэтому его последовательность повторяется между запусками:
+//   ./build/bin/random_bench --benchmark_filter='Interval'
+#include "random_generators.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+const uint64_t BENCH_SEED = 42;
+
+// Прежняя реализация GenerateDoubleFromInterval
+double GenerateWithRandomDevice(double lower, double upper) {
+    std::random_device rd;
+    std::default_random_engine eng(rd());
+    std::uniform_real_distribution<double> distr(lower, upper);
+    return distr(eng);
+}
+
+void BM_RandomDevicePerCallInterval(benchmark::State& state) {
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(GenerateWithRandomDevice(0.0, 100.0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ThreadGeneratorInterval(benchmark::State& state) {
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(utils::GenerateDoubleFromInterval(0.0, 100.0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_SessionGeneratorRaw(benchmark::State& state) {
+    utils::RandomService::GetInstance().SetSeed(BENCH_SEED);
+    auto generator = utils::RandomService::GetInstance().MakeSessionGenerator("bench", 0);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(generator());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 16 байт - столько берет один токен игрока
+void BM_SecureTokenBytes(benchmark::State& state) {
+    std::array<uint64_t, 2> halves;
+    for(auto _ : state) {
+        utils::FillSecureRandomBytes(halves.data(), sizeof(halves));
+        benchmark::DoNotOptimize(halves);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_RandomDevicePerCallInterval);
+BENCHMARK(BM_ThreadGeneratorInterval)->ThreadRange(1, 8);
+BENCHMARK(BM_SessionGeneratorRaw);
+BENCHMARK(BM_SecureTokenBytes)->ThreadRange(1, 8);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+// Замер построения индекса дорог: время и объем выделенной памяти.
+// BM_LegacyCellGridBuild строит прежний индекс из ячеек 0.05x0.05 (model::legacy::Roadmap из tests/legacy,
+// та же копия, с которой сравнивают модульные тесты), BM_RoadmapBuild - текущий индекс из отрезков
+// на линиях дорог. Прежний индекс на тысячах длинных дорог не помещается в память,
+// поэтому он меряется на малых картах.
+// Замер перемещения: прежняя реализация проходит ячейки по одной, текущая находит край дороги сразу.
+// Совпадение результатов обеих реализаций проверяют модульные тесты tests/roadmap-tests.cpp.
+//   ./build/bin/roadmap_bench --benchmark_counters_tabular=true
+#include "../tests/legacy/roadmap.h"
+#include "roadmap.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> allocated_bytes{0};
+
+}
+
+void* operator new(std::size_t size) {
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if(void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+// Расстояние между соседними параллельными дорогами
+const int ROADS_STEP = 2;
+
+// Прежний индекс пополняется при каждой дороге, текущий строится после добавления всех дорог
+template <typename Index>
+void FinishIndex(Index& index) {
+    if constexpr(requires { index.BuildIndex(); }) {
+        index.BuildIndex();
+    }
+}
+
+/*Решетка из roads_count дорог длиной road_length: половина горизонтальных, половина вертикальных,
+параллельные дороги идут с шагом ROADS_STEP*/
+template <typename Index>
+void FillLattice(Index& index, int roads_count, int road_length) {
+    for(int i = 0; i < roads_count; ++i) {
+        const int line = (i / 2) * ROADS_STEP;
+        if(i % 2 == 0) {
+            index.AddRoad(model::Road{model::Road::HORIZONTAL, {0, line}, road_length});
+        } else {
+            index.AddRoad(model::Road{model::Road::VERTICAL, {line, 0}, road_length});
+        }
+    }
+    FinishIndex(index);
+}
+
+template <typename Index>
+void BuildIndex(benchmark::State& state) {
+    const auto roads_count = static_cast<int>(state.range(0));
+    const auto road_length = static_cast<int>(state.range(1));
+    size_t bytes = 0;
+    for(auto _ : state) {
+        const size_t before = allocated_bytes.load(std::memory_order_relaxed);
+        {
+            Index index;
+            FillLattice(index, roads_count, road_length);
+            bytes = allocated_bytes.load(std::memory_order_relaxed) - before;
+            benchmark::DoNotOptimize(index);
+            // Освобождение памяти тоже входит в цену индекса
+        }
+    }
+    state.counters["allocated_bytes"] = static_cast<double>(bytes);
+    state.counters["bytes_per_road"] = static_cast<double>(bytes) / roads_count;
+    state.SetItemsProcessed(state.iterations() * roads_count);
+}
+
+void BM_LegacyCellGridBuild(benchmark::State& state) {
+    BuildIndex<model::legacy::Roadmap>(state);
+}
+
+void BM_RoadmapBuild(benchmark::State& state) {
+    BuildIndex<model::Roadmap>(state);
+}
+
+// Короткий шаг собаки вдоль дороги на большой карте: поиск дорог под начальной и конечной точкой
+void BM_RoadmapShortMove(benchmark::State& state) {
+    const auto roads_count = static_cast<int>(state.range(0));
+    const auto road_length = static_cast<int>(state.range(1));
+    model::Roadmap roadmap;
+    FillLattice(roadmap, roads_count, road_length);
+    const model::Velocity velocity{1.0, 0};
+    double x = 0;
+    for(auto _ : state) {
+        const model::Position position{x, 0};
+        benchmark::DoNotOptimize(roadmap.GetValidMove(position, {x + 0.04, 0}, velocity));
+        x = (x + 1.0 < road_length) ? x + 1.0 : 0;
+    }
+}
+
+// Собака пробегает дорогу длиной road_length целиком и упирается в ее конец, как при большом delta_time
+template <typename Index>
+void LongMove(benchmark::State& state) {
+    const auto road_length = static_cast<int>(state.range(0));
+    Index index;
+    index.AddRoad(model::Road{model::Road::HORIZONTAL, {0, 0}, road_length});
+    FinishIndex(index);
+    const model::Velocity velocity{1.0, 0};
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(index.GetValidMove({0, 0}, {2.0 * road_length, 0}, velocity));
+    }
+}
+
+void BM_LegacyLongMove(benchmark::State& state) {
+    LongMove<model::legacy::Roadmap>(state);
+}
+
+void BM_RoadmapLongMove(benchmark::State& state) {
+    LongMove<model::Roadmap>(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_LegacyCellGridBuild)->Args({16, 100})->Args({64, 100})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RoadmapBuild)
+    ->Args({16, 100})->Args({64, 100})->Args({1000, 1000})->Args({4000, 2000})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RoadmapShortMove)->Args({4000, 2000});
+BENCHMARK(BM_LegacyLongMove)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RoadmapLongMove)->Arg(10)->Arg(100)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
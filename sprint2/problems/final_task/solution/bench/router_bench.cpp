@@ -0,0 +1,178 @@
+// Замер диспетчеризации запросов API маршрутизатором ApiV1Router: поиск пути в радикс-дереве,
+// построение RequestContext и выполнение обработчика. Для сравнения те же запросы выполняет
+// прежний линейный перебор активаторов (bench/legacy_executor.h). Путь до конфигурации задается переменной окружения
+// GAME_SERVER_CONFIG (по умолчанию data/config.json). Пример запуска из каталога решения:
+//   ./build/bin/router_bench --benchmark_filter='game/player/action'
+#include "api_v1_router.h"
+#include "json_loader.h"
+#include "legacy_executor.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/io_context.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+namespace net = boost::asio;
+namespace http = boost::beast::http;
+
+using Request = http::request<http::string_body>;
+
+struct CountingSend {
+    unsigned* last_status;
+
+    template <typename Response>
+    void operator()(const Response& response) const {
+        *last_status = response.result_int();
+    }
+
+    void operator()(const http_server::PreparedResponseRef& response) const {
+        *last_status = response.response->GetHeader().result_int();
+    }
+};
+
+using Router = rh_storage::ApiV1Router<Request, CountingSend>;
+using Executor = bench_utils::LegacyApiV1Executor<Request, CountingSend>;
+
+const std::string BENCH_PLAYER_NAME = "bench";
+const std::string BENCH_MAP_ID = "map1";
+
+class Fixture {
+public:
+    static Fixture& GetInstance() {
+        static Fixture obj;
+        return obj;
+    }
+
+    app::Application& GetApplication() {
+        return *application_;
+    }
+
+    const std::string& GetToken() const {
+        return token_;
+    }
+
+    // Выполняет отложенные в strand'ах сеансов обработчики
+    void Poll() {
+        ioc_.poll();
+        ioc_.restart();
+    }
+
+private:
+    net::io_context ioc_;
+    std::unique_ptr<app::Application> application_;
+    std::string token_;
+
+    Fixture() {
+        const char* config = std::getenv("GAME_SERVER_CONFIG");
+        application_ = std::make_unique<app::Application>(
+            json_loader::LoadGame(config != nullptr ? config : "data/config.json"), time_m::TickerConfig{}, false, ioc_);
+        rh_storage::ResponseCache::GetInstance().Build(application_->ListMap());
+        application_->JoinGame(BENCH_PLAYER_NAME, model::Map::Id(BENCH_MAP_ID), [this](const app::JoinGameResult& result) {
+            token_ = *result.token;
+        });
+        Poll();
+    }
+};
+
+struct BenchRequest {
+    Request req;
+    unsigned expected_status;
+};
+
+BenchRequest MakeRequest(unsigned expected_status, http::verb method, std::string target,
+                        std::string body = {}, bool authorized = false) {
+    Request req{method, target, 11};
+    if(!body.empty()) {
+        req.set(http::field::content_type, rh_storage::CONTENT_TYPE_APPLICATION_JSON);
+        req.body() = std::move(body);
+        req.prepare_payload();
+    }
+    if(authorized) {
+        req.set(http::field::authorization, "Bearer " + Fixture::GetInstance().GetToken());
+    }
+    return {std::move(req), expected_status};
+}
+
+// Набор запросов, покрывающий успешные ответы и ошибки 400/401/404/405
+std::vector<BenchRequest> MakeRequests() {
+    return {
+        MakeRequest(200, http::verb::get, "/api/v1/maps"),
+        MakeRequest(200, http::verb::get, "/api/v1/maps/map1"),
+        MakeRequest(404, http::verb::get, "/api/v1/maps/unknown"),
+        MakeRequest(400, http::verb::post, "/api/v1/maps"),
+        MakeRequest(400, http::verb::get, "/api/v2/maps"),
+        MakeRequest(400, http::verb::get, "/api/v1/game/unknown"),
+        MakeRequest(400, http::verb::post, "/api/v1/game/join", R"({"userName": "", "mapId": "map1"})"),
+        MakeRequest(400, http::verb::post, "/api/v1/game/join", R"({"userName": "dog"})"),
+        MakeRequest(400, http::verb::get, "/api/v1/game/join"),
+        MakeRequest(401, http::verb::get, "/api/v1/game/players"),
+        MakeRequest(200, http::verb::get, "/api/v1/game/players", {}, true),
+        MakeRequest(200, http::verb::get, "/api/v1/game/state/", {}, true),
+        MakeRequest(405, http::verb::post, "/api/v1/game/state", {}, true),
+        MakeRequest(200, http::verb::post, "/api/v1/game/player/action", R"({"move": "L"})", true),
+        MakeRequest(400, http::verb::post, "/api/v1/game/player/action", R"({"move": "X"})", true),
+        MakeRequest(405, http::verb::post, "/api/v1/game/player/action", R"({"move": "L"})"),
+        MakeRequest(200, http::verb::post, "/api/v1/game/tick", R"({"timeDelta": 100})"),
+        MakeRequest(400, http::verb::post, "/api/v1/game/tick", R"({"time": 100})")
+    };
+}
+
+template <typename Dispatcher>
+unsigned Dispatch(Dispatcher& dispatcher, const Request& req) {
+    auto& fixture = Fixture::GetInstance();
+    unsigned status = 0;
+    if(!dispatcher.Execute(req, fixture.GetApplication(), CountingSend{&status})) {
+        rh_storage::BadRequestHandler(req, rh_storage::RequestContext{}, fixture.GetApplication(), CountingSend{&status});
+    }
+    fixture.Poll();
+    return status;
+}
+
+// Перед замером убеждаемся, что маршрутизатор и прежний перебор отвечают ожидаемыми статусами
+template <typename Dispatcher>
+void CheckExpectedStatuses(Dispatcher& dispatcher, std::string_view name, const std::vector<BenchRequest>& requests) {
+    for(const auto& [req, expected_status] : requests) {
+        auto status = Dispatch(dispatcher, req);
+        if(status != expected_status) {
+            throw std::logic_error(std::string(name) + ": unexpected status for " + std::string(req.target()) + ": "
+                                    + std::to_string(status) + " != " + std::to_string(expected_status));
+        }
+    }
+}
+
+template <typename Dispatcher>
+void BM_Dispatch(benchmark::State& state, Dispatcher& dispatcher, const Request& req) {
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(Dispatch(dispatcher, req));
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    // Запросы создаются после загрузки игры: для части из них нужен токен игрока
+    static const auto requests = MakeRequests();
+    CheckExpectedStatuses(Router::GetInstance(), "Router", requests);
+    CheckExpectedStatuses(Executor::GetInstance(), "Executor", requests);
+    for(const auto& [req, expected_status] : requests) {
+        auto label = std::string(http::to_string(req.method())) + " " + std::string(req.target());
+        benchmark::RegisterBenchmark(("Executor/" + label).c_str(), [&req = req](benchmark::State& state) {
+            BM_Dispatch(state, Executor::GetInstance(), req);
+        });
+        benchmark::RegisterBenchmark(("Router/" + label).c_str(), [&req = req](benchmark::State& state) {
+            BM_Dispatch(state, Router::GetInstance(), req);
+        });
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Замер перемещения собак на тике в пуле с кражей задач в зависимости от числа собак и потоков.
+// Карта - синтетическая сетка дорог, собаки расставлены на ней детерминированно. После замера
+// несколько тиков прогоняются параллельно и последовательно, и при расхождении позиций или
+// скоростей замер завершается ошибкой. Пример запуска из каталога решения:
+//   ./build/bin/tick_engine_bench --benchmark_filter='BM_Tick/dogs:100000'
+#include "grid_map.h"
+#include "dog.h"
+#include "work_stealing_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+
+namespace {
+
+using namespace std::literals;
+
+const size_t BATCH_SIZE = 256;
+const size_t CHECK_TICKS_COUNT = 20;
+const std::chrono::milliseconds TICK_PERIOD = 50ms;
+
+std::unique_ptr<model::DogStore> MakeDogs(size_t count) {
+    auto dogs = std::make_unique<model::DogStore>();
+    const double velocity = bench_utils::GetGridMap().GetDogVelocity();
+    bench_utils::PlaceDogs(count, [&dogs, velocity](const bench_utils::DogPlacement& placement) {
+        model::Dog dog{*dogs, dogs->Add("bench"s)};
+        dog.SetPosition(placement.position);
+        dog.SetAction(placement.direction, velocity);
+    });
+    return dogs;
+}
+
+void Tick(utils::WorkStealingPool& pool, model::DogStore& dogs) {
+    const auto& map = bench_utils::GetGridMap();
+    pool.ParallelFor(dogs.Size(), BATCH_SIZE, [&dogs, &map](size_t begin, size_t end) {
+        dogs.Move(map, TICK_PERIOD, begin, end);
+    });
+}
+
+// Собаки добавлялись без удалений, поэтому дескрипторы совпадают
+bool IsSameState(const model::DogStore& lhs, const model::DogStore& rhs) {
+    for(model::DogStore::Handle handle = 0; handle < lhs.Size(); ++handle) {
+        if(lhs.GetPosition(handle).x != rhs.GetPosition(handle).x
+                || lhs.GetPosition(handle).y != rhs.GetPosition(handle).y
+                || !(lhs.GetVelocity(handle) == rhs.GetVelocity(handle))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Аргументы: число собак и число рабочих потоков пула (0 - последовательное выполнение)
+void BM_Tick(benchmark::State& state) {
+    const auto dogs_count = static_cast<size_t>(state.range(0));
+    utils::WorkStealingPool pool(static_cast<size_t>(state.range(1)));
+    auto dogs = MakeDogs(dogs_count);
+    for(auto _ : state) {
+        Tick(pool, *dogs);
+    }
+    state.counters["dogs"] = benchmark::Counter(static_cast<double>(state.iterations() * dogs_count),
+                                                benchmark::Counter::kIsRate);
+
+    auto parallel = MakeDogs(dogs_count);
+    auto serial = MakeDogs(dogs_count);
+    utils::WorkStealingPool serial_pool(0);
+    for(size_t i = 0; i < CHECK_TICKS_COUNT; ++i) {
+        Tick(pool, *parallel);
+        Tick(serial_pool, *serial);
+    }
+    if(!IsSameState(*parallel, *serial)) {
+        state.SkipWithError("Parallel tick differs from serial tick");
+    }
+}
+
+void TickArguments(benchmark::internal::Benchmark* bench) {
+    for(int64_t dogs_count : {1000, 10000, 100000}) {
+        for(int64_t threads : {0, 1, 2, 4, 8}) {
+            bench->Args({dogs_count, threads});
+        }
+    }
+}
+
+}
+
+BENCHMARK(BM_Tick)->Apply(TickArguments)->ArgNames({"dogs", "threads"})->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+// Замер опоздания тиков игрового сеанса под сетевой нагрузкой. Сетевые потоки непрерывно заняты
+// обработчиками по 2 мс (так ведут себя разбор запросов, раздача статики и логирование под нагрузкой).
+// Тикер сеанса работает либо в том же io_context, что и сетевые обработчики (dedicated:0), либо
+// в отдельном потоке симуляции, как с --simulation-threads (dedicated:1). Опоздание тика - время
+// от запланированного момента до запуска его обработчика. Пример запуска из каталога решения:
+//   ./build/bin/tick_jitter_bench
+#include "simulation_threads.h"
+#include "ticker.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+namespace net = boost::asio;
+using Clock = std::chrono::steady_clock;
+
+const std::chrono::milliseconds TICK_PERIOD = 10ms;
+const std::chrono::microseconds NETWORK_HANDLER_TIME = 2ms;
+const size_t NETWORK_THREADS = 2;
+// Столько обработчиков постоянно ждут в очереди на каждый сетевой поток
+const size_t QUEUED_HANDLERS_PER_THREAD = 4;
+const size_t TICKS_COUNT = 200;
+const double PERCENTILE_50 = 0.5;
+const double PERCENTILE_99 = 0.99;
+
+// Обработчики, которые занимают поток на NETWORK_HANDLER_TIME и ставят себя в очередь снова
+class NetworkLoad {
+public:
+    explicit NetworkLoad(net::io_context& ioc)
+        : ioc_(ioc) {
+    }
+
+    void Start(size_t handlers_count) {
+        for(size_t i = 0; i < handlers_count; ++i) {
+            Post();
+        }
+    }
+
+    void Stop() noexcept {
+        stopped_.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    net::io_context& ioc_;
+    std::atomic<bool> stopped_{false};
+
+    void Post() {
+        net::post(ioc_, [this] {
+            if(stopped_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const auto end = Clock::now() + NETWORK_HANDLER_TIME;
+            while(Clock::now() < end) {
+            }
+            Post();
+        });
+    }
+};
+
+double GetPercentile(const std::vector<double>& sorted, double percentile) {
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(percentile * sorted.size()))];
+}
+
+void BM_TickLateness(benchmark::State& state) {
+    const bool dedicated = state.range(0) != 0;
+    std::vector<double> lateness;
+    for(auto _ : state) {
+        net::io_context network_ioc;
+        http_server::SimulationThreads simulation(dedicated ? 1 : 0, false);
+        net::io_context& tick_ioc = dedicated ? simulation.GetIoContexts().front().get() : network_ioc;
+
+        NetworkLoad load{network_ioc};
+        load.Start(NETWORK_THREADS * QUEUED_HANDLERS_PER_THREAD);
+
+        std::vector<Clock::time_point> ticks;
+        ticks.reserve(TICKS_COUNT);
+        std::promise<void> done;
+        time_m::TickerConfig config;
+        config.period = TICK_PERIOD;
+        // Пропущенные тики выполняются все, поэтому k-й вызов обработчика соответствует k-му тику
+        config.max_catch_up_steps = TICKS_COUNT;
+        auto strand = std::make_shared<time_m::Ticker::Strand>(net::make_strand(tick_ioc));
+        auto ticker = std::make_shared<time_m::Ticker>(strand, config, [&ticks, &done](const auto&) {
+            if(ticks.size() < TICKS_COUNT) {
+                ticks.push_back(Clock::now());
+                if(ticks.size() == TICKS_COUNT) {
+                    done.set_value();
+                }
+            }
+        });
+        const auto start = Clock::now();
+        ticker->Start();
+        simulation.Start();
+        std::vector<std::jthread> workers;
+        for(size_t i = 0; i < NETWORK_THREADS; ++i) {
+            workers.emplace_back([&network_ioc] {
+                network_ioc.run();
+            });
+        }
+        done.get_future().wait();
+        load.Stop();
+        network_ioc.stop();
+        simulation.Stop();
+        workers.clear();
+
+        for(size_t i = 0; i < ticks.size(); ++i) {
+            const auto scheduled = start + TICK_PERIOD * static_cast<std::chrono::milliseconds::rep>(i + 1);
+            lateness.push_back(std::chrono::duration<double, std::micro>(ticks[i] - scheduled).count());
+        }
+    }
+    std::sort(lateness.begin(), lateness.end());
+    state.counters["lateness_p50_us"] = GetPercentile(lateness, PERCENTILE_50);
+    state.counters["lateness_p99_us"] = GetPercentile(lateness, PERCENTILE_99);
+    state.counters["lateness_max_us"] = lateness.back();
+}
+
+}  // namespace
+
+BENCHMARK(BM_TickLateness)->ArgName("dedicated")->Arg(0)->Arg(1)->Iterations(1)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
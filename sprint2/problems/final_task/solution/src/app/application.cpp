@@ -1,11 +1,18 @@
 #include "application.h"
 
 #include <iostream>
+#include <mutex>
 
 namespace app {
 
 using namespace std::literals;
 
+namespace {
+
+const size_t FIRST_SESSION_ON_MAP = 0;
+
+}
+
 const model::Game::Maps& Application::ListMap() const noexcept {
     return game_.GetMaps();
 };
@@ -14,66 +21,61 @@ const std::shared_ptr<model::Map> Application::FindMap(const model::Map::Id& id)
     return game_.FindMap(id);
 };
 
-std::tuple<authentication::Token, Player::Id> Application::JoinGame(
+JoinGameResult Application::RegisterPlayer(
         const std::string& player_name,
         const model::Map::Id& id) {
-    auto player = CreatePlayer(player_name);
-    auto token = player_tokens_.AddPlayer(player);
-    std::shared_ptr<GameSession> game_session = FindGameSessionBy(id);
+    std::unique_lock lock{registry_mutex_};
+    auto player = std::make_shared<Player>(player_name);
+    std::shared_ptr<GameSession> game_session = FindGameSessionByUnlocked(id);
     if(!game_session){
-        game_session = std::make_shared<GameSession>(game_.FindMap(id), ioc_);
+        auto& ioc = session_contexts_[sessions_.size() % session_contexts_.size()].get();
+        // На карте не больше одного сеанса. Номер в общем списке сеансов не подходит для зерна генератора:
+        // он зависит от того, на какую карту раньше вошли игроки
+        game_session = std::make_shared<GameSession>(game_.FindMap(id), FIRST_SESSION_ON_MAP, ioc,
+                                                    randomize_spawn_points_, ticker_config_,
+                                                    game_.GetDogRetirementTime());
+        // Сеансы живут до завершения программы вместе с приложением
+        game_session->SetRetirementHandler([this](const PlayerRetirement& retirement) {
+            OnPlayerRetired(retirement);
+        });
         AddGameSession(game_session);
     }
-    BoundPlayerAndGameSession(player, game_session);
-    return std::tie(token, player->GetId());
-};
-
-std::shared_ptr<Player> Application::CreatePlayer(const std::string& player_name) {
-    auto player = std::make_shared<Player>(player_name);
-    players_.push_back(player);
-    return player;
+    player->SetGameSession(game_session);
+    // Слот и сеанс игрока задаются до публикации токена, после нее игрок доступен из других потоков
+    player->SetSessionSlot(game_session->ReserveSlot());
+    auto token = player_tokens_.AddPlayer(player);
+    players_.emplace(player->GetId(), PlayerRecord{player, token});
+    return {std::move(token), std::move(player)};
 };
 
-void Application::BoundPlayerAndGameSession(std::shared_ptr<Player> player,
-                                    std::shared_ptr<GameSession> session){
-    session_id_to_players_[session->GetId()].push_back(player);
-    player->SetGameSession(session);
-    player->CreateDog(player->GetName(), *(session->GetMap()), randomize_spawn_points_);
+void Application::AddRetirementListener(RetirementHandler listener) {
+    retirement_listeners_.push_back(std::move(listener));
 };
 
-const std::vector< std::weak_ptr<Player> >& Application::GetPlayersFromGameSession(const authentication::Token& token) {
-    static const std::vector< std::weak_ptr<Player> > emptyPlayerList;
-    auto player = player_tokens_.FindPlayerBy(token).lock();
-    auto session_id = player->GetGameSessionId();
-    if(!session_id_to_players_.contains(session_id)) {
-        return emptyPlayerList;
+void Application::OnPlayerRetired(const PlayerRetirement& retirement) {
+    {
+        std::unique_lock lock{registry_mutex_};
+        if(auto it = players_.find(Player::Id{retirement.player_id}); it != players_.end()) {
+            player_tokens_.RemovePlayer(it->second.token);
+            players_.erase(it);
+        }
+    }
+    for(const auto& listener : retirement_listeners_) {
+        listener(retirement);
     }
-    return session_id_to_players_[session_id];
 };
 
-bool Application::IsExistPlayer(const authentication::Token& token) {
-    return !player_tokens_.FindPlayerBy(token).expired();
+std::shared_ptr<Player> Application::FindPlayerBy(const authentication::Token& token) const {
+    // Индекс токенов синхронизирован сам, общий мьютекс реестров здесь не нужен
+    return player_tokens_.FindPlayerBy(token).lock();
 };
 
-void Application::SetPlayerAction(const authentication::Token& token, model::Direction direction) {
-    auto player = player_tokens_.FindPlayerBy(token).lock();
-    auto dog = player->GetDog();
-    double velocity = player->GetGameSession()->GetMap()->GetDogVelocity();
-    dog->SetAction(direction, velocity);
+bool Application::IsExistPlayer(const authentication::Token& token) const {
+    return FindPlayerBy(token) != nullptr;
 };
 
 bool Application::IsManualTimeManagement() {
-    return tick_period_.count() == 0;
-};
-
-void Application::UpdateGameState(const std::chrono::milliseconds& delta_time) {
-    for(auto player : players_) {
-        player->MoveDog(delta_time);
-    }
-};
-
-std::shared_ptr<Application::AppStrand> Application::GetStrand() {
-    return strand_;
+    return ticker_config_.period.count() == 0;
 };
 
 void Application::AddGameSession(std::shared_ptr<GameSession> session) {
@@ -90,11 +92,21 @@ void Application::AddGameSession(std::shared_ptr<GameSession> session) {
     }
 };
 
-std::shared_ptr<GameSession> Application::FindGameSessionBy(const model::Map::Id& id) const noexcept {
+std::shared_ptr<GameSession> Application::FindGameSessionBy(const model::Map::Id& id) const {
+    std::shared_lock lock{registry_mutex_};
+    return FindGameSessionByUnlocked(id);
+};
+
+std::shared_ptr<GameSession> Application::FindGameSessionByUnlocked(const model::Map::Id& id) const noexcept {
     if (auto it = map_id_to_session_index_.find(id); it != map_id_to_session_index_.end()) {
         return sessions_.at(it->second);
     }
     return nullptr;
 };
 
-}
\ No newline at end of file
+std::vector< std::shared_ptr<GameSession> > Application::GetGameSessions() const {
+    std::shared_lock lock{registry_mutex_};
+    return sessions_;
+};
+
+}
@@ -2,12 +2,13 @@
 #include "game.h"
 #include "player.h"
 #include "player_tokens.h"
+#include "player_retirement.h"
 #include "tagged.h"
-#include "ticker.h"
 
+#include <atomic>
 #include <vector>
 #include <memory>
-#include <tuple>
+#include <shared_mutex>
 #include <unordered_map>
 #include <functional>
 
@@ -15,24 +16,32 @@ namespace app {
 
 namespace net = boost::asio;
 
+struct JoinGameResult {
+    authentication::Token token;
+    std::shared_ptr<Player> player;
+};
+
+/*Приложение хранит только общие реестры: игроков, токены и сеансы по картам. Реестры доступны
+из любого потока: игроки и сеансы защищены мьютексом, а индекс токенов разбит на шарды
+со своими блокировками, чтобы проверка токена не конкурировала со входом в игру.
+Состояние каждого сеанса изменяется в strand этого сеанса (см. GameSession), поэтому
+нагрузка на одну карту не задерживает запросы к другим. Ушедшие по простою игроки
+удаляются из реестров, после чего о них узнают подписчики на уход игроков.*/
 class Application {
 public:
-    using AppStrand = net::strand<net::io_context::executor_type>;
+    using IoContexts = std::vector< std::reference_wrapper<net::io_context> >;
 
-    Application(model::Game game, size_t tick_period, bool randomize_spawn_points, net::io_context& ioc) :
+    Application(model::Game game, const time_m::TickerConfig& ticker_config, bool randomize_spawn_points,
+                net::io_context& ioc) :
+            Application(std::move(game), ticker_config, randomize_spawn_points, IoContexts{std::ref(ioc)}) {
+    };
+    // Сеансы распределяются по io_context'ам по кругу
+    Application(model::Game game, const time_m::TickerConfig& ticker_config, bool randomize_spawn_points,
+                IoContexts session_contexts) :
             game_{std::move(game)},
-            tick_period_{tick_period},
+            ticker_config_{ticker_config},
             randomize_spawn_points_{randomize_spawn_points},
-            ioc_{ioc},
-            strand_{std::make_shared<AppStrand>(net::make_strand(ioc))} {
-        if(tick_period_.count() != 0){
-            ticker_ = std::make_shared<time_m::Ticker>(
-                strand_,
-                tick_period_,
-                std::bind(&Application::UpdateGameState, this, std::placeholders::_1)
-            );
-            ticker_->Start();
-        }
+            session_contexts_{std::move(session_contexts)} {
     };
     Application(const Application& other) = delete;
     Application(Application&& other) = delete;
@@ -42,39 +51,79 @@ public:
 
     const model::Game::Maps& ListMap() const noexcept;
     const std::shared_ptr<model::Map> FindMap(const model::Map::Id& id) const noexcept;
-    std::tuple<authentication::Token, Player::Id> JoinGame(const std::string& player_name, const model::Map::Id& id);
-    const std::vector< std::weak_ptr<Player> >& GetPlayersFromGameSession(const authentication::Token& token);
-    bool IsExistPlayer(const authentication::Token& token);
-    void SetPlayerAction(const authentication::Token& token, model::Direction direction);
-    std::shared_ptr<AppStrand> GetStrand();
+    std::shared_ptr<Player> FindPlayerBy(const authentication::Token& token) const;
+    bool IsExistPlayer(const authentication::Token& token) const;
     bool IsManualTimeManagement();
-    void UpdateGameState(const std::chrono::milliseconds& delta_time);
-    void AddGameSession(std::shared_ptr<GameSession> session);
-    std::shared_ptr<GameSession> FindGameSessionBy(const model::Map::Id& id) const noexcept;
+    std::shared_ptr<GameSession> FindGameSessionBy(const model::Map::Id& id) const;
+    std::vector< std::shared_ptr<GameSession> > GetGameSessions() const;
+    /*Подписывает listener на уход игроков по простою. Вызывается при старте, до входа игроков.
+    listener вызывается в strand сеанса ушедшего игрока*/
+    void AddRetirementListener(RetirementHandler listener);
+
+    /*Регистрирует игрока и его токен, затем в strand сеанса создает собаку игрока
+    и вызывает handler(const JoinGameResult&)*/
+    template <typename Handler>
+    void JoinGame(const std::string& player_name, const model::Map::Id& id, Handler&& handler) {
+        auto result = RegisterPlayer(player_name, id);
+        auto session = result.player->GetGameSession();
+        net::dispatch(*session->GetStrand(), [session, result = std::move(result),
+                                            handler = std::forward<Handler>(handler)]() mutable {
+            session->AddPlayer(result.player);
+            handler(result);
+        });
+    }
+
+    /*Обновляет состояние всех сеансов, каждого в своем strand. handler() вызывается
+    после обновления последнего сеанса, в его strand*/
+    template <typename Handler>
+    void UpdateGameState(const std::chrono::milliseconds& delta_time, Handler&& handler) {
+        auto sessions = GetGameSessions();
+        if(sessions.empty()) {
+            handler();
+            return;
+        }
+        struct UpdateState {
+            std::atomic<size_t> remaining;
+            std::decay_t<Handler> handler;
+        };
+        auto state = std::make_shared<UpdateState>(sessions.size(), std::forward<Handler>(handler));
+        for(auto& session : sessions) {
+            net::dispatch(*session->GetStrand(), [session, delta_time, state] {
+                session->UpdateState(delta_time);
+                if(state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    state->handler();
+                }
+            });
+        }
+    }
+
 private:
-    using GameSessionIdHasher = util::TaggedHasher<GameSession::Id>;
-    using GameSessionIdToIndex = std::unordered_map<GameSession::Id,
-                                                    std::vector< std::weak_ptr<Player> >,
-                                                    GameSessionIdHasher>;
     using MapIdHasher = util::TaggedHasher<model::Map::Id>;
     using MapIdToSessionIndex = std::unordered_map<model::Map::Id, size_t, MapIdHasher>;
 
+    struct PlayerRecord {
+        std::shared_ptr<Player> player;
+        authentication::Token token;
+    };
+    using PlayerIdHasher = util::TaggedHasher<Player::Id>;
+    using Players = std::unordered_map<Player::Id, PlayerRecord, PlayerIdHasher>;
+
     model::Game game_;
-    std::chrono::milliseconds tick_period_;
+    time_m::TickerConfig ticker_config_;
     bool randomize_spawn_points_;
-    std::vector< std::shared_ptr<Player> > players_;
-    GameSessionIdToIndex session_id_to_players_;
+    IoContexts session_contexts_;
+
+    mutable std::shared_mutex registry_mutex_;
+    Players players_;
     authentication::PlayerTokens player_tokens_;
-    net::io_context& ioc_;
-    std::shared_ptr<AppStrand> strand_; // todo: temp implementation.
-    std::shared_ptr<time_m::Ticker> ticker_;
     std::vector< std::shared_ptr<app::GameSession> > sessions_;
     MapIdToSessionIndex map_id_to_session_index_;
+    std::vector<RetirementHandler> retirement_listeners_;
 
-    std::shared_ptr<Player> CreatePlayer(const std::string& player_name);
-    void BoundPlayerAndGameSession(std::shared_ptr<Player> player,
-                                    std::shared_ptr<GameSession> session);
-
+    JoinGameResult RegisterPlayer(const std::string& player_name, const model::Map::Id& id);
+    void OnPlayerRetired(const PlayerRetirement& retirement);
+    std::shared_ptr<GameSession> FindGameSessionByUnlocked(const model::Map::Id& id) const noexcept;
+    void AddGameSession(std::shared_ptr<GameSession> session);
 };
 
-}
\ No newline at end of file
+}
@@ -1,9 +1,62 @@
 #include "game_session.h"
+#include "player.h"
+#include "json_converter.h"
+#include "metrics.h"
 #include "random_generators.h"
+#include "tick_engine.h"
 #include "support_types.h"
 
+#include <algorithm>
+
 namespace app {
 
+namespace {
+
+// Команды сверх этого числа за один тик отклоняются
+const size_t ACTIONS_QUEUE_CAPACITY = 4096;
+
+metrics::Gauge& GetActionsQueueDepthGauge() {
+    static metrics::Gauge& gauge = metrics::Registry::GetInstance().GetGauge(
+        "game_session_action_queue_depth", "Player actions waiting for the next tick in all game sessions");
+    return gauge;
+}
+
+metrics::Counter& GetActionsQueueOverflowCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "game_session_action_queue_overflow_total", "Player actions rejected because the game session queue was full");
+    return counter;
+}
+
+metrics::Counter& GetRetiredPlayersCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "game_players_retired_total", "Players removed from game sessions after their dogs stood idle too long");
+    return counter;
+}
+
+}
+
+GameSession::GameSession(std::shared_ptr<model::Map> map, size_t index, net::io_context& ioc,
+                        bool randomize_spawn_points, const time_m::TickerConfig& ticker_config,
+                        std::optional<std::chrono::milliseconds> dog_retirement_time) :
+        map_(map),
+        strand_(std::make_shared<SessionStrand>(net::make_strand(ioc))),
+        id_(*(map->GetId())),
+        randomize_spawn_points_(randomize_spawn_points),
+        random_generator_(utils::RandomService::GetInstance().MakeSessionGenerator(*map->GetId(), index)),
+        actions_(ACTIONS_QUEUE_CAPACITY),
+        dog_retirement_time_(dog_retirement_time) {
+    PublishSnapshot();
+    if(ticker_config.period.count() != 0) {
+        // Сеанс живет до завершения программы, поэтому тикер может хранить указатель на него
+        ticker_ = std::make_shared<time_m::Ticker>(
+            strand_,
+            ticker_config,
+            std::bind(&GameSession::UpdateState, this, std::placeholders::_1)
+        );
+        ticker_->Start();
+    }
+};
+
 const GameSession::Id& GameSession::GetId() const noexcept {
     return id_;
 }
@@ -16,4 +69,192 @@ std::shared_ptr<GameSession::SessionStrand> GameSession::GetStrand() {
     return strand_;
 };
 
-}
\ No newline at end of file
+GameSessionSnapshotPtr GameSession::GetSnapshot() const noexcept {
+    std::lock_guard lock{snapshot_mutex_};
+    return snapshot_;
+};
+
+bool GameSession::IsSnapshotStale() const noexcept {
+    return snapshot_stale_.load(std::memory_order_acquire);
+};
+
+size_t GameSession::ReserveSlot() {
+    std::lock_guard lock{slots_mutex_};
+    if(!free_slots_.empty()) {
+        const size_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        return slot;
+    }
+    return next_slot_++;
+};
+
+bool GameSession::PushAction(const Player& player, model::Direction direction) noexcept {
+    if(!actions_.TryPush({player.GetSessionSlot(), *player.GetId(), direction})) {
+        GetActionsQueueOverflowCounter().Add();
+        return false;
+    }
+    GetActionsQueueDepthGauge().Add(1);
+    return true;
+};
+
+void GameSession::SetRetirementHandler(RetirementHandler handler) {
+    retirement_handler_ = std::move(handler);
+};
+
+void GameSession::AddPlayer(std::shared_ptr<Player> player) {
+    if(randomize_spawn_points_) {
+        player->CreateDogAtRandomPosition(dogs_, player->GetName(), *map_, random_generator_);
+    } else {
+        player->CreateDog(dogs_, player->GetName(), *map_);
+    }
+    // Игроки, вошедшие одновременно, могут добавиться не в порядке выделения слотов
+    const size_t slot = player->GetSessionSlot();
+    if(players_.size() <= slot) {
+        players_.resize(slot + 1);
+        slot_states_.resize(slot + 1);
+    }
+    players_[slot] = player;
+    const auto dog = player->GetDog().GetHandle();
+    slot_states_[slot] = SlotState{dog, session_time_};
+    if(dog_slots_.size() <= dog) {
+        dog_slots_.resize(dog + 1);
+    }
+    dog_slots_[dog] = slot;
+    // Собака появляется стоящей
+    ScheduleRetirement(slot);
+    snapshot_stale_.store(true, std::memory_order_release);
+};
+
+const GameSession::Players& GameSession::GetPlayers() const noexcept {
+    return players_;
+};
+
+GameSessionSnapshotPtr GameSession::GetFreshSnapshot() {
+    if(snapshot_stale_.load(std::memory_order_relaxed)) {
+        PublishSnapshot();
+    }
+    return GetSnapshot();
+};
+
+void GameSession::UpdateState(const std::chrono::milliseconds& delta_time) {
+    ApplyActions();
+    MoveDogs(delta_time);
+    session_time_ += delta_time;
+    retirement_wheel_.Advance(static_cast<uint64_t>(delta_time.count()), [this](size_t slot) {
+        RetirePlayer(slot);
+    });
+    PublishSnapshot();
+};
+
+void GameSession::ApplyActions() {
+    // Команды применяются в порядке поступления, поэтому у каждой собаки остается последняя
+    PlayerAction action;
+    int64_t applied = 0;
+    while(actions_.TryPop(action)) {
+        ++applied;
+        if(action.slot >= players_.size()) {
+            continue;
+        }
+        // Пустой слот - игрок ушел. Слот ушедшего игрока мог достаться новому, его команды не применяются
+        auto player = players_[action.slot].lock();
+        if(!player || *player->GetId() != action.player_id) {
+            continue;
+        }
+        player->SetDogAction(action.direction);
+        if(action.direction == model::Direction::NONE) {
+            ScheduleRetirement(action.slot);
+        } else {
+            CancelRetirement(action.slot);
+        }
+    }
+    if(applied != 0) {
+        GetActionsQueueDepthGauge().Add(-applied);
+    }
+};
+
+void GameSession::MoveDogs(const std::chrono::milliseconds& delta_time) {
+    // Пачки собак перемещаются параллельно, strand сеанса ждет их завершения
+    const model::Map& map = *map_;
+    const bool track_stops = dog_retirement_time_.has_value();
+    TickEngine::GetInstance().ForEachRange(dogs_.Size(), [this, &map, &delta_time, track_stops](size_t begin, size_t end) {
+        std::vector<model::DogStore::Handle> stopped;
+        dogs_.Move(map, delta_time, begin, end, track_stops ? &stopped : nullptr);
+        // Собаки останавливаются редко, поэтому общий список под мьютексом не мешает пачкам
+        if(!stopped.empty()) {
+            std::lock_guard lock{stopped_dogs_mutex_};
+            stopped_dogs_.insert(stopped_dogs_.end(), stopped.begin(), stopped.end());
+        }
+    });
+    // Пачки добавляют собак в порядке завершения, а таймеры с одинаковым сроком срабатывают в порядке
+    // постановки. Сортировка делает порядок ухода игроков независимым от планирования пачек
+    std::sort(stopped_dogs_.begin(), stopped_dogs_.end());
+    for(auto dog : stopped_dogs_) {
+        ScheduleRetirement(dog_slots_[dog]);
+    }
+    stopped_dogs_.clear();
+};
+
+void GameSession::ScheduleRetirement(size_t slot) {
+    auto& state = slot_states_[slot];
+    // Срок отсчитывается от первой остановки, повторные остановки его не сдвигают
+    if(!dog_retirement_time_ || state.retirement_timer != RetirementWheel::INVALID_TIMER) {
+        return;
+    }
+    state.retirement_timer = retirement_wheel_.Schedule(static_cast<uint64_t>(dog_retirement_time_->count()), slot);
+};
+
+void GameSession::CancelRetirement(size_t slot) {
+    auto& state = slot_states_[slot];
+    if(state.retirement_timer != RetirementWheel::INVALID_TIMER) {
+        retirement_wheel_.Cancel(state.retirement_timer);
+        state.retirement_timer = RetirementWheel::INVALID_TIMER;
+    }
+};
+
+void GameSession::RetirePlayer(size_t slot) {
+    auto& state = slot_states_[slot];
+    state.retirement_timer = RetirementWheel::INVALID_TIMER;
+    auto player = players_[slot].lock();
+    if(!player) {
+        return;
+    }
+    PlayerRetirement event{*player->GetId(), player->GetName(), *id_, session_time_ - state.join_time};
+    dogs_.Remove(state.dog);
+    player->ReleaseDog();
+    players_[slot].reset();
+    GetRetiredPlayersCounter().Add();
+    // Реестры приложения очищаются до того, как слот станет доступен новым игрокам
+    if(retirement_handler_) {
+        retirement_handler_(event);
+    }
+    std::lock_guard lock{slots_mutex_};
+    free_slots_.push_back(slot);
+};
+
+void GameSession::PublishSnapshot() {
+    std::vector<PlayerState> players;
+    players.reserve(players_.size());
+    for(const auto& item : players_) {
+        if(auto player = item.lock()) {
+            auto dog = player->GetDog();
+            players.push_back({*player->GetId(), player->GetName(),
+                               dog.GetPosition(), dog.GetVelocity(), dog.GetDirection()});
+        }
+    }
+    // Тик только сериализует тела, сжатие откладывается до первого запроса в сжатой кодировке
+    auto state_json = json_converter::CreateGameStateResponse(players);
+    auto players_list_json = json_converter::CreatePlayersListOnMapResponse(players);
+    auto snapshot = std::make_shared<const GameSessionSnapshot>(std::move(players), std::move(state_json),
+                                                                std::move(players_list_json));
+    GameSessionSnapshotPtr published{std::move(snapshot)};
+    {
+        std::lock_guard lock{snapshot_mutex_};
+        snapshot_.swap(published);
+    }
+    // Игроки добавляются в этом же strand, поэтому в снимке учтены все вошедшие. Пометка снимается
+    // после замены снимка, чтобы поток, увидевший снятую пометку, прочитал уже новый снимок
+    snapshot_stale_.store(false, std::memory_order_release);
+    // Предыдущий снимок освобождается вне блокировки (если его уже никто не читает)
+};
+
+}
@@ -1,9 +1,19 @@
 #pragma once
 #include "map.h"
 #include "dog.h"
+#include "dog_store.h"
 #include "tagged.h"
+#include "ticker.h"
+#include "game_session_snapshot.h"
+#include "player_retirement.h"
+#include "bounded_mpsc_queue.h"
+#include "timing_wheel.h"
+#include "random_generators.h"
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <memory>
 #include <boost/asio/ip/tcp.hpp>
@@ -13,24 +23,107 @@ namespace app {
 
 namespace net = boost::asio;
 
+class Player;
+
+/*Игровой сеанс на одной карте. Состояние сеанса (игроки и их собаки) изменяется и читается
+только в strand сеанса, поэтому сеансы на разных картах работают параллельно и не мешают
+друг другу. При автоматическом управлении временем у каждого сеанса свой тикер в его strand.
+После каждого тика сеанс публикует неизменяемый снимок состояния: запросы состояния и списка
+игроков обслуживаются по нему из любого потока, не заходя в strand. Вход игрока только помечает
+снимок устаревшим, и его публикует первый запрос после входа, поэтому одновременный вход
+многих игроков не пересобирает снимок для каждого из них.
+Команды движения складываются в ограниченную очередь сеанса без блокировок и применяются
+в начале следующего тика. Состояние собак сеанса лежит в DogStore, на тике собаки
+перемещаются пачками в пуле TickEngine. Если задано время простоя, остановившаяся собака
+ставится в колесо таймеров сеанса, и по истечении срока игрок уходит из игры: его слот
+и место собаки в хранилище освобождаются для новых игроков. Случайные точки появления собак
+берутся из собственного генератора сеанса (см. RandomService::MakeSessionGenerator).*/
 class GameSession {
 public:
     using SessionStrand = net::strand<net::io_context::executor_type>;
     using Id = util::Tagged<std::string, GameSession>;
+    using Players = std::vector< std::weak_ptr<Player> >;
+
+    // index - номер сеанса среди сеансов на той же карте, из него и id карты засевается генератор сеанса
+    GameSession(std::shared_ptr<model::Map> map, size_t index, net::io_context& ioc,
+                bool randomize_spawn_points, const time_m::TickerConfig& ticker_config,
+                std::optional<std::chrono::milliseconds> dog_retirement_time = std::nullopt);
+    GameSession(const GameSession& other) = delete;
+    GameSession& operator = (const GameSession& other) = delete;
 
-    GameSession(std::shared_ptr<model::Map> map, net::io_context& ioc) :
-        map_(map),
-        strand_(std::make_shared<SessionStrand>(net::make_strand(ioc))),
-        id_(*(map->GetId())) {};
-    
     const Id& GetId() const noexcept;
     const std::shared_ptr<model::Map> GetMap();
     std::shared_ptr<SessionStrand> GetStrand();
-    
+    // Последний опубликованный снимок. Безопасно вызывать из любого потока
+    GameSessionSnapshotPtr GetSnapshot() const noexcept;
+    // Вошли ли игроки, которых нет в последнем снимке. Безопасно вызывать из любого потока
+    bool IsSnapshotStale() const noexcept;
+    // Выделяет игроку место в сеансе, в том числе освобожденное ушедшим игроком. Безопасно вызывать из любого потока
+    size_t ReserveSlot();
+    /*Ставит команду движения собаки игрока в очередь сеанса. Безопасно вызывать из любого потока.
+    Возвращает false, если очередь переполнена. Команды ушедших игроков отбрасываются на тике*/
+    bool PushAction(const Player& player, model::Direction direction) noexcept;
+    // handler вызывается в strand сеанса при уходе игрока. Задается до входа игроков
+    void SetRetirementHandler(RetirementHandler handler);
+
+    // Методы ниже вызываются только в strand сеанса
+    void AddPlayer(std::shared_ptr<Player> player);
+    const Players& GetPlayers() const noexcept;
+    // Снимок, в котором учтены все вошедшие игроки. Публикует его, если он устарел
+    GameSessionSnapshotPtr GetFreshSnapshot();
+    void UpdateState(const std::chrono::milliseconds& delta_time);
+
 private:
+    struct PlayerAction {
+        size_t slot;
+        size_t player_id;
+        model::Direction direction;
+    };
+
+    using RetirementWheel = utils::TimingWheel<size_t>;
+
+    // Состояние слота, нужное только сеансу
+    struct SlotState {
+        model::DogStore::Handle dog{0};
+        std::chrono::milliseconds join_time{0};
+        RetirementWheel::TimerId retirement_timer{RetirementWheel::INVALID_TIMER};
+    };
+
     std::shared_ptr<model::Map> map_;
     std::shared_ptr<SessionStrand> strand_;
     Id id_;
+    bool randomize_spawn_points_;
+    utils::Xoshiro256 random_generator_;
+    // Игроки хранятся по слотам, выделенным при входе в игру
+    Players players_;
+    std::vector<SlotState> slot_states_;
+    model::DogStore dogs_;
+    // Слот игрока по дескриптору его собаки
+    std::vector<size_t> dog_slots_;
+    std::mutex slots_mutex_;
+    size_t next_slot_{0};
+    std::vector<size_t> free_slots_;
+    utils::BoundedMpscQueue<PlayerAction> actions_;
+    // Игровые часы сеанса и колесо таймеров простоя с шагом в миллисекунду
+    std::chrono::milliseconds session_time_{0};
+    std::optional<std::chrono::milliseconds> dog_retirement_time_;
+    RetirementWheel retirement_wheel_;
+    RetirementHandler retirement_handler_;
+    std::mutex stopped_dogs_mutex_;
+    std::vector<model::DogStore::Handle> stopped_dogs_;
+    std::shared_ptr<time_m::Ticker> ticker_;
+    // Мьютекс держится только на время копирования указателя. std::atomic<std::shared_ptr>
+    // не везде доступен, а в libstdc++ сам реализован через блокировку
+    mutable std::mutex snapshot_mutex_;
+    GameSessionSnapshotPtr snapshot_;
+    std::atomic<bool> snapshot_stale_{false};
+
+    void ApplyActions();
+    void MoveDogs(const std::chrono::milliseconds& delta_time);
+    void ScheduleRetirement(size_t slot);
+    void CancelRetirement(size_t slot);
+    void RetirePlayer(size_t slot);
+    void PublishSnapshot();
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,31 @@
+#include "game_session_snapshot.h"
+#include "request_handlers_utils.h"
+
+namespace app {
+
+SnapshotBody::SnapshotBody(std::string json) {
+    identity_.etag = rh_storage::MakeStrongEtag(json);
+    identity_.data = std::move(json);
+};
+
+const EncodedBody& SnapshotBody::Get(utils::ContentEncoding encoding) const {
+    if(encoding == utils::ContentEncoding::IDENTITY) {
+        return identity_;
+    }
+    auto& variant = encoding == utils::ContentEncoding::GZIP ? gzip_ : deflate_;
+    std::call_once(variant.once, [this, encoding, &body = variant.body]() {
+        const auto& compressor = utils::ResponseCompressor::GetInstance();
+        if(!compressor.IsCompressible(identity_.data.size())) {
+            return;
+        }
+        auto compressed = compressor.Compress(identity_.data, encoding);
+        if(compressed.empty()) {
+            return;
+        }
+        body.data.assign(compressed.data(), compressed.size());
+        body.etag = rh_storage::MakeStrongEtag(body.data);
+    });
+    return variant.body.data.empty() ? identity_ : variant.body;
+};
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "support_types.h"
+#include "http_compression.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace app {
+
+struct PlayerState {
+    size_t id;
+    std::string name;
+    model::Position position;
+    model::Velocity velocity;
+    model::Direction direction;
+};
+
+// Тело ответа в одной кодировке и его строгий ETag
+struct EncodedBody {
+    std::string data;
+    std::string etag;
+};
+
+/*Готовое тело ответа. При публикации снимка сериализуется только несжатый вариант, сжатый
+вариант создается при первом запросе в этой кодировке и переиспользуется всеми следующими,
+поэтому снимок, который никто не запросил со сжатием, не сжимается вовсе. Сжатый вариант
+пуст, если сжатие выключено, тело меньше порога сжатия или zlib вернул ошибку*/
+class SnapshotBody {
+public:
+    explicit SnapshotBody(std::string json);
+
+    SnapshotBody(const SnapshotBody&) = delete;
+    SnapshotBody& operator=(const SnapshotBody&) = delete;
+
+    const EncodedBody& GetIdentity() const noexcept {
+        return identity_;
+    }
+
+    /*Вариант в кодировке encoding, а если его нет - несжатый. Первый вызов для кодировки
+    сжимает тело, одновременные вызовы из других потоков дожидаются его*/
+    const EncodedBody& Get(utils::ContentEncoding encoding) const;
+
+private:
+    struct CompressedBody {
+        std::once_flag once;
+        EncodedBody body;
+    };
+
+    EncodedBody identity_;
+    mutable CompressedBody gzip_;
+    mutable CompressedBody deflate_;
+};
+
+/*Неизменяемое состояние игрового сеанса вместе с готовыми ответами на запросы состояния
+игры и списка игроков: JSON сериализуется один раз при публикации, сколько бы клиентов
+ни запрашивали снимок. Снимок публикуется сеансом целиком и читается из любого потока,
+сжатые варианты тел создаются под std::call_once.*/
+struct GameSessionSnapshot {
+    GameSessionSnapshot(std::vector<PlayerState> players, std::string state_json, std::string players_list_json) :
+            players(std::move(players)),
+            state(std::move(state_json)),
+            players_list(std::move(players_list_json)) {
+    }
+
+    std::vector<PlayerState> players;
+    SnapshotBody state;
+    SnapshotBody players_list;
+};
+
+using GameSessionSnapshotPtr = std::shared_ptr<const GameSessionSnapshot>;
+
+}
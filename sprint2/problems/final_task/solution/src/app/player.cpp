@@ -23,49 +23,48 @@ void Player::SetGameSession(std::shared_ptr<GameSession> session) {
     session_ = session;
 };
 
-std::shared_ptr<model::Dog> Player::GetDog() {
-    return dog_;
+size_t Player::GetSessionSlot() const {
+    return session_slot_;
 };
 
-void Player::MoveDog(const std::chrono::milliseconds& delta_time) {
-    auto [new_position, new_velocity] = session_->GetMap()->GetValidMove(
-                dog_->GetPosition(),
-                dog_->CalculateNewPosition(delta_time),
-                dog_->GetVelocity());
-    dog_->SetPosition(new_position);
-    dog_->SetVelocity(new_velocity);
+void Player::SetSessionSlot(size_t slot) {
+    session_slot_ = slot;
 };
 
-void Player::CreateDog(const std::string& dog_name, const model::Map& map, bool randomize_spawn_points){
-    dog_ = std::make_shared<model::Dog>(dog_name);
-    if(randomize_spawn_points) {
-        LocateDogInRandomPositionOnMap(map);
-    } else {
-        LocateDogInStartPointOnMap(map);
-    }
+model::Dog Player::GetDog() const {
+    return dog_.value();
+};
+
+void Player::SetDogAction(model::Direction direction) {
+    dog_->SetAction(direction, session_->GetMap()->GetDogVelocity());
+};
+
+void Player::ReleaseDog() {
+    dog_.reset();
+};
+
+void Player::CreateDog(model::DogStore& store, const std::string& dog_name, const model::Map& map){
+    dog_.emplace(store, store.Add(dog_name));
+    LocateDogInStartPointOnMap(map);
+};
+
+void Player::CreateDogAtRandomPosition(model::DogStore& store, const std::string& dog_name, const model::Map& map,
+                                       utils::Xoshiro256& generator){
+    dog_.emplace(store, store.Add(dog_name));
+    LocateDogInRandomPositionOnMap(map, generator);
 };
 
-void Player::LocateDogInRandomPositionOnMap(const model::Map& map) {
-    double x, y;
-    auto roads = map.GetRoads();
-    int road_index = utils::GenerateIntegerFromInterval(0, roads.size() - 1);
-    auto road = roads[road_index];
-    if(road.IsHorizontal()) {
-        x = utils::GenerateDoubleFromInterval(road.GetStart().x,
-                                                road.GetEnd().x);
-        y = road.GetStart().y;
-    } else {
-        y = utils::GenerateDoubleFromInterval(road.GetStart().y,
-                                                road.GetEnd().y);
-        x = road.GetStart().x;
+void Player::LocateDogInRandomPositionOnMap(const model::Map& map, utils::Xoshiro256& generator) {
+    const auto& sampler = map.GetSpawnSampler();
+    if(sampler.IsEmpty()) {
+        return;
     }
-    dog_->SetPosition({x, y});
+    const double road_pick = generator.NextDouble();
+    dog_->SetPosition(sampler.GetPosition(road_pick, generator.NextDouble()));
 };
 
 void Player::LocateDogInStartPointOnMap(const model::Map& map) {
-    double x, y;
-    auto roads = map.GetRoads();
-    auto road = roads[0];
+    const auto& road = map.GetRoads().front();
     dog_->SetPosition({static_cast<double>(road.GetStart().x),
                         static_cast<double>(road.GetStart().y)});
 };
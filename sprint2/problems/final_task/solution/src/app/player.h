@@ -2,16 +2,19 @@
 #include "tagged.h"
 #include "game_session.h"
 
+#include <atomic>
+#include <optional>
 #include <string>
 
 namespace app {
 
 class Player {
-    inline static size_t max_id_cont_ = 0;
+    // Игроки создаются из потоков соединений
+    inline static std::atomic<size_t> max_id_cont_ = 0;
 public:
     using Id = util::Tagged<size_t, Player>;
     Player(std::string name) : 
-        id_(Id{Player::max_id_cont_++}),
+        id_(Id{Player::max_id_cont_.fetch_add(1, std::memory_order_relaxed)}),
         name_(name) {};
     Player(Id id, std::string name) :
         id_(id),
@@ -27,16 +30,25 @@ public:
     const GameSession::Id& GetGameSessionId() const;
     std::shared_ptr<GameSession> GetGameSession();
     void SetGameSession(std::shared_ptr<GameSession> session);
-    std::shared_ptr<model::Dog> GetDog();
-    void CreateDog(const std::string& dog_name, const model::Map& map, bool randomize_spawn_points);
-    void MoveDog(const std::chrono::milliseconds& delta_time);
+    size_t GetSessionSlot() const;
+    void SetSessionSlot(size_t slot);
+    model::Dog GetDog() const;
+    // Собака игрока хранится в хранилище собак его сеанса и появляется в начале первой дороги карты
+    void CreateDog(model::DogStore& store, const std::string& dog_name, const model::Map& map);
+    // То же, но собака появляется в случайной точке дорог, числа берутся из генератора сеанса
+    void CreateDogAtRandomPosition(model::DogStore& store, const std::string& dog_name, const model::Map& map,
+                                   utils::Xoshiro256& generator);
+    void SetDogAction(model::Direction direction);
+    // Вызывается сеансом после удаления собаки из хранилища при уходе игрока
+    void ReleaseDog();
 private:
     Id id_;
     std::string name_;
     std::shared_ptr<GameSession> session_;
-    std::shared_ptr<model::Dog> dog_;
+    size_t session_slot_{0};
+    std::optional<model::Dog> dog_;
 
-    void LocateDogInRandomPositionOnMap(const model::Map& map);
+    void LocateDogInRandomPositionOnMap(const model::Map& map, utils::Xoshiro256& generator);
     void LocateDogInStartPointOnMap(const model::Map& map);
 };
 
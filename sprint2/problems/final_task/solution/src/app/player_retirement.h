@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace app {
+
+/*Событие ухода игрока, чья собака простояла дольше dogRetirementTime. К моменту события
+игрок, его собака и токен уже удалены из сеанса и реестров приложения.*/
+struct PlayerRetirement {
+    size_t player_id;
+    std::string name;
+    std::string map_id;
+    // Время от входа в игру до ухода по игровым часам сеанса
+    std::chrono::milliseconds play_time;
+};
+
+using RetirementHandler = std::function<void(const PlayerRetirement&)>;
+
+}
@@ -0,0 +1,18 @@
+#include "tick_engine.h"
+
+namespace app {
+
+TickEngine& TickEngine::GetInstance() {
+    static TickEngine obj;
+    return obj;
+};
+
+void TickEngine::Configure(const TickEngineConfig& config) {
+    config_ = config;
+    pool_.reset();
+    if(config_.threads != 0) {
+        pool_ = std::make_unique<utils::WorkStealingPool>(config_.threads);
+    }
+};
+
+}
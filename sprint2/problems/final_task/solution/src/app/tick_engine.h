@@ -0,0 +1,50 @@
+#pragma once
+#include "work_stealing_pool.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace app {
+
+struct TickEngineConfig {
+    // 0 - собаки перемещаются в потоке тика последовательно
+    size_t threads{0};
+    size_t batch_size{256};
+};
+
+/*Параллельное перемещение собак на тике. Сеансы тикают в своих strand'ах независимо,
+а собаки одного сеанса делятся на пачки, которые выполняются в общем пуле с кражей задач.
+Перемещения собак друг от друга не зависят и не меняют общих данных, поэтому результат тика
+совпадает с последовательным при любом числе потоков.*/
+class TickEngine {
+public:
+    TickEngine(const TickEngine&) = delete;
+    TickEngine& operator=(const TickEngine&) = delete;
+
+    static TickEngine& GetInstance();
+
+    // Вызывается при старте, до запуска тикеров игровых сеансов
+    void Configure(const TickEngineConfig& config);
+
+    size_t GetThreadsCount() const noexcept {
+        return pool_ ? pool_->GetThreadsCount() : 0;
+    }
+
+    // Вызывает fn(begin, end) для пачек диапазона [0, count) и ждет их завершения
+    template <typename Fn>
+    void ForEachRange(size_t count, Fn&& fn) {
+        if(!pool_) {
+            fn(size_t{0}, count);
+            return;
+        }
+        pool_->ParallelFor(count, config_.batch_size, std::forward<Fn>(fn));
+    }
+
+private:
+    TickEngineConfig config_;
+    std::unique_ptr<utils::WorkStealingPool> pool_;
+
+    TickEngine() = default;
+};
+
+}
@@ -1,26 +1,61 @@
 #include "player_tokens.h"
+#include "random_generators.h"
 
-#include <iomanip>
-#include <sstream>
+#include <cstdint>
+#include <string_view>
+#include <utility>
 
 namespace authentication {
 
 const size_t NUMBER_OF_DIGITS_IN_HALF_TOKEN = 16;
+const std::string_view HEX_DIGITS = "0123456789abcdef";
+// Шард выбирается по старшим битам хеша: младшие биты использует unordered_map шарда
+const size_t SHARD_INDEX_SHIFT = 60;
+
+static_assert(PlayerTokens::SHARDS_COUNT == (size_t{1} << (64 - SHARD_INDEX_SHIFT)));
 
 Token PlayerTokens::AddPlayer(std::weak_ptr<app::Player> player) {
-    std::stringstream ss;
-    ss << std::setw(NUMBER_OF_DIGITS_IN_HALF_TOKEN) << std::setfill('0') << std::hex << generator1_();
-    ss << std::setw(NUMBER_OF_DIGITS_IN_HALF_TOKEN) << std::setfill('0') << std::hex << generator2_();
-    Token token{ss.str()};
-    tokenToPalyer_[token] = player;
+    Token token = GenerateToken();
+    auto& shard = GetShard(token);
+    std::unique_lock lock{shard.mutex};
+    shard.token_to_player[token] = player;
     return token;
 };
 
-std::weak_ptr<app::Player> PlayerTokens::FindPlayerBy(Token token) {
-    if(!tokenToPalyer_.contains(token)){
-        return std::weak_ptr<app::Player>();
+std::weak_ptr<app::Player> PlayerTokens::FindPlayerBy(const Token& token) const {
+    const auto& shard = GetShard(token);
+    std::shared_lock lock{shard.mutex};
+    if(auto it = shard.token_to_player.find(token); it != shard.token_to_player.end()) {
+        return it->second;
+    }
+    return std::weak_ptr<app::Player>();
+};
+
+void PlayerTokens::RemovePlayer(const Token& token) {
+    auto& shard = GetShard(token);
+    std::unique_lock lock{shard.mutex};
+    shard.token_to_player.erase(token);
+};
+
+Token PlayerTokens::GenerateToken() {
+    std::array<uint64_t, 2> halves;
+    utils::FillSecureRandomBytes(halves.data(), sizeof(halves));
+    std::string token(2 * NUMBER_OF_DIGITS_IN_HALF_TOKEN, '0');
+    for(size_t half = 0; half < halves.size(); ++half) {
+        uint64_t value = halves[half];
+        for(size_t digit = NUMBER_OF_DIGITS_IN_HALF_TOKEN; digit > 0; --digit, value >>= 4) {
+            token[half * NUMBER_OF_DIGITS_IN_HALF_TOKEN + digit - 1] = HEX_DIGITS[value & 0xf];
+        }
     }
-    return tokenToPalyer_[token];
+    return Token{std::move(token)};
+};
+
+PlayerTokens::Shard& PlayerTokens::GetShard(const Token& token) {
+    return shards_[static_cast<uint64_t>(TokenHasher{}(token)) >> SHARD_INDEX_SHIFT];
+};
+
+const PlayerTokens::Shard& PlayerTokens::GetShard(const Token& token) const {
+    return shards_[static_cast<uint64_t>(TokenHasher{}(token)) >> SHARD_INDEX_SHIFT];
 };
 
-}
\ No newline at end of file
+}
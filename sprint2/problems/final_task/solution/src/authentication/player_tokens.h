@@ -2,7 +2,8 @@
 #include "tagged.h"
 #include "player.h"
 
-#include <random>
+#include <array>
+#include <shared_mutex>
 #include <unordered_map>
 #include <memory>
 #include <string>
@@ -14,32 +15,36 @@ struct TokenTag {};
 using Token = util::Tagged<std::string, TokenTag>;
 using TokenHasher = util::TaggedHasher<Token>;
 
+/*Индекс токенов игроков. Поиск выполняется из потоков соединений при каждом запросе
+с авторизацией, а добавление - только при входе в игру, поэтому индекс разбит на шарды,
+каждый со своей блокировкой чтения-записи. Поиски не мешают друг другу, а вход в игру
+блокирует только один шард.*/
 class PlayerTokens {
 public:
+    static constexpr size_t SHARDS_COUNT = 16;
+
     PlayerTokens() = default;
-    PlayerTokens(const PlayerTokens& other) = default;
-    PlayerTokens(PlayerTokens&& other) = default;
-    PlayerTokens& operator = (const PlayerTokens& other) = default;
-    PlayerTokens& operator = (PlayerTokens&& other) = default;
+    PlayerTokens(const PlayerTokens& other) = delete;
+    PlayerTokens& operator = (const PlayerTokens& other) = delete;
     virtual ~PlayerTokens() = default;
 
+    // Методы безопасно вызывать из любого потока
     Token AddPlayer(std::weak_ptr<app::Player> player);
-    std::weak_ptr<app::Player> FindPlayerBy(Token token);
+    std::weak_ptr<app::Player> FindPlayerBy(const Token& token) const;
+    void RemovePlayer(const Token& token);
 private:
-    std::unordered_map< Token, std::weak_ptr<app::Player>, TokenHasher > tokenToPalyer_;
-    std::random_device random_device_;
-    std::mt19937_64 generator1_{[this] {
-        std::uniform_int_distribution<std::mt19937_64::result_type> dist;
-        return dist(random_device_);
-    }()};
-    std::mt19937_64 generator2_{[this] {
-        std::uniform_int_distribution<std::mt19937_64::result_type> dist;
-        return dist(random_device_);
-    }()};
-    // Чтобы сгенерировать токен, получите из generator1_ и generator2_
-    // два 64-разрядных числа и, переведя их в hex-строки, склейте в одну.
-    // Вы можете поэкспериментировать с алгоритмом генерирования токенов,
-    // чтобы сделать их подбор ещё более затруднительным
+    // Шарды выравниваются по кэш-линии, чтобы блокировки соседних шардов не делили ее
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map< Token, std::weak_ptr<app::Player>, TokenHasher > token_to_player;
+    };
+
+    std::array<Shard, SHARDS_COUNT> shards_;
+
+    // Токен - 128 бит из криптостойкого источника в виде 32 шестнадцатеричных цифр
+    static Token GenerateToken();
+    Shard& GetShard(const Token& token);
+    const Shard& GetShard(const Token& token) const;
 }; 
 
-}  // namespace authentication
\ No newline at end of file
+}  // namespace authentication
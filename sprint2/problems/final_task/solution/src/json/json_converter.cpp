@@ -1,8 +1,8 @@
 #include "json_converter.h"
 #include "model_key_storage.h"
 #include "json_key_storage.h"
+#include <limits>
 #include <map>
-#include <sstream>
 #include <boost/json/array.hpp>
 #include <boost/json.hpp>
 
@@ -10,6 +10,48 @@ namespace json_converter{
 
 namespace json = boost::json;
 
+namespace {
+
+/*Разбирает тело запроса в буфере на стеке: документ живет только до конца обработки
+запроса, поэтому отдельные выделения в куче ему не нужны. Ошибки разбора возвращаются
+через error_code без исключений.*/
+class RequestParser {
+public:
+    static constexpr size_t BUFFER_SIZE = 1024;
+
+    explicit RequestParser(std::string_view msg)
+        : resource_(buffer_, sizeof(buffer_)),
+        value_(Parse(msg, resource_)) {
+    }
+
+    const json::value* Get(std::string_view key) const {
+        auto* obj = value_.if_object();
+        return obj != nullptr ? obj->if_contains(key) : nullptr;
+    }
+
+    const json::string* GetString(std::string_view key) const {
+        auto* value = Get(key);
+        return value != nullptr ? value->if_string() : nullptr;
+    }
+
+private:
+    // Результат перемещается без копирования и остается в ресурсе на стеке
+    static json::value Parse(std::string_view msg, json::monotonic_resource& resource) {
+        boost::system::error_code ec;
+        auto value = json::parse(msg, ec, &resource);
+        if(ec) {
+            return json::value(&resource);
+        }
+        return value;
+    }
+
+    unsigned char buffer_[BUFFER_SIZE];
+    json::monotonic_resource resource_;
+    json::value value_;
+};
+
+}
+
 std::string ConvertMapListToJson(const model::Game::Maps& maps) {
     json::array mapsArr;
     for(auto map : maps) {
@@ -97,39 +139,38 @@ std::string CreatePlayerActionInvalidActionResponse() {
     return json::serialize(msg);
 };
 
+std::string CreatePlayerActionQueueOverflowResponse() {
+    json::value msg = {{json_keys::RESPONSE_CODE, "serviceUnavailable"},
+                        {json_keys::RESPONSE_MESSAGE, "Too many player actions, try again later"}};
+    return json::serialize(msg);
+};
+
 std::string CreateInvalidContentTypeResponse() {
     json::value msg = {{json_keys::RESPONSE_CODE, "invalidArgument"},
                         {json_keys::RESPONSE_MESSAGE, "Invalid content type"}};
     return json::serialize(msg);
 };
 
-std::string CreatePlayersListOnMapResponse(const std::vector< std::weak_ptr<app::Player> >& players) {
+std::string CreatePlayersListOnMapResponse(const std::vector<app::PlayerState>& players) {
     json::value jv;
     json::object& obj = jv.emplace_object();  
-    for(auto item : players) {
-        auto player = item.lock();
-        std::stringstream ss;
-        ss << *(player->GetId());
-        json::value jv_item = {{json_keys::RESPONSE_PLAYER_NAME, player->GetName()}};
-        obj[ss.str()] = jv_item;
+    for(const auto& player : players) {
+        json::value jv_item = {{json_keys::RESPONSE_PLAYER_NAME, player.name}};
+        obj[std::to_string(player.id)] = jv_item;
     }
     return json::serialize(jv);
 };
 
-std::string CreateGameStateResponse(const std::vector< std::weak_ptr<app::Player> >& players) {
+std::string CreateGameStateResponse(const std::vector<app::PlayerState>& players) {
     json::value jv;
     json::object obj;  
-    for(auto item : players) {
-        auto player = item.lock();
-        auto dog = player->GetDog();
-        std::stringstream ss;
-        ss << *(player->GetId());
-        json::array pos = {dog->GetPosition().x, dog->GetPosition().y};
-        json::array speed = {dog->GetVelocity().vx, dog->GetVelocity().vy};
+    for(const auto& player : players) {
+        json::array pos = {player.position.x, player.position.y};
+        json::array speed = {player.velocity.vx, player.velocity.vy};
         json::value jv_item = {{json_keys::RESPONSE_DOG_POSITION, pos},
                                 {json_keys::RESPONSE_DOG_VELOCITY, speed},
-                                {json_keys::RESPONSE_DOG_DIRECTION, model::DIRECTION_TO_STRING.at(dog->GetDirection())}};
-        obj[ss.str()] = jv_item;
+                                {json_keys::RESPONSE_DOG_DIRECTION, model::DIRECTION_TO_STRING.at(player.direction)}};
+        obj[std::to_string(player.id)] = jv_item;
     }
     jv.emplace_object()[json_keys::RESPONSE_PLAYERS] = obj;  
     return json::serialize(jv);
@@ -158,38 +199,36 @@ std::string CreateInvalidEndpointResponse() {
     return json::serialize(msg);
 };
 
-std::optional< std::tuple<std::string, model::Map::Id> > ParseJoinToGameRequest(const std::string& msg) {
-    try {
-        json::value jv = json::parse(msg);
-        std::string player_name = json::value_to<std::string>(jv.as_object().at(json_keys::REQUEST_PLAYER_NAME));
-        model::Map::Id map_id{json::value_to<std::string>(jv.as_object().at(json_keys::REQUEST_MAP_ID))};
-        return std::tie(player_name, map_id);
-    } catch(...) {
+std::optional< std::tuple<std::string, model::Map::Id> > ParseJoinToGameRequest(std::string_view msg) {
+    RequestParser parser(msg);
+    auto* player_name = parser.GetString(json_keys::REQUEST_PLAYER_NAME);
+    auto* map_id = parser.GetString(json_keys::REQUEST_MAP_ID);
+    if(player_name == nullptr || map_id == nullptr) {
         return std::nullopt;
     }
+    return std::make_tuple(std::string(*player_name), model::Map::Id{std::string(*map_id)});
 };
 
-std::optional<std::string> ParsePlayerActionRequest(const std::string& msg) {
-    try {
-        json::value jv = json::parse(msg);
-        std::string direction = json::value_to<std::string>(jv.as_object().at(json_keys::REQUEST_PLAYER_MOVE));
-        return direction;
-    } catch(...) {
+std::optional<std::string> ParsePlayerActionRequest(std::string_view msg) {
+    RequestParser parser(msg);
+    auto* direction = parser.GetString(json_keys::REQUEST_PLAYER_MOVE);
+    if(direction == nullptr) {
         return std::nullopt;
     }
+    return std::string(*direction);
 };
 
-std::optional<int> ParseSetDeltaTimeRequest(const std::string& msg) {
-    try {
-        json::value jv = json::parse(msg);
-        if(!jv.as_object().at(json_keys::REQUEST_TIME_DELTA).is_int64()) {
-            return std::nullopt;
-        }
-        int time_delta = json::value_to<int>(jv.as_object().at(json_keys::REQUEST_TIME_DELTA));
-        return time_delta;
-    } catch(...) {
+std::optional<int> ParseSetDeltaTimeRequest(std::string_view msg) {
+    RequestParser parser(msg);
+    auto* time_delta = parser.Get(json_keys::REQUEST_TIME_DELTA);
+    if(time_delta == nullptr || !time_delta->is_int64()) {
+        return std::nullopt;
+    }
+    auto value = time_delta->get_int64();
+    if(value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
         return std::nullopt;
     }
+    return static_cast<int>(value);
 };
 
 
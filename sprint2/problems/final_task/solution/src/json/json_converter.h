@@ -2,6 +2,7 @@
 #include "application.h"
 
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <optional>
 
@@ -21,15 +22,16 @@ std::string CreateEmptyAuthorizationResponse();
 std::string CreateUnknownTokenResponse();
 std::string CreatePlayerActionResponse();
 std::string CreatePlayerActionInvalidActionResponse();
+std::string CreatePlayerActionQueueOverflowResponse();
 std::string CreateInvalidContentTypeResponse();
-std::string CreatePlayersListOnMapResponse(const std::vector< std::weak_ptr<app::Player> >& players);
-std::string CreateGameStateResponse(const std::vector< std::weak_ptr<app::Player> >& players);
+std::string CreatePlayersListOnMapResponse(const std::vector<app::PlayerState>& players);
+std::string CreateGameStateResponse(const std::vector<app::PlayerState>& players);
 std::string CreateSetDeltaTimeResponse();
 std::string CreateSetDeltaTimeInvalidMsgResponse();
 std::string CreateInvalidEndpointResponse();
 
 std::string CreateJoinToGameResponse(const std::string& token, size_t player_id);
-std::optional< std::tuple<std::string, model::Map::Id> > ParseJoinToGameRequest(const std::string& msg);
-std::optional<std::string> ParsePlayerActionRequest(const std::string& msg);
-std::optional<int> ParseSetDeltaTimeRequest(const std::string& msg);
+std::optional< std::tuple<std::string, model::Map::Id> > ParseJoinToGameRequest(std::string_view msg);
+std::optional<std::string> ParsePlayerActionRequest(std::string_view msg);
+std::optional<int> ParseSetDeltaTimeRequest(std::string_view msg);
 }
\ No newline at end of file
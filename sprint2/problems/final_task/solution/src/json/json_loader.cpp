@@ -1,12 +1,14 @@
 #include "json_loader.h"
 #include "logger.h"
+#include "map_artifact.h"
 #include "json_key_storage.h"
 #include "model_key_storage.h"
 
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <string_view>
-#include <sstream>
+#include <string>
 
 #include <iostream>
 
@@ -25,9 +27,11 @@ boost::json::value ReadFile(const std::filesystem::path& json_path) {
         throw OpenConfigFileOfModelException();
     }
     
-    std::stringstream ss;
-    ss << file.rdbuf();
-    boost::json::value root = boost::json::parse(ss.str());
+    // Файл читается целиком одним блоком, без промежуточного потока
+    std::string content(static_cast<size_t>(std::filesystem::file_size(json_path)), '\0');
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    content.resize(static_cast<size_t>(file.gcount()));
+    boost::json::value root = boost::json::parse(content);
     return root;
 };
 
@@ -38,12 +42,25 @@ model::Game LoadGame(const std::filesystem::path& json_path) {
     model::Game game;
     boost::json::value jsonVal = ReadFile(json_path);
     std::vector<model::Map> maps = boost::json::value_to< std::vector<model::Map> >(jsonVal.as_object().at(model::MAPS));
-    game.AddMaps(maps);
+    game.AddMaps(std::move(maps));
     try {
         double default_dog_velocity = boost::json::value_to<double>(jsonVal.as_object().at(model::DEFAULT_DOG_VELOCITY));
         game.SetDefaultDogVelocity(default_dog_velocity);
     } catch(...) {}
+    // Время простоя задается в секундах, без него игроки не уходят из игры
+    if(const auto* retirement_time_value = jsonVal.as_object().if_contains(model::DOG_RETIREMENT_TIME)) {
+        double retirement_time = boost::json::value_to<double>(*retirement_time_value);
+        game.SetDogRetirementTime(std::chrono::milliseconds(
+            static_cast<int64_t>(std::llround(retirement_time * model::MILLISECONDS_IN_SECOND))));
+    }
     return game;
 };
 
+model::Game LoadGame(const std::filesystem::path& json_path, const std::filesystem::path& artifact_path) {
+    if(auto game = map_artifact::LoadGame(artifact_path, map_artifact::HashConfigFile(json_path))) {
+        return std::move(*game);
+    }
+    return LoadGame(json_path);
+};
+
 }  // namespace json_loader
@@ -7,6 +7,8 @@
 namespace json_loader {
 
 model::Game LoadGame(const std::filesystem::path& json_path);
+// Карты берутся из артефакта, если он собран из того же файла конфигурации и не поврежден, иначе из самой конфигурации
+model::Game LoadGame(const std::filesystem::path& json_path, const std::filesystem::path& artifact_path);
 
 class OpenConfigFileOfModelException : public std::exception {
 public:
@@ -23,4 +23,9 @@ void tag_invoke(boost::json::value_from_tag, boost::json::value& jv, const ExitC
     jv = {{CODE, json::value_from(exit_code.code)}};
 };
 
+void tag_invoke(boost::json::value_from_tag, boost::json::value& jv, const MapArtifactLogData& map_artifact) {
+    jv = {{PATH, json::value_from(map_artifact.path)},
+            {TEXT, json::value_from(map_artifact.text)}};
+};
+
 }
\ No newline at end of file
@@ -11,7 +11,6 @@ namespace logware {
 namespace beast = boost::beast;
 namespace http = beast::http;
 namespace json = boost::json;
-using HttpRequest = http::request<http::string_body>;
 using namespace std::literals;
 
 
@@ -28,9 +27,11 @@ const std::string WHERE = "where";
 const std::string TIMESTAMP = "timestamp";
 const std::string DATA = "data";
 const std::string MESSAGE = "message";
+const std::string PATH = "path";
 
 struct RequestLogData {
-    RequestLogData(std::string ip_addr, const HttpRequest& req):
+    template <typename Body, typename Fields>
+    RequestLogData(std::string ip_addr, const http::request<Body, Fields>& req):
             ip(ip_addr),
             url(req.target()),
             method(req.method_string()) {};
@@ -91,6 +92,13 @@ struct ExitCodeLogData {
 
 void tag_invoke(boost::json::value_from_tag, boost::json::value& jv, ExitCodeLogData const& exit_code);
 
+struct MapArtifactLogData {
+    std::string path;
+    std::string_view text;
+};
+
+void tag_invoke(boost::json::value_from_tag, boost::json::value& jv, const MapArtifactLogData& map_artifact);
+
 template <class T>
 struct LogMessage{
     LogMessage(std::string_view msg, T&& custom_data):
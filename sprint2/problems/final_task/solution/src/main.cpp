@@ -7,10 +7,16 @@
 #include <filesystem>
 
 #include "json_loader.h"
+#include "map_artifact.h"
 #include "request_handler.h"
 #include "logger.h"
 #include "application.h"
 #include "program_options.h"
+#include "io_context_pool.h"
+#include "simulation_threads.h"
+#include "http_compression.h"
+#include "tick_engine.h"
+#include "random_generators.h"
 
 using namespace std::literals;
 namespace net = boost::asio;
@@ -32,6 +38,129 @@ void RunWorkers(size_t n, const Fn& fn) {
     fn();
 }
 
+const auto ADDRESS = net::ip::make_address("0.0.0.0");
+constexpr net::ip::port_type PORT = 8080;
+
+// Добавляет асинхронный обработчик сигналов SIGINT и SIGTERM
+template <typename StopFn>
+void HandleStopSignals(net::signal_set& signals, StopFn&& stop) {
+    signals.async_wait([stop = std::forward<StopFn>(stop)](const sys::error_code& ec, [[maybe_unused]] int signal_number) {
+        if (!ec) {
+            BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("server exited"sv,
+                                                                    logware::ExitCodeLogData(0));
+            stop();
+        }
+    });
+}
+
+time_m::TickerConfig MakeTickerConfig(const prog_opt::Args& args) {
+    time_m::TickerConfig config;
+    config.period = std::chrono::milliseconds(args.tick_period);
+    config.max_catch_up_steps = args.tick_max_catch_up_steps;
+    if(args.tick_catch_up == "steps"sv) {
+        config.catch_up_policy = time_m::CatchUpPolicy::FIXED_STEPS;
+    } else if(args.tick_catch_up == "coalesce"sv) {
+        config.catch_up_policy = time_m::CatchUpPolicy::COALESCE;
+    } else {
+        throw std::invalid_argument("Unknown tick catch-up policy: "s + args.tick_catch_up);
+    }
+    return config;
+}
+
+model::Game LoadGame(const prog_opt::Args& args) {
+    if(!args.maps_artifact.empty()) {
+        return json_loader::LoadGame(args.config_file, args.maps_artifact);
+    }
+    return json_loader::LoadGame(args.config_file);
+}
+
+void CompileMaps(const prog_opt::Args& args) {
+    model::Game game = json_loader::LoadGame(args.config_file);
+    map_artifact::SaveGame(game, map_artifact::HashConfigFile(args.config_file), args.compile_maps);
+    BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("map artifact compiled"sv,
+                                                            logware::MapArtifactLogData{args.compile_maps, args.config_file});
+}
+
+void ReportServerStarted() {
+    // Эта надпись сообщает тестам о том, что сервер запущен и готов обрабатывать запросы
+    BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("Server has started..."sv,
+                                                            logware::ServerAddressLogData(ADDRESS.to_string(), PORT));
+}
+
+// Общий io_context, который обслуживают все рабочие потоки
+void RunSharedIoContextServer(model::Game&& game, const prog_opt::Args& args,
+                            const fs::path& sc_root_path, const http_server::SessionConfig& session_config,
+                            unsigned num_threads) {
+    net::io_context ioc(num_threads);
+
+    http_server::SimulationThreads simulation(args.simulation_threads, args.pin_simulation_threads);
+    app::Application application(std::move(game), MakeTickerConfig(args), args.randomize_spawn_points,
+                                simulation.IsEnabled() ? simulation.GetIoContexts()
+                                                       : app::Application::IoContexts{std::ref(ioc)});
+
+    net::signal_set signals(ioc, SIGINT, SIGTERM);
+    HandleStopSignals(signals, [&ioc, &simulation] {
+        simulation.Stop();
+        ioc.stop();
+    });
+
+    // Создаём обработчик HTTP-запросов и связываем его с моделью игры, задаем путь до статического контента.
+    http_handler::RequestHandler handler{application, sc_root_path};
+
+    // Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
+    http_server::ServeHttp(ioc, {ADDRESS, PORT}, session_config, false, [&handler](auto&& req, auto&& send) {
+        handler(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
+    });
+    simulation.Start();
+    ReportServerStarted();
+
+    // Запускаем обработку асинхронных операций
+    RunWorkers(std::max(1u, num_threads), [&ioc] {
+        ioc.run();
+    });
+    simulation.Stop();
+}
+
+/*Каждый рабочий поток обслуживает свой io_context со своим acceptor'ом (SO_REUSEPORT)
+и своими соединениями. Игровые сеансы (их strand'ы и тикеры) распределяются по кругу
+по io_context'ам рабочих потоков или, если заданы потоки симуляции, по их io_context'ам.
+Обработчики попадают в сеанс через net::dispatch в его strand, а ответ возвращается
+в executor соединения. Закрепленные рабочие потоки занимают ядра, не отданные потокам симуляции.*/
+void RunIoContextPerThreadServer(model::Game&& game, const prog_opt::Args& args,
+                                const fs::path& sc_root_path, const http_server::SessionConfig& session_config,
+                                unsigned num_threads) {
+    http_server::IoContextPool pool(num_threads);
+    http_server::SimulationThreads simulation(args.simulation_threads, args.pin_simulation_threads);
+
+    app::Application::IoContexts session_contexts = simulation.GetIoContexts();
+    if(!simulation.IsEnabled()) {
+        for(size_t i = 0; i < pool.Size(); ++i) {
+            session_contexts.push_back(std::ref(pool.GetIoContext(i)));
+        }
+    }
+    app::Application application(std::move(game), MakeTickerConfig(args), args.randomize_spawn_points,
+                                std::move(session_contexts));
+
+    net::signal_set signals(pool.GetIoContext(0), SIGINT, SIGTERM);
+    HandleStopSignals(signals, [&pool, &simulation] {
+        simulation.Stop();
+        pool.Stop();
+    });
+
+    // Обработчик не хранит состояния потока, поэтому один на все io_context'ы
+    http_handler::RequestHandler handler{application, sc_root_path};
+    for(size_t i = 0; i < pool.Size(); ++i) {
+        http_server::ServeHttp(pool.GetIoContext(i), {ADDRESS, PORT}, session_config, true, [&handler](auto&& req, auto&& send) {
+            handler(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
+        });
+    }
+    simulation.Start();
+    ReportServerStarted();
+
+    pool.Run(args.pin_threads, 0, http_server::GetNetworkCpuCount(args.simulation_threads));
+    simulation.Stop();
+}
+
 }  // namespace
 
 int main(int argc, const char* argv[]) {
@@ -39,48 +168,40 @@ int main(int argc, const char* argv[]) {
     logware::InitLogger();
     prog_opt::Args args = prog_opt::ParseCommandLine(argc, argv);
     try {
+        if(!args.compile_maps.empty()) {
+            CompileMaps(args);
+            return EXIT_SUCCESS;
+        }
         // 1. Загружаем карту из файла и построить модель игры
-        model::Game game = json_loader::LoadGame(args.config_file);
+        model::Game game = LoadGame(args);
         //model::Game game = json_loader::LoadGame("../../data/config.json"); // for debug
+        // Карты после загрузки не меняются, поэтому ответы с ними и постоянные ответы API сериализуем заранее
+        rh_storage::ResponseCache::GetInstance().Build(game.GetMaps());
 
         // 2. Устанавливаем путь до статического контента.
         fs::path sc_root_path{args.www_root};
         //fs::path sc_root_path{"../../static"};
 
-        // 3. Инициализируем io_context
-        const unsigned num_threads = std::thread::hardware_concurrency();
-        net::io_context ioc(num_threads);
-
-        app::Application application(std::move(game), args.tick_period, args.randomize_spawn_points, ioc);
-
-        // 4. Добавляем асинхронный обработчик сигналов SIGINT и SIGTERM
-        net::signal_set signals(ioc, SIGINT, SIGTERM);
-        signals.async_wait([&ioc](const sys::error_code& ec, [[maybe_unused]] int signal_number) {
-            if (!ec) {
-                BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("server exited"sv,
-                                                                        logware::ExitCodeLogData(0));
-                ioc.stop();
-            }
-        });
+        // 3. Задаем параметры соединений и количество рабочих потоков
+        http_server::SessionConfig session_config;
+        session_config.idle_timeout = std::chrono::seconds(args.idle_timeout);
+        session_config.max_requests_per_connection = args.max_requests_per_connection;
+        utils::ResponseCompressor::GetInstance().Configure({args.compression, args.compression_level,
+                                                            args.compression_min_size});
+        app::TickEngine::GetInstance().Configure({args.tick_threads, args.tick_batch_size});
+        if(args.random_seed) {
+            utils::RandomService::GetInstance().SetSeed(*args.random_seed);
+        }
+        // По умолчанию сетевые потоки занимают ядра, не отданные потокам симуляции
+        const unsigned num_threads = static_cast<unsigned>(
+            args.threads != 0 ? args.threads : http_server::GetNetworkCpuCount(args.simulation_threads));
 
-        // 5. Создаём обработчик HTTP-запросов и связываем его с моделью игры, задаем путь до статического контента.
-        http_handler::RequestHandler handler{application, sc_root_path, ioc};
-
-        // 6. Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
-        const auto address = net::ip::make_address("0.0.0.0");
-        constexpr net::ip::port_type port = 8080;
-        http_server::ServeHttp(ioc, {address, port}, [&handler](auto&& req, auto&& send) {
-            handler(std::forward<decltype(req)>(req), std::forward<decltype(send)>(send));
-        });
-        
-        // Эта надпись сообщает тестам о том, что сервер запущен и готов обрабатывать запросы
-        BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("Server has started..."sv,
-                                                                logware::ServerAddressLogData(address.to_string(), port));
-
-        // 7. Запускаем обработку асинхронных операций
-        RunWorkers(std::max(1u, num_threads), [&ioc] {
-            ioc.run();
-        });
+        // 4. Запускаем сервер в выбранном режиме
+        if(args.io_context_per_thread) {
+            RunIoContextPerThreadServer(std::move(game), args, sc_root_path, session_config, num_threads);
+        } else {
+            RunSharedIoContextServer(std::move(game), args, sc_root_path, session_config, num_threads);
+        }
     } catch (const std::exception& ex) {
         BOOST_LOG_TRIVIAL(error) << logware::CreateLogMessage("error"sv,
                                         logware::ExceptionLogData(EXIT_FAILURE, "Server down"sv, ex.what()));
@@ -0,0 +1,99 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace metrics {
+
+Histogram::Histogram(std::vector<double> bounds) :
+        bounds_(std::move(bounds)),
+        buckets_(std::make_unique< std::atomic<uint64_t>[] >(bounds_.size() + 1)) {
+    std::sort(bounds_.begin(), bounds_.end());
+};
+
+void Histogram::Observe(double value) noexcept {
+    auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+};
+
+template <typename Metric, typename... Args>
+Metric& Registry::GetOrCreate(std::map< std::string, Entry<Metric> >& storage,
+                              const std::string& name,
+                              const std::string& help,
+                              Args&&... args) {
+    auto& entry = storage[name];
+    if(!entry.metric) {
+        entry.help = help;
+        entry.metric = std::make_unique<Metric>(std::forward<Args>(args)...);
+    }
+    return *entry.metric;
+};
+
+template <typename Metric>
+void Registry::SerializeMetrics(std::ostream& out,
+                                const std::map< std::string, Entry<Metric> >& storage,
+                                std::string_view type) {
+    for(const auto& [name, entry] : storage) {
+        out << "# HELP " << name << ' ' << entry.help << '\n';
+        out << "# TYPE " << name << ' ' << type << '\n';
+        out << name << ' ' << entry.metric->Get() << '\n';
+    }
+};
+
+void Registry::SerializeHistograms(std::ostream& out,
+                                   const std::map< std::string, Entry<Histogram> >& storage) {
+    for(const auto& [name, entry] : storage) {
+        const auto& histogram = *entry.metric;
+        out << "# HELP " << name << ' ' << entry.help << '\n';
+        out << "# TYPE " << name << " histogram\n";
+        uint64_t cumulative = 0;
+        for(size_t i = 0; i < histogram.GetBounds().size(); ++i) {
+            cumulative += histogram.GetBucketCount(i);
+            out << name << "_bucket{le=\"" << histogram.GetBounds()[i] << "\"} " << cumulative << '\n';
+        }
+        cumulative += histogram.GetBucketCount(histogram.GetBounds().size());
+        out << name << "_bucket{le=\"+Inf\"} " << cumulative << '\n';
+        out << name << "_sum " << histogram.GetSum() << '\n';
+        out << name << "_count " << histogram.GetCount() << '\n';
+    }
+};
+
+Registry& Registry::GetInstance() {
+    static Registry obj;
+    return obj;
+};
+
+Counter& Registry::GetCounter(const std::string& name, const std::string& help) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(counters_, name, help);
+};
+
+CounterFunction& Registry::GetCounterFunction(const std::string& name, const std::string& help,
+                                              std::function<uint64_t()> read) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(counter_functions_, name, help, std::move(read));
+};
+
+Gauge& Registry::GetGauge(const std::string& name, const std::string& help) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(gauges_, name, help);
+};
+
+Histogram& Registry::GetHistogram(const std::string& name, const std::string& help, std::vector<double> bounds) {
+    std::lock_guard lock{mutex_};
+    return GetOrCreate(histograms_, name, help, std::move(bounds));
+};
+
+std::string Registry::Serialize() const {
+    std::lock_guard lock{mutex_};
+    std::ostringstream out;
+    SerializeMetrics(out, counters_, "counter");
+    SerializeMetrics(out, counter_functions_, "counter");
+    SerializeMetrics(out, gauges_, "gauge");
+    SerializeHistograms(out, histograms_);
+    return out.str();
+};
+
+}  // namespace metrics
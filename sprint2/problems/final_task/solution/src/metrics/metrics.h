@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace metrics {
+
+// Монотонно возрастающий счетчик. Безопасен для использования из любого потока
+class Counter {
+public:
+    void Add(uint64_t value = 1) noexcept {
+        value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/*Счетчик, значение которого вычисляется при чтении. Подходит для счетчиков, которые
+увеличиваются на горячем пути без атомарных операций, например раздельно в каждом потоке,
+и суммируются только при выдаче метрик*/
+class CounterFunction {
+public:
+    explicit CounterFunction(std::function<uint64_t()> read)
+        : read_(std::move(read)) {
+    }
+
+    uint64_t Get() const {
+        return read_();
+    }
+
+private:
+    std::function<uint64_t()> read_;
+};
+
+// Текущее значение величины, которая может как расти, так и уменьшаться
+class Gauge {
+public:
+    void Set(int64_t value) noexcept {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void Add(int64_t value) noexcept {
+        value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    int64_t Get() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/*Распределение наблюдаемых величин по корзинам с заданными верхними границами.
+Корзины не накопительные, суммы по возрастающим границам считаются при выдаче.
+Безопасна для использования из любого потока*/
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void Observe(double value) noexcept;
+
+    const std::vector<double>& GetBounds() const noexcept {
+        return bounds_;
+    }
+    // Количество наблюдений в корзине index. Последняя корзина - значения больше всех границ
+    uint64_t GetBucketCount(size_t index) const noexcept {
+        return buckets_[index].load(std::memory_order_relaxed);
+    }
+    uint64_t GetCount() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+    double GetSum() const noexcept {
+        return sum_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr< std::atomic<uint64_t>[] > buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double> sum_{0.0};
+};
+
+/*Реестр метрик сервера. Метрики создаются один раз (обычно при инициализации статических
+переменных) и живут до завершения программы, поэтому ссылки на них можно хранить.
+Значения выдаются в текстовом формате Prometheus.*/
+class Registry {
+public:
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+    Registry(Registry&&) = delete;
+    Registry& operator=(Registry&&) = delete;
+
+    // получение ссылки на единственный объект
+    static Registry& GetInstance();
+
+    Counter& GetCounter(const std::string& name, const std::string& help);
+    // Функция вызывается при каждой выдаче метрик. Повторная регистрация имени ничего не меняет
+    CounterFunction& GetCounterFunction(const std::string& name, const std::string& help,
+                                        std::function<uint64_t()> read);
+    Gauge& GetGauge(const std::string& name, const std::string& help);
+    // Границы корзин задаются при первом обращении к гистограмме
+    Histogram& GetHistogram(const std::string& name, const std::string& help, std::vector<double> bounds);
+
+    std::string Serialize() const;
+
+private:
+    template <typename Metric>
+    struct Entry {
+        std::string help;
+        std::unique_ptr<Metric> metric;
+    };
+
+    mutable std::mutex mutex_;
+    std::map< std::string, Entry<Counter> > counters_;
+    std::map< std::string, Entry<CounterFunction> > counter_functions_;
+    std::map< std::string, Entry<Gauge> > gauges_;
+    std::map< std::string, Entry<Histogram> > histograms_;
+
+    Registry() = default;
+
+    template <typename Metric, typename... Args>
+    static Metric& GetOrCreate(std::map< std::string, Entry<Metric> >& storage,
+                               const std::string& name,
+                               const std::string& help,
+                               Args&&... args);
+    template <typename Metric>
+    static void SerializeMetrics(std::ostream& out,
+                                 const std::map< std::string, Entry<Metric> >& storage,
+                                 std::string_view type);
+    static void SerializeHistograms(std::ostream& out,
+                                    const std::map< std::string, Entry<Histogram> >& storage);
+};
+
+}  // namespace metrics
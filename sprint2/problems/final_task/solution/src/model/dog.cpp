@@ -3,35 +3,39 @@
 namespace model {
 
 const Dog::Id& Dog::GetId() const {
-    return id_;
+    return store_->GetId(handle_);
 };
 
 const std::string& Dog::GetName() const {
-    return name_;
+    return store_->GetName(handle_);
+};
+
+DogStore::Handle Dog::GetHandle() const noexcept {
+    return handle_;
 };
 
 void Dog::SetDirection(Direction direction) {
-    direction_ = std::move(direction);
+    store_->SetDirection(handle_, direction);
 };
 
 const Direction Dog::GetDirection() const {
-    return direction_;
+    return store_->GetDirection(handle_);
 };
 
 void Dog::SetPosition(Position position) {
-    position_ = std::move(position);
+    store_->SetPosition(handle_, position);
 };
 
 const Position& Dog::GetPosition() const {
-    return position_;
+    return store_->GetPosition(handle_);
 };
 
 void Dog::SetVelocity(Velocity velocity) {
-    velocity_ = velocity;
+    store_->SetVelocity(handle_, velocity);
 };
 
 const Velocity& Dog::GetVelocity() const {
-    return velocity_;
+    return store_->GetVelocity(handle_);
 };
 
 void Dog::SetAction(Direction direction, double velocity) {
@@ -63,7 +67,7 @@ void Dog::SetAction(Direction direction, double velocity) {
     }
 };
 
-Position Dog::CalculateNewPosition(const std::chrono::milliseconds& delta_time) {
+Position Dog::CalculateNewPosition(const std::chrono::milliseconds& delta_time) const {
     Position position = GetPosition();
     const Velocity& velocity = GetVelocity();
     position.x += velocity.vx * delta_time.count() / MILLISECONDS_IN_SECOND;
@@ -1,6 +1,7 @@
 #pragma once
 #include "tagged.h"
 #include "support_types.h"
+#include "dog_store.h"
 
 #include <string>
 #include <unordered_map>
@@ -8,25 +9,17 @@
 
 namespace model {
 
-
+// Собака из хранилища сеанса. Не владеет состоянием и действительна, пока собака есть в хранилище
 class Dog {
-    inline static size_t max_id_cont_ = 0;
 public:
-    using Id = util::Tagged<size_t, Dog>;
-    Dog(std::string name) : 
-        id_(Id{Dog::max_id_cont_++}),
-        name_(name) {};
-    Dog(Id id, std::string name) :
-        id_(id),
-        name_(name) {};
-    Dog(const Dog& other) = default;
-    Dog(Dog&& other) = default;
-    Dog& operator = (const Dog& other) = default;
-    Dog& operator = (Dog&& other) = default;
-    virtual ~Dog() = default;
+    using Id = DogStore::Id;
+    Dog(DogStore& store, DogStore::Handle handle) noexcept :
+        store_(&store),
+        handle_(handle) {};
 
     const Id& GetId() const;
     const std::string& GetName() const;
+    DogStore::Handle GetHandle() const noexcept;
 
     void SetDirection(Direction direction);
     const Direction GetDirection() const;
@@ -38,13 +31,10 @@ public:
     const Velocity& GetVelocity() const;
     
     void SetAction(Direction direction, double velocity);
-    Position CalculateNewPosition(const std::chrono::milliseconds& delta_time);
+    Position CalculateNewPosition(const std::chrono::milliseconds& delta_time) const;
 private:
-    Id id_;
-    std::string name_;
-    Direction direction_{Direction::NORTH};
-    Position position_{0.0, 0.0};
-    Velocity velocity_{0.0, 0.0};
+    DogStore* store_;
+    DogStore::Handle handle_;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,117 @@
+#include "dog_store.h"
+#include "map.h"
+
+#include <stdexcept>
+
+namespace model {
+
+DogStore::Handle DogStore::Add(std::string name) {
+    Handle handle;
+    if(!free_handles_.empty()) {
+        handle = free_handles_.back();
+        free_handles_.pop_back();
+        indices_[handle] = positions_.size();
+    } else {
+        handle = indices_.size();
+        indices_.push_back(positions_.size());
+    }
+    handles_.push_back(handle);
+    positions_.push_back({0.0, 0.0});
+    velocities_.push_back({0.0, 0.0});
+    directions_.push_back(Direction::NORTH);
+    ids_.push_back(Id{max_id_cont_.fetch_add(1, std::memory_order_relaxed)});
+    names_.push_back(std::move(name));
+    return handle;
+};
+
+void DogStore::Remove(Handle handle) {
+    const size_t index = GetIndex(handle);
+    const size_t last = positions_.size() - 1;
+    if(index != last) {
+        positions_[index] = positions_[last];
+        velocities_[index] = velocities_[last];
+        directions_[index] = directions_[last];
+        ids_[index] = ids_[last];
+        names_[index] = std::move(names_[last]);
+        handles_[index] = handles_[last];
+        indices_[handles_[index]] = index;
+    }
+    positions_.pop_back();
+    velocities_.pop_back();
+    directions_.pop_back();
+    ids_.pop_back();
+    names_.pop_back();
+    handles_.pop_back();
+    indices_[handle] = REMOVED;
+    free_handles_.push_back(handle);
+};
+
+bool DogStore::Contains(Handle handle) const noexcept {
+    return handle < indices_.size() && indices_[handle] != REMOVED;
+};
+
+size_t DogStore::Size() const noexcept {
+    return positions_.size();
+};
+
+const DogStore::Id& DogStore::GetId(Handle handle) const {
+    return ids_[GetIndex(handle)];
+};
+
+const std::string& DogStore::GetName(Handle handle) const {
+    return names_[GetIndex(handle)];
+};
+
+Direction DogStore::GetDirection(Handle handle) const {
+    return directions_[GetIndex(handle)];
+};
+
+void DogStore::SetDirection(Handle handle, Direction direction) {
+    directions_[GetIndex(handle)] = direction;
+};
+
+const Position& DogStore::GetPosition(Handle handle) const {
+    return positions_[GetIndex(handle)];
+};
+
+void DogStore::SetPosition(Handle handle, Position position) {
+    positions_[GetIndex(handle)] = position;
+};
+
+const Velocity& DogStore::GetVelocity(Handle handle) const {
+    return velocities_[GetIndex(handle)];
+};
+
+void DogStore::SetVelocity(Handle handle, Velocity velocity) {
+    velocities_[GetIndex(handle)] = velocity;
+};
+
+void DogStore::Move(const Map& map, const std::chrono::milliseconds& delta_time, size_t begin, size_t end,
+                    std::vector<Handle>* stopped) {
+    for(size_t i = begin; i < end; ++i) {
+        const Position& position = positions_[i];
+        const Velocity& velocity = velocities_[i];
+        // Стоящая на дороге собака остается на месте, проверять ее ход по карте не нужно
+        if(velocity.vx == 0 && velocity.vy == 0) {
+            continue;
+        }
+        // То же выражение, что в Dog::CalculateNewPosition: координаты совпадают до последнего бита
+        const Position target{position.x + velocity.vx * delta_time.count() / MILLISECONDS_IN_SECOND,
+                              position.y + velocity.vy * delta_time.count() / MILLISECONDS_IN_SECOND};
+        auto [new_position, new_velocity] = map.GetValidMove(position, target, velocity);
+        positions_[i] = new_position;
+        velocities_[i] = new_velocity;
+        if(stopped && new_velocity.vx == 0 && new_velocity.vy == 0) {
+            stopped->push_back(handles_[i]);
+        }
+    }
+};
+
+size_t DogStore::GetIndex(Handle handle) const {
+    if(!Contains(handle)) {
+        throw std::out_of_range("Dog handle is not in the store");
+    }
+    return indices_[handle];
+};
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "tagged.h"
+#include "support_types.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace model {
+
+class Dog;
+class Map;
+
+/*Собаки игрового сеанса. Идентификаторы, позиции, скорости и направления лежат в отдельных
+непрерывных массивах, поэтому перемещение на тике последовательно проходит по памяти, а не
+по цепочке указателей. Собака доступна по дескриптору, который не меняется при удалении
+других собак. Дескрипторы удаленных собак переиспользуются, поэтому память хранилища
+ограничена наибольшим числом собак одновременно. Хранилище не синхронизировано: им пользуется только strand сеанса, а Move
+для непересекающихся диапазонов можно вызывать из нескольких потоков одновременно.*/
+class DogStore {
+    // Собаки создаются в strand'ах разных игровых сеансов
+    inline static std::atomic<size_t> max_id_cont_ = 0;
+public:
+    using Id = util::Tagged<size_t, Dog>;
+    using Handle = size_t;
+
+    DogStore() = default;
+    DogStore(const DogStore& other) = delete;
+    DogStore& operator = (const DogStore& other) = delete;
+
+    Handle Add(std::string name);
+    // Последняя собака переносится на место удаленной, дескрипторы остальных не меняются
+    void Remove(Handle handle);
+    bool Contains(Handle handle) const noexcept;
+    size_t Size() const noexcept;
+
+    const Id& GetId(Handle handle) const;
+    const std::string& GetName(Handle handle) const;
+    Direction GetDirection(Handle handle) const;
+    void SetDirection(Handle handle, Direction direction);
+    const Position& GetPosition(Handle handle) const;
+    void SetPosition(Handle handle, Position position);
+    const Velocity& GetVelocity(Handle handle) const;
+    void SetVelocity(Handle handle, Velocity velocity);
+
+    /*Перемещает собак с номерами [begin, end) в порядке хранения (не дескрипторами).
+    Дескрипторы собак, остановившихся на этом ходу, добавляются в stopped, если он задан*/
+    void Move(const Map& map, const std::chrono::milliseconds& delta_time, size_t begin, size_t end,
+                std::vector<Handle>* stopped = nullptr);
+
+private:
+    static constexpr size_t REMOVED = std::numeric_limits<size_t>::max();
+
+    // Горячие массивы, которые читает и пишет перемещение
+    std::vector<Position> positions_;
+    std::vector<Velocity> velocities_;
+    // Холодные массивы, нужные только API
+    std::vector<Direction> directions_;
+    std::vector<Id> ids_;
+    std::vector<std::string> names_;
+    // Номер в массивах -> дескриптор и дескриптор -> номер в массивах
+    std::vector<Handle> handles_;
+    std::vector<size_t> indices_;
+    std::vector<Handle> free_handles_;
+
+    size_t GetIndex(Handle handle) const;
+};
+
+}
@@ -7,13 +7,15 @@ namespace model {
 
 using namespace std::literals;
 
-void Game::AddMap(const Map& map) {
+void Game::AddMap(Map map) {
     const size_t index = maps_.size();
     if (auto [it, inserted] = map_id_to_index_.emplace(map.GetId(), index); !inserted) {
         throw std::invalid_argument("Map with id "s + *map.GetId() + " already exists"s);
     } else {
         try {
-            auto current_map = std::make_shared<Map>(map);
+            // Карта игры только читается, поэтому индекс дорог достраивается до публикации
+            map.BuildIndex();
+            auto current_map = std::make_shared<Map>(std::move(map));
             if(!(std::abs(default_dog_velocity_ - INITIAL_DOG_VELOCITY) < EPSILON) &&
                 std::abs(current_map->GetDogVelocity() - INITIAL_DOG_VELOCITY) < EPSILON) {
                 current_map->SetDogVelocity(default_dog_velocity_);
@@ -26,9 +28,9 @@ void Game::AddMap(const Map& map) {
     }
 }
 
-void Game::AddMaps(const std::vector<Map>& maps){
-    for(auto item : maps){
-        AddMap(item);
+void Game::AddMaps(std::vector<Map> maps){
+    for(auto& item : maps){
+        AddMap(std::move(item));
     }
 };
 
@@ -59,4 +61,12 @@ double Game::GetDefaultDogVelocity() const noexcept {
     return default_dog_velocity_;
 };
 
+void Game::SetDogRetirementTime(std::chrono::milliseconds retirement_time) {
+    dog_retirement_time_ = retirement_time;
+};
+
+std::optional<std::chrono::milliseconds> Game::GetDogRetirementTime() const noexcept {
+    return dog_retirement_time_;
+};
+
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <chrono>
+#include <optional>
 
 namespace model {
 
@@ -12,12 +13,15 @@ class Game {
 public:
     using Maps = std::vector< std::shared_ptr<Map> >;
 
-    void AddMap(const Map& map);
-    void AddMaps(const std::vector<Map>& maps);
+    void AddMap(Map map);
+    void AddMaps(std::vector<Map> maps);
     const Maps& GetMaps() const noexcept;
     const std::shared_ptr<Map> FindMap(const Map::Id& id) const noexcept;
     void SetDefaultDogVelocity(double velocity);
     double GetDefaultDogVelocity() const noexcept;
+    void SetDogRetirementTime(std::chrono::milliseconds retirement_time);
+    // Пустое значение - игроки не уходят из игры по простою
+    std::optional<std::chrono::milliseconds> GetDogRetirementTime() const noexcept;
 
 private:
     using MapIdHasher = util::TaggedHasher<Map::Id>;
@@ -26,6 +30,7 @@ private:
     std::vector< std::shared_ptr<Map> > maps_;
     MapIdToIndex map_id_to_index_;
     double default_dog_velocity_{INITIAL_DOG_VELOCITY};
+    std::optional<std::chrono::milliseconds> dog_retirement_time_;
 };
 
 }
\ No newline at end of file
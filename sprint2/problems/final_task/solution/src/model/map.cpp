@@ -28,14 +28,36 @@ const Map::Offices& Map::GetOffices() const noexcept {
     return offices_;
 }
 
+const Roadmap& Map::GetRoadmap() const noexcept {
+    return roadmap_;
+}
+
+const SpawnSampler& Map::GetSpawnSampler() const noexcept {
+    return spawn_sampler_;
+}
+
+void Map::SetRoadmap(Roadmap roadmap) {
+    roadmap_ = std::move(roadmap);
+    spawn_sampler_ = SpawnSampler(roadmap_.GetRoads());
+}
+
+// Таблица выбора точек появления, как и индекс дорог, строится в BuildIndex, а не на каждую дорогу
 void Map::AddRoad(const Road& road) {
     roadmap_.AddRoad(road);
 }
 
 void Map::AddRoads(const Roads& roads){
-    for(auto item : roads){
-        AddRoad(item);
+    roadmap_.AddRoads(roads);
+    spawn_sampler_ = SpawnSampler(roadmap_.GetRoads());
+}
+
+// Индекс дорог сбрасывается при добавлении дороги, поэтому по нему видно, устарела ли и таблица
+void Map::BuildIndex() {
+    if(roadmap_.IsIndexed()) {
+        return;
     }
+    roadmap_.BuildIndex();
+    spawn_sampler_ = SpawnSampler(roadmap_.GetRoads());
 }
 
 void Map::AddBuilding(const Building& building) {
@@ -43,7 +65,7 @@ void Map::AddBuilding(const Building& building) {
 }
 
 void Map::AddBuildings(const Buildings& buildings){
-    for(auto item : buildings){
+    for(const auto& item : buildings){
         AddBuilding(item);
     }
 }
@@ -65,7 +87,7 @@ void Map::AddOffice(const Office& office) {
 }
 
 void Map::AddOffices(const Offices& offices){
-    for(auto item : offices){
+    for(const auto& item : offices){
         AddOffice(item);
     }
 }
@@ -80,7 +102,7 @@ double Map::GetDogVelocity() const noexcept {
 
 std::tuple<Position, Velocity> Map::GetValidMove(const Position& old_position,
                                                 const Position& potential_new_position,
-                                                const Velocity& old_velocity) {
+                                                const Velocity& old_velocity) const {
     return roadmap_.GetValidMove(old_position, potential_new_position, old_velocity);
 };
 
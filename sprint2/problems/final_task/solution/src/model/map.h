@@ -4,6 +4,7 @@
 #include "building.h"
 #include "office.h"
 #include "roadmap.h"
+#include "spawn_sampler.h"
 #include "support_types.h"
 
 
@@ -38,8 +39,16 @@ public:
     const Buildings& GetBuildings() const noexcept;
     const Roads& GetRoads() const noexcept;
     const Offices& GetOffices() const noexcept;
+    const Roadmap& GetRoadmap() const noexcept;
+    // Выбор точек появления на дорогах, строится вместе с индексом дорог
+    const SpawnSampler& GetSpawnSampler() const noexcept;
+    // Готовая карта дорог, например загруженная из артефакта карт, заменяет добавленные дороги
+    void SetRoadmap(Roadmap roadmap);
+    /*После AddRoad перемещения по карте и выбор точек появления возможны только после BuildIndex.
+    AddRoads и Game::AddMap строят индекс сами*/
     void AddRoad(const Road& road);
     void AddRoads(const Roads& roads);
+    void BuildIndex();
     void AddBuilding(const Building& building);
     void AddBuildings(const Buildings& buildings);
     void AddOffice(const Office& office);
@@ -48,7 +57,7 @@ public:
     double GetDogVelocity() const noexcept;
     std::tuple<Position, Velocity> GetValidMove(const Position& old_position,
                             const Position& potential_new_position,
-                            const Velocity& old_velocity);
+                            const Velocity& old_velocity) const;
 
 private:
     using OfficeIdToIndex = std::unordered_map<Office::Id, size_t, util::TaggedHasher<Office::Id>>;
@@ -56,6 +65,7 @@ private:
     Id id_;
     std::string name_;
     Roadmap roadmap_;
+    SpawnSampler spawn_sampler_;
     Buildings buildings_;
 
     OfficeIdToIndex warehouse_id_to_index_;
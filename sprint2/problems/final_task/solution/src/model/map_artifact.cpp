@@ -0,0 +1,424 @@
+#include "map_artifact.h"
+#include "logger.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace map_artifact {
+
+using namespace std::literals;
+namespace fs = std::filesystem;
+namespace ipc = boost::interprocess;
+
+namespace {
+
+/*Раскладка файла: заголовок, затем содержимое. Содержимое начинается с записей карт, за ними идут
+разделы дорог, зданий, офисов, линий индекса дорог с их отрезками и строк. Записи имеют
+фиксированный размер, кратный 8 байтам, разделы выровнены на 8 байт, а ссылки на разделы - это
+смещения от начала содержимого. Поэтому отображенный в память файл читается без разбора текста,
+но записи копируются в объекты модели: сервер не обращается к отображению после загрузки.
+Порядок байт родной для машины, сборки с другим порядком отличаются по метке.*/
+
+const std::array<char, 8> MAGIC{'G', 'S', 'M', 'A', 'P', 'S', '\0', '\0'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const int64_t NO_RETIREMENT_TIME = -1;
+const uint64_t ALIGNMENT = 8;
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+struct Header {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t byte_order_mark;
+    uint64_t config_hash;
+    uint64_t payload_size;
+    uint32_t payload_checksum;
+    uint32_t maps_count;
+    double default_dog_velocity;
+    int64_t dog_retirement_time_ms;
+};
+
+// Участок содержимого: смещение и число элементов, для строк - байт
+struct SectionRef {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct MapRecord {
+    SectionRef id;
+    SectionRef name;
+    double dog_velocity;
+    uint64_t reserved;
+    SectionRef roads;
+    SectionRef buildings;
+    SectionRef offices;
+    SectionRef lines;
+};
+
+struct RoadRecord {
+    int32_t start_x;
+    int32_t start_y;
+    int32_t end_x;
+    int32_t end_y;
+};
+
+struct BuildingRecord {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+};
+
+struct OfficeRecord {
+    SectionRef id;
+    int32_t x;
+    int32_t y;
+    int32_t offset_x;
+    int32_t offset_y;
+};
+
+struct LineRecord {
+    int64_t line_coord;
+    uint32_t horizontal;
+    uint32_t reserved;
+    SectionRef spans;
+};
+
+struct SpanRecord {
+    int64_t begin;
+    int64_t end;
+    int64_t max_end;
+    uint64_t road;
+};
+
+template <typename T>
+constexpr bool IS_RECORD = std::is_trivially_copyable_v<T> && sizeof(T) % ALIGNMENT == 0 && alignof(T) <= ALIGNMENT;
+
+static_assert(IS_RECORD<Header> && IS_RECORD<MapRecord> && IS_RECORD<RoadRecord> && IS_RECORD<BuildingRecord> &&
+              IS_RECORD<OfficeRecord> && IS_RECORD<LineRecord> && IS_RECORD<SpanRecord>);
+
+uint32_t CalculateChecksum(const char* data, size_t size) {
+    return static_cast<uint32_t>(crc32_z(crc32_z(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data), size));
+}
+
+// Собирает содержимое артефакта в памяти
+class PayloadWriter {
+public:
+    template <typename T>
+    SectionRef Append(std::span<const T> items) {
+        static_assert(IS_RECORD<T> || std::is_same_v<T, char>);
+        const uint64_t offset = data_.size();
+        const auto* bytes = reinterpret_cast<const char*>(items.data());
+        data_.insert(data_.end(), bytes, bytes + items.size_bytes());
+        data_.resize((data_.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, '\0');
+        return {offset, items.size()};
+    }
+
+    SectionRef AppendString(std::string_view str) {
+        return Append(std::span<const char>(str.data(), str.size()));
+    }
+
+    template <typename T>
+    void Overwrite(uint64_t offset, const T& item) {
+        std::memcpy(data_.data() + offset, &item, sizeof(T));
+    }
+
+    const std::vector<char>& GetData() const noexcept {
+        return data_;
+    }
+
+private:
+    std::vector<char> data_;
+};
+
+// Читает разделы отображенного в память содержимого, проверяя их границы
+class PayloadReader {
+public:
+    PayloadReader(const char* data, uint64_t size) noexcept :
+            data_(data), size_(size) {
+    }
+
+    template <typename T>
+    std::span<const T> GetSection(SectionRef ref) const {
+        if(ref.offset % ALIGNMENT != 0 || ref.offset > size_ || ref.count > (size_ - ref.offset) / sizeof(T)) {
+            throw MapArtifactException("section is out of file bounds");
+        }
+        return {reinterpret_cast<const T*>(data_ + ref.offset), static_cast<size_t>(ref.count)};
+    }
+
+    std::string GetString(SectionRef ref) const {
+        auto chars = GetSection<char>(ref);
+        return {chars.begin(), chars.end()};
+    }
+
+private:
+    const char* data_;
+    uint64_t size_;
+};
+
+// Дескриптор файла, закрываемый при выходе из области видимости
+class FileDescriptor {
+public:
+    FileDescriptor(const fs::path& path, int flags, mode_t mode = 0) :
+            fd_(::open(path.c_str(), flags | O_CLOEXEC, mode)) {
+        if(fd_ < 0) {
+            throw MapArtifactException("Can't open "s + path.string());
+        }
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator = (const FileDescriptor&) = delete;
+
+    ~FileDescriptor() {
+        ::close(fd_);
+    }
+
+    int Get() const noexcept {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+void WriteAll(const FileDescriptor& file, const char* data, size_t size, const fs::path& path) {
+    while(size > 0) {
+        const ssize_t written = ::write(file.Get(), data, size);
+        if(written < 0 && errno == EINTR) {
+            continue;
+        }
+        if(written <= 0) {
+            throw MapArtifactException("Can't write map artifact "s + path.string());
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void Sync(const FileDescriptor& file, const fs::path& path) {
+    if(::fsync(file.Get()) != 0) {
+        throw MapArtifactException("Can't sync "s + path.string());
+    }
+}
+
+// Запись каталога о файле переживает сбой питания только после fsync самого каталога
+void SyncDirectory(const fs::path& dir) {
+    const fs::path path = dir.empty() ? fs::path(".") : dir;
+    Sync(FileDescriptor(path, O_RDONLY | O_DIRECTORY), path);
+}
+
+MapRecord WriteMap(const model::Map& map, PayloadWriter& writer) {
+    MapRecord record{};
+    record.id = writer.AppendString(*map.GetId());
+    record.name = writer.AppendString(map.GetName());
+    record.dog_velocity = map.GetDogVelocity();
+
+    std::vector<RoadRecord> roads;
+    roads.reserve(map.GetRoads().size());
+    for(const auto& road : map.GetRoads()) {
+        roads.push_back({road.GetStart().x, road.GetStart().y, road.GetEnd().x, road.GetEnd().y});
+    }
+    record.roads = writer.Append(std::span<const RoadRecord>(roads));
+
+    std::vector<BuildingRecord> buildings;
+    buildings.reserve(map.GetBuildings().size());
+    for(const auto& building : map.GetBuildings()) {
+        const auto& bounds = building.GetBounds();
+        buildings.push_back({bounds.position.x, bounds.position.y, bounds.size.width, bounds.size.height});
+    }
+    record.buildings = writer.Append(std::span<const BuildingRecord>(buildings));
+
+    std::vector<OfficeRecord> offices;
+    offices.reserve(map.GetOffices().size());
+    for(const auto& office : map.GetOffices()) {
+        offices.push_back({writer.AppendString(*office.GetId()), office.GetPosition().x, office.GetPosition().y,
+                           office.GetOffset().dx, office.GetOffset().dy});
+    }
+    record.offices = writer.Append(std::span<const OfficeRecord>(offices));
+
+    std::vector<LineRecord> lines;
+    std::vector<SpanRecord> spans;
+    map.GetRoadmap().ForEachLine([&](bool horizontal, int64_t line_coord, const model::Roadmap::LineSpans& line) {
+        spans.clear();
+        for(const auto& span : line) {
+            spans.push_back({span.begin, span.end, span.max_end, static_cast<uint64_t>(span.road)});
+        }
+        lines.push_back({line_coord, horizontal ? 1u : 0u, 0, writer.Append(std::span<const SpanRecord>(spans))});
+    });
+    record.lines = writer.Append(std::span<const LineRecord>(lines));
+    return record;
+}
+
+model::Map ReadMap(const MapRecord& record, const PayloadReader& reader) {
+    model::Map map(model::Map::Id{reader.GetString(record.id)}, reader.GetString(record.name));
+
+    model::Roadmap::Roads roads;
+    auto road_records = reader.GetSection<RoadRecord>(record.roads);
+    roads.reserve(road_records.size());
+    for(const auto& road : road_records) {
+        if(road.start_y == road.end_y) {
+            roads.emplace_back(model::Road::HORIZONTAL, model::Point{road.start_x, road.start_y}, road.end_x);
+        } else {
+            roads.emplace_back(model::Road::VERTICAL, model::Point{road.start_x, road.start_y}, road.end_y);
+        }
+    }
+    model::Roadmap roadmap;
+    roadmap.RestoreRoads(std::move(roads));
+    for(const auto& line : reader.GetSection<LineRecord>(record.lines)) {
+        model::Roadmap::LineSpans spans;
+        auto span_records = reader.GetSection<SpanRecord>(line.spans);
+        spans.reserve(span_records.size());
+        for(const auto& span : span_records) {
+            if(span.road >= road_records.size()) {
+                throw MapArtifactException("road index is out of range");
+            }
+            spans.push_back({span.begin, span.end, static_cast<size_t>(span.road), span.max_end});
+        }
+        roadmap.RestoreLine(line.horizontal != 0, line.line_coord, std::move(spans));
+    }
+    map.SetRoadmap(std::move(roadmap));
+
+    for(const auto& building : reader.GetSection<BuildingRecord>(record.buildings)) {
+        map.AddBuilding(model::Building{{{building.x, building.y}, {building.width, building.height}}});
+    }
+    for(const auto& office : reader.GetSection<OfficeRecord>(record.offices)) {
+        map.AddOffice(model::Office{model::Office::Id{reader.GetString(office.id)}, {office.x, office.y},
+                                    {office.offset_x, office.offset_y}});
+    }
+    map.SetDogVelocity(record.dog_velocity);
+    return map;
+}
+
+model::Game ReadGame(const Header& header, const PayloadReader& reader) {
+    model::Game game;
+    // Скорости карт сохранены с уже примененной скоростью по умолчанию, порядок установки на них не влияет
+    game.SetDefaultDogVelocity(header.default_dog_velocity);
+    if(header.dog_retirement_time_ms != NO_RETIREMENT_TIME) {
+        game.SetDogRetirementTime(std::chrono::milliseconds(header.dog_retirement_time_ms));
+    }
+    for(const auto& record : reader.GetSection<MapRecord>({0, header.maps_count})) {
+        game.AddMap(ReadMap(record, reader));
+    }
+    return game;
+}
+
+void ReportArtifactSkipped(const fs::path& artifact_path, std::string_view reason) {
+    BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("map artifact skipped, loading config"sv,
+                                                            logware::MapArtifactLogData{artifact_path.string(), reason});
+}
+
+}  // namespace
+
+uint64_t HashConfigFile(const fs::path& config_path) {
+    std::ifstream file(config_path, std::ios::binary);
+    if(!file.is_open()) {
+        throw MapArtifactException("Can't open config file "s + config_path.string());
+    }
+    uint64_t hash = FNV_OFFSET_BASIS;
+    std::array<char, 64 * 1024> buffer;
+    while(file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+        for(std::streamsize i = 0; i < file.gcount(); ++i) {
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+void SaveGame(const model::Game& game, uint64_t config_hash, const fs::path& artifact_path) {
+    const auto& maps = game.GetMaps();
+    PayloadWriter writer;
+    // Записи карт идут первыми, их заполняем после того, как разделы карт получат смещения
+    const std::vector<MapRecord> empty_records(maps.size());
+    const SectionRef records = writer.Append(std::span<const MapRecord>(empty_records));
+    for(size_t i = 0; i < maps.size(); ++i) {
+        writer.Overwrite(records.offset + i * sizeof(MapRecord), WriteMap(*maps[i], writer));
+    }
+
+    const auto& payload = writer.GetData();
+    Header header{};
+    header.magic = MAGIC;
+    header.version = FORMAT_VERSION;
+    header.byte_order_mark = BYTE_ORDER_MARK;
+    header.config_hash = config_hash;
+    header.payload_size = payload.size();
+    header.payload_checksum = CalculateChecksum(payload.data(), payload.size());
+    header.maps_count = static_cast<uint32_t>(maps.size());
+    header.default_dog_velocity = game.GetDefaultDogVelocity();
+    const auto retirement_time = game.GetDogRetirementTime();
+    header.dog_retirement_time_ms = retirement_time ? retirement_time->count() : NO_RETIREMENT_TIME;
+
+    /*Содержимое временного файла и запись о нем сбрасываются на диск до переименования, а каталог -
+    еще раз после него. Иначе после сбоя питания под именем артефакта может оказаться пустой
+    или недописанный файл, а переименование может потеряться*/
+    fs::path tmp_path = artifact_path;
+    tmp_path += ".tmp"s;
+    const fs::path dir = artifact_path.parent_path();
+    {
+        FileDescriptor file(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        WriteAll(file, reinterpret_cast<const char*>(&header), sizeof(header), tmp_path);
+        WriteAll(file, payload.data(), payload.size(), tmp_path);
+        Sync(file, tmp_path);
+    }
+    SyncDirectory(dir);
+    fs::rename(tmp_path, artifact_path);
+    SyncDirectory(dir);
+}
+
+std::optional<model::Game> LoadGame(const fs::path& artifact_path, uint64_t config_hash) {
+    std::error_code ec;
+    if(!fs::is_regular_file(artifact_path, ec)) {
+        ReportArtifactSkipped(artifact_path, "file not found"sv);
+        return std::nullopt;
+    }
+    try {
+        ipc::file_mapping file(artifact_path.c_str(), ipc::read_only);
+        ipc::mapped_region region(file, ipc::read_only);
+        const auto* data = static_cast<const char*>(region.get_address());
+        const size_t size = region.get_size();
+
+        Header header;
+        if(size < sizeof(Header)) {
+            throw MapArtifactException("file is too small");
+        }
+        std::memcpy(&header, data, sizeof(Header));
+        if(header.magic != MAGIC || header.byte_order_mark != BYTE_ORDER_MARK) {
+            ReportArtifactSkipped(artifact_path, "not a map artifact or other byte order"sv);
+            return std::nullopt;
+        }
+        if(header.version != FORMAT_VERSION) {
+            ReportArtifactSkipped(artifact_path, "other format version"sv);
+            return std::nullopt;
+        }
+        if(header.config_hash != config_hash) {
+            ReportArtifactSkipped(artifact_path, "config hash mismatch"sv);
+            return std::nullopt;
+        }
+        if(header.payload_size != size - sizeof(Header)) {
+            throw MapArtifactException("file size mismatch");
+        }
+        const char* payload = data + sizeof(Header);
+        if(CalculateChecksum(payload, header.payload_size) != header.payload_checksum) {
+            throw MapArtifactException("checksum mismatch");
+        }
+        return ReadGame(header, PayloadReader(payload, header.payload_size));
+    } catch(const MapArtifactException& ex) {
+        ReportArtifactSkipped(artifact_path, ex.what());
+    } catch(const ipc::interprocess_exception& ex) {
+        ReportArtifactSkipped(artifact_path, ex.what());
+    }
+    return std::nullopt;
+}
+
+}  // namespace map_artifact
@@ -0,0 +1,37 @@
+#pragma once
+#include "game.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace map_artifact {
+
+/*Артефакт карт - двоичный снимок карт игры вместе с построенными индексами дорог. Он собирается
+из конфигурации заранее (--compile-maps), а сервер при запуске отображает его в память и не
+разбирает JSON и не строит индексы. Загрузка копирующая: записи переносятся в объекты модели,
+и после загрузки отображение закрывается. В артефакте хранятся версия формата, хэш конфигурации,
+из которой он собран, и контрольная сумма содержимого.*/
+
+// Версия формата, меняется при любом изменении раскладки записей
+const uint32_t FORMAT_VERSION = 1;
+
+// Хэш содержимого файла конфигурации (FNV-1a)
+uint64_t HashConfigFile(const std::filesystem::path& config_path);
+
+/*Записывает артефакт во временный файл рядом с artifact_path и переименовывает его, запущенные серверы видят
+либо старый артефакт, либо новый. Файл и каталог сбрасываются на диск, поэтому это верно и после сбоя питания*/
+void SaveGame(const model::Game& game, uint64_t config_hash, const std::filesystem::path& artifact_path);
+
+/*Загружает игру из артефакта. Возвращает пустое значение, если артефакта нет, он собран из другой
+конфигурации или другой версией формата или поврежден. Причина пишется в лог*/
+std::optional<model::Game> LoadGame(const std::filesystem::path& artifact_path, uint64_t config_hash);
+
+class MapArtifactException : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+}  // namespace map_artifact
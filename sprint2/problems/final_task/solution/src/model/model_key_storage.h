@@ -3,6 +3,7 @@
 namespace model{
 
 const std::string DEFAULT_DOG_VELOCITY = "defaultDogSpeed";
+const std::string DOG_RETIREMENT_TIME  = "dogRetirementTime";
 
 const std::string MAPS              = "maps";
 const std::string MAP_ID            = "id";
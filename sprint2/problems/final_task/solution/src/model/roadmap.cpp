@@ -1,10 +1,11 @@
 #include "roadmap.h"
 
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 #include <iostream>
 #include <stdint.h>
-#include <set>
 
 namespace model {
 
@@ -12,55 +13,95 @@ namespace model {
 (условие непрерывности маршрута если в клетке есть какая-нибудь дорога).*/
 const int SCALE_FACTOR_OF_CELL = 20;    // Разбиваем карту на квадраты размером 0.05x0.05 папугаев.
 
-Roadmap::Roadmap(const Roadmap& other) {
-    CopyContent(other.roads_);
+const auto SCALLED_OFFSET = static_cast<int64_t>(OFFSET * SCALE_FACTOR_OF_CELL);
+
+namespace {
+
+// Деление с округлением вниз и для отрицательных координат
+int64_t FloorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+}
+
+void Roadmap::AddRoad(const Road& road) {
+    auto index = roads_.size();
+    roads_.emplace_back(road);
+    const auto cells = GetRoadCells(road);
+    if(road.IsHorizontal()) {
+        horizontal_lines_[road.GetStart().y].push_back({cells.x_begin, cells.x_end, index, 0});
+    } else {
+        vertical_lines_[road.GetStart().x].push_back({cells.y_begin, cells.y_end, index, 0});
+    }
+    indexed_ = false;
 };
 
-Roadmap::Roadmap(Roadmap&& other) {
-    matrix_map_ = std::move(other.matrix_map_);
-    roads_ = std::move(other.roads_);
+void Roadmap::AddRoads(const Roads& roads) {
+    roads_.reserve(roads_.size() + roads.size());
+    for(const auto& road : roads) {
+        AddRoad(road);
+    }
+    BuildIndex();
 };
 
-Roadmap& Roadmap::operator = (const Roadmap& other) {
-    if(this != &other) {
-        CopyContent(other.roads_);
+void Roadmap::BuildIndex() {
+    if(indexed_) {
+        return;
     }
-    return *this;
+    IndexLines(horizontal_lines_);
+    IndexLines(vertical_lines_);
+    indexed_ = true;
 };
 
-Roadmap& Roadmap::operator = (Roadmap&& other) {
-    if(this != &other) {
-        matrix_map_ = std::move(other.matrix_map_);
-        roads_ = std::move(other.roads_);
+bool Roadmap::IsIndexed() const noexcept {
+    return indexed_;
+};
+
+Roadmap::RoadCells Roadmap::GetRoadCells(const Road& road) {
+    // Дорога занимает прямоугольник ячеек: вдоль линии от начала до конца, поперек - на ширину обочины
+    const auto min_x = static_cast<int64_t>(std::min(road.GetStart().x, road.GetEnd().x));
+    const auto max_x = static_cast<int64_t>(std::max(road.GetStart().x, road.GetEnd().x));
+    const auto min_y = static_cast<int64_t>(std::min(road.GetStart().y, road.GetEnd().y));
+    const auto max_y = static_cast<int64_t>(std::max(road.GetStart().y, road.GetEnd().y));
+    return {min_x * SCALE_FACTOR_OF_CELL - SCALLED_OFFSET, max_x * SCALE_FACTOR_OF_CELL + SCALLED_OFFSET,
+            min_y * SCALE_FACTOR_OF_CELL - SCALLED_OFFSET, max_y * SCALE_FACTOR_OF_CELL + SCALLED_OFFSET};
+}
+
+void Roadmap::IndexLines(Lines& lines) {
+    for(auto& [line_coord, spans] : lines) {
+        // Отрезки с одинаковым началом остаются в порядке добавления дорог
+        std::stable_sort(spans.begin(), spans.end(), [](const LineSpan& lhs, const LineSpan& rhs) {
+            return lhs.begin < rhs.begin;
+        });
+        for(size_t pos = 0; pos < spans.size(); ++pos) {
+            spans[pos].max_end = (pos == 0) ? spans[pos].end : std::max(spans[pos - 1].max_end, spans[pos].end);
+        }
     }
-    return *this;
 };
 
-void Roadmap::AddRoad(const Road& road) {
-    const auto SCALLED_OFFSET = static_cast<int64_t>(OFFSET * SCALE_FACTOR_OF_CELL);
-    auto index = roads_.size();
-    roads_.emplace_back(road);
-    if(road.IsHorizontal()) {
-        auto start = static_cast<int64_t>((road.GetStart().x < road.GetEnd().x) ? road.GetStart().x : road.GetEnd().x);
-        auto end = static_cast<int64_t>((road.GetStart().x < road.GetEnd().x) ? road.GetEnd().x : road.GetStart().x);
-        start = start * SCALE_FACTOR_OF_CELL - SCALLED_OFFSET;
-        end = end * SCALE_FACTOR_OF_CELL + SCALLED_OFFSET;
-        auto y = road.GetStart().y * SCALE_FACTOR_OF_CELL;
-        for(auto x = start; x <= end; ++x) {
-            for(auto i = -(SCALLED_OFFSET); i <= SCALLED_OFFSET; ++i) {
-                matrix_map_[x][y + i].insert(index);
-            }
+void Roadmap::CollectLineRoads(const Lines& lines, int64_t across, int64_t along, CellRoads& roads) {
+    // Обочины соседних линий не пересекаются, поэтому ячейка лежит не более чем на одной линии
+    const int64_t line_coord = FloorDiv(across + SCALE_FACTOR_OF_CELL / 2, SCALE_FACTOR_OF_CELL);
+    if(std::abs(across - line_coord * SCALE_FACTOR_OF_CELL) > SCALLED_OFFSET) {
+        return;
+    }
+    auto line = lines.find(line_coord);
+    if(line == lines.end()) {
+        return;
+    }
+    const auto& spans = line->second;
+    auto it = std::upper_bound(spans.begin(), spans.end(), along, [](int64_t value, const LineSpan& item) {
+        return value < item.begin;
+    });
+    // Отрезки левее it начинаются не позже along, просматриваем их, пока какой-то из них может его накрыть
+    while(it != spans.begin()) {
+        --it;
+        if(it->max_end < along) {
+            break;
         }
-    } else {
-        auto start = static_cast<int64_t>((road.GetStart().y < road.GetEnd().y) ? road.GetStart().y : road.GetEnd().y);
-        auto end = static_cast<int64_t>((road.GetStart().y < road.GetEnd().y) ? road.GetEnd().y : road.GetStart().y);
-        start = start * SCALE_FACTOR_OF_CELL - SCALLED_OFFSET;
-        end = end * SCALE_FACTOR_OF_CELL + SCALLED_OFFSET;
-        auto x = road.GetStart().x * SCALE_FACTOR_OF_CELL;
-        for(auto y = start; y <= end; ++y) {
-            for(auto i = -SCALLED_OFFSET; i <= SCALLED_OFFSET; ++i) {
-                matrix_map_[x + i][y].insert(index);
-            }
+        if(it->end >= along) {
+            roads.push_back(it->road);
         }
     }
 };
@@ -69,14 +110,25 @@ const Roadmap::Roads& Roadmap::GetRoads() const noexcept {
     return roads_;
 };
 
+void Roadmap::RestoreRoads(Roads roads) {
+    roads_ = std::move(roads);
+};
+
+void Roadmap::RestoreLine(bool horizontal, int64_t line_coord, LineSpans spans) {
+    (horizontal ? horizontal_lines_ : vertical_lines_)[line_coord] = std::move(spans);
+};
+
 std::tuple<Position, Velocity> Roadmap::GetValidMove(const Position& old_position,
                             const Position& potential_new_position,
-                            const Velocity& old_velocity) {
+                            const Velocity& old_velocity) const {
+    if(!indexed_) {
+        throw std::logic_error("Roadmap index is not built");
+    }
     Velocity velocity = {0, 0};
     auto start_roads = GetCoordinatesOfPosition(old_position);
     auto end_roads = GetCoordinatesOfPosition(potential_new_position);
     if(end_roads){
-        if(!IsValidPosition(matrix_map_[end_roads.value().x][end_roads.value().y],
+        if(!IsValidPosition(GetCell(end_roads.value().x, end_roads.value().y),
                             potential_new_position)) {
             end_roads = std::nullopt;
         } else if(start_roads == end_roads) {
@@ -85,7 +137,7 @@ std::tuple<Position, Velocity> Roadmap::GetValidMove(const Position& old_positio
     }
     auto dest = GetDestinationRoadsOfRoute(start_roads, end_roads, old_velocity);
     Position position;
-    if(dest && IsValidPosition(matrix_map_[dest.value().x][dest.value().y], potential_new_position)) {
+    if(dest && IsValidPosition(GetCell(dest.value().x, dest.value().y), potential_new_position)) {
         position = potential_new_position;
         velocity = old_velocity;
     } else {
@@ -97,95 +149,82 @@ std::tuple<Position, Velocity> Roadmap::GetValidMove(const Position& old_positio
 std::optional<const Roadmap::MatrixMapCoord> Roadmap::GetDestinationRoadsOfRoute(
                                     std::optional<const MatrixMapCoord> start,
                                     std::optional<const MatrixMapCoord> end,
-                                    const Velocity& old_velocity) {
+                                    const Velocity& old_velocity) const {
     const MatrixMapCoord start_coord = start.value();
-    MatrixMapCoord current_coord = start_coord;
-    if(old_velocity.vx != 0) {
-        int direction = std::signbit(old_velocity.vx) ? -1 : 1;
-        int64_t end_x{0};
-        if(end) {
-            end_x = end.value().x * SCALE_FACTOR_OF_CELL;
-            end_x = (direction > 0) ? (end_x < LLONG_MAX ? end_x + 1 : LLONG_MAX) :
-                                        end_x - 1;
-        } else {
-            end_x = (direction > 0) ? LLONG_MAX : -(OFFSET * SCALE_FACTOR_OF_CELL) - 1;
-        }
-        int64_t index{0};
-        for(index = start_coord.x; index != end_x; index += direction) {
-            if(ValidateCoordinates({index, start_coord.y}) &&
-                IsCrossedSets(matrix_map_[start_coord.x][start_coord.y],
-                                matrix_map_[index][start_coord.y])) {
-                current_coord = {index, start_coord.y};
-            } else {
-                break;
-            }
-        }
-        return current_coord;
-    } else if(old_velocity.vy != 0) {
-        int direction = std::signbit(old_velocity.vy) ? -1 : 1;
-        int64_t end_y{0};
-        if(end) {
-            end_y = end.value().y * SCALE_FACTOR_OF_CELL;
-            end_y = (direction > 0) ? (end_y < LLONG_MAX ? end_y + 1 : LLONG_MAX) :
-                                        end_y - 1;
-        } else {
-            end_y = (direction > 0) ? LLONG_MAX : -(OFFSET * SCALE_FACTOR_OF_CELL)  - 1;
-        }
-        int64_t index{0};
-        for(index = start_coord.y; index != end_y; index += direction) {
-            if(ValidateCoordinates({start_coord.x, index}) &&
-                IsCrossedSets(matrix_map_[start_coord.x][start_coord.y],
-                                matrix_map_[start_coord.x][index])) {
-                current_coord =  {start_coord.x, index};
-            } else {
-                break;
-            }
-        }
-        return current_coord;
+    if(old_velocity.vx == 0 && old_velocity.vy == 0) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    const bool along_x = (old_velocity.vx != 0);
+    const int direction = std::signbit(along_x ? old_velocity.vx : old_velocity.vy) ? -1 : 1;
+    const int64_t start_index = along_x ? start_coord.x : start_coord.y;
+    // Граница движения, не включая ее саму
+    int64_t end_index{0};
+    if(end) {
+        end_index = (along_x ? end.value().x : end.value().y) * SCALE_FACTOR_OF_CELL;
+        end_index = (direction > 0) ? (end_index < LLONG_MAX ? end_index + 1 : LLONG_MAX) :
+                                        end_index - 1;
+    } else {
+        end_index = (direction > 0) ? LLONG_MAX : -(OFFSET * SCALE_FACTOR_OF_CELL) - 1;
+    }
+    /*Каждая дорога начальной ячейки покрывает вдоль направления движения непрерывный отрезок
+    ячеек, содержащий начальную. Объединение таких отрезков тоже отрезок, поэтому собака
+    проходит ячейки подряд до его края, если раньше не дойдет до границы движения*/
+    int64_t reach = start_index;
+    for(auto road_ind : GetCell(start_coord.x, start_coord.y)) {
+        const auto cells = GetRoadCells(roads_[road_ind]);
+        reach = (direction > 0) ? std::max(reach, along_x ? cells.x_end : cells.y_end) :
+                                  std::min(reach, along_x ? cells.x_begin : cells.y_begin);
+    }
+    int64_t index = reach;
+    if(end_index == start_index) {
+        index = start_index;
+    } else if((end_index > start_index) == (direction > 0)) {
+        index = (direction > 0) ? std::min(reach, end_index - 1) : std::max(reach, end_index + 1);
+    }
+    return along_x ? MatrixMapCoord{index, start_coord.y} : MatrixMapCoord{start_coord.x, index};
 };
 
-std::optional<const Roadmap::MatrixMapCoord> Roadmap::GetCoordinatesOfPosition(const Position& position) {
+std::optional<const Roadmap::MatrixMapCoord> Roadmap::GetCoordinatesOfPosition(const Position& position) const {
     if(position.x < -OFFSET - EPSILON || position.y < -OFFSET - EPSILON) {
         return std::nullopt;
     }
     int64_t x_index = (position.x >= 0) ? std::floor(position.x * SCALE_FACTOR_OF_CELL) : std::ceil(position.x * SCALE_FACTOR_OF_CELL);
     int64_t y_index = (position.y >= 0) ? std::floor(position.y * SCALE_FACTOR_OF_CELL) : std::ceil(position.y * SCALE_FACTOR_OF_CELL);
-    if(matrix_map_.contains(x_index)) {
-        if(matrix_map_[x_index].contains(y_index)) {
-            return MatrixMapCoord{x_index, y_index};
-        }
+    if(ValidateCoordinates({x_index, y_index})) {
+        return MatrixMapCoord{x_index, y_index};
     }
     return std::nullopt;
 };
 
-bool Roadmap::IsCrossedSets(const std::unordered_set<size_t>& lhs,
-                            const std::unordered_set<size_t>& rhs) {
+bool Roadmap::IsCrossedSets(const CellRoads& lhs,
+                            const CellRoads& rhs) const {
     for(auto item : lhs) {
-        if(rhs.contains(item)) {
+        if(std::find(rhs.begin(), rhs.end(), item) != rhs.end()) {
             return true;
         }
     }
     return false;
 };
 
-bool Roadmap::ValidateCoordinates(const MatrixMapCoord& coordinates) {
-    if(matrix_map_.contains(coordinates.x)) {
-        return matrix_map_[coordinates.x].contains(coordinates.y);
-    }
-    return false;
+bool Roadmap::ValidateCoordinates(const MatrixMapCoord& coordinates) const {
+    return !GetCell(coordinates.x, coordinates.y).empty();
+};
+
+Roadmap::CellRoads Roadmap::GetCell(int64_t x, int64_t y) const {
+    CellRoads roads;
+    CollectLineRoads(horizontal_lines_, y, x, roads);
+    CollectLineRoads(vertical_lines_, x, y, roads);
+    return roads;
 };
 
 const Position Roadmap::GetFarestPoinOfRoute(const MatrixMapCoord& roads_coord,
                                     const Position& old_position,
-                                    const Velocity& old_velocity) {
+                                    const Velocity& old_velocity) const {
     Position res_position{old_position};
-    auto cell_pos = MatrixCoordinateToPosition(roads_coord, old_position);
     auto direction = VelocityToDirection(old_velocity);
-    for(auto road_ind : matrix_map_[roads_coord.x][roads_coord.y]) {
-        auto start_position = cell_pos.at(DIRECTION_TO_OPOSITE_DIRECTION.at(direction));
-        auto end_position = cell_pos.at(direction);
+    auto start_position = GetCellBorder(roads_coord, old_position, DIRECTION_TO_OPOSITE_DIRECTION.at(direction));
+    auto end_position = GetCellBorder(roads_coord, old_position, direction);
+    for(auto road_ind : GetCell(roads_coord.x, roads_coord.y)) {
         if(IsValidPositionOnRoad(roads_[road_ind], start_position)) {
             if(IsValidPositionOnRoad(roads_[road_ind], end_position)) {
                 return end_position;
@@ -196,30 +235,27 @@ const Position Roadmap::GetFarestPoinOfRoute(const MatrixMapCoord& roads_coord,
     return res_position;
 };
 
-const std::unordered_map<Direction, Position> Roadmap::MatrixCoordinateToPosition(const MatrixMapCoord& coord,
-                                                                                const Position& target_position){
-    std::unordered_map<Direction, Position> res;
-    int64_t x_inc_e = (coord.x < 0) ? 0 : 1;
-    int64_t y_inc_s = (coord.y < 0) ? 0 : 1;
-    int64_t x_inc_w = (coord.x < 0) ? -1 : 0;
-    int64_t y_inc_n = (coord.y < 0) ? -1 : 0;
-    res[Direction::NORTH] = Position{
-        target_position.x,
-        (static_cast<double>(coord.y + y_inc_n) / static_cast<double>(SCALE_FACTOR_OF_CELL))};
-    res[Direction::SOUTH] = Position{
-        target_position.x,
-        (static_cast<double>(coord.y + y_inc_s) / static_cast<double>(SCALE_FACTOR_OF_CELL))};
-    res[Direction::WEST] = Position{
-        (static_cast<double>(coord.x + x_inc_w) / static_cast<double>(SCALE_FACTOR_OF_CELL)),
-        target_position.y};
-    res[Direction::EAST] = Position{
-        (static_cast<double>(coord.x + x_inc_e) / static_cast<double>(SCALE_FACTOR_OF_CELL)),
-        target_position.y};
-    res[Direction::NONE] = Position{target_position.x, target_position.y};
-    return res;
+Position Roadmap::GetCellBorder(const MatrixMapCoord& coord, const Position& target_position,
+                                Direction direction) const {
+    switch(direction) {
+        case Direction::NORTH:
+            return {target_position.x,
+                    static_cast<double>(coord.y + ((coord.y < 0) ? -1 : 0)) / static_cast<double>(SCALE_FACTOR_OF_CELL)};
+        case Direction::SOUTH:
+            return {target_position.x,
+                    static_cast<double>(coord.y + ((coord.y < 0) ? 0 : 1)) / static_cast<double>(SCALE_FACTOR_OF_CELL)};
+        case Direction::WEST:
+            return {static_cast<double>(coord.x + ((coord.x < 0) ? -1 : 0)) / static_cast<double>(SCALE_FACTOR_OF_CELL),
+                    target_position.y};
+        case Direction::EAST:
+            return {static_cast<double>(coord.x + ((coord.x < 0) ? 0 : 1)) / static_cast<double>(SCALE_FACTOR_OF_CELL),
+                    target_position.y};
+        default:
+            return target_position;
+    }
 }
 
-const Direction Roadmap::VelocityToDirection(const Velocity& velocity) {
+const Direction Roadmap::VelocityToDirection(const Velocity& velocity) const {
     Velocity vel{0, 0};
     if(velocity.vx != 0) {
         vel.vx = std::signbit(velocity.vx) ? -1 : 1;
@@ -230,7 +266,7 @@ const Direction Roadmap::VelocityToDirection(const Velocity& velocity) {
     return VELOCITY_TO_DIRECTION.at(vel);
 }
 
-bool Roadmap::IsValidPosition(const std::unordered_set<size_t>& roads_ind, const Position& position) {
+bool Roadmap::IsValidPosition(const CellRoads& roads_ind, const Position& position) const {
     for(auto road_index : roads_ind) {
         if(IsValidPositionOnRoad(roads_[road_index], position)) {
             return true;
@@ -239,7 +275,7 @@ bool Roadmap::IsValidPosition(const std::unordered_set<size_t>& roads_ind, const
     return false;
 };
 
-bool Roadmap::IsValidPositionOnRoad(const Road& road, const Position& position) {
+bool Roadmap::IsValidPositionOnRoad(const Road& road, const Position& position) const {
     double start_x, end_x, start_y, end_y;
     if(road.IsHorizontal()) {
         start_x = (road.GetStart().x < road.GetEnd().x) ? (road.GetStart().x) : (road.GetEnd().x);
@@ -264,10 +300,4 @@ bool Roadmap::IsValidPositionOnRoad(const Road& road, const Position& position)
             ((position.y < end_y) || (std::abs(position.y - end_y) < EPSILON));
 };
 
-void Roadmap::CopyContent(const Roadmap::Roads& roads) {
-    for(auto& road : roads) {
-        AddRoad(road);
-    }
-};
-
 }
\ No newline at end of file
@@ -2,31 +2,69 @@
 #include "road.h"
 #include "support_types.h"
 
-#include <map>
-#include <unordered_set>
+#include <boost/container/small_vector.hpp>
+#include <cstdint>
+#include <unordered_map>
 #include <tuple>
 #include <optional>
+#include <vector>
 
 namespace model {
 
-/*Класс для предстваления карты дорог. Map разбивается на ячейки с целочисленными координатами
-в каждой ячейке хранится множество дорог проходящих по данному участку*/
+/*Класс для предстваления карты дорог. Map разбивается на ячейки с целочисленными координатами,
+ячейке принадлежат дороги, проходящие по данному участку. Ячейки не хранятся: дороги
+собраны в списки отрезков по линиям (горизонтальные по y, вертикальные по x), и дороги
+ячейки находятся двоичным поиском в списках не более чем двух линий. Память и время
+построения зависят от числа дорог, а не от их длины.*/
 class Roadmap {
 public:
     using Roads = std::vector<Road>;
 
+    // Отрезок ячеек [begin, end] дороги road вдоль линии
+    struct LineSpan {
+        int64_t begin;
+        int64_t end;
+        size_t road;
+        // Наибольший конец среди отрезков линии до этого включительно, ограничивает поиск назад
+        int64_t max_end;
+    };
+    // После построения индекса отрезки линии упорядочены по началу
+    using LineSpans = std::vector<LineSpan>;
+
     Roadmap() = default;
-    Roadmap(const Roadmap& other);
-    Roadmap(Roadmap&& other);
-    Roadmap& operator = (const Roadmap& other);
-    Roadmap& operator = (Roadmap&& other);
+    Roadmap(const Roadmap& other) = default;
+    Roadmap(Roadmap&& other) = default;
+    Roadmap& operator = (const Roadmap& other) = default;
+    Roadmap& operator = (Roadmap&& other) = default;
     virtual ~Roadmap() = default;
 
+    /*Дорога добавляется в конец списка своей линии. Поиск по карте возможен только после BuildIndex,
+    поэтому дороги сначала добавляются все, а индекс строится один раз*/
     void AddRoad(const Road& road);
+    void AddRoads(const Roads& roads);
+    // Упорядочивает отрезки линий и пересчитывает наибольшие концы. Повторный вызов без новых дорог ничего не делает
+    void BuildIndex();
+    bool IsIndexed() const noexcept;
     const Roads& GetRoads() const noexcept;
+    // Обход построенного индекса: fn(horizontal, line_coord, spans) для каждой линии
+    template <typename Fn>
+    void ForEachLine(Fn&& fn) const {
+        for(const auto& [line_coord, spans] : horizontal_lines_) {
+            fn(true, line_coord, spans);
+        }
+        for(const auto& [line_coord, spans] : vertical_lines_) {
+            fn(false, line_coord, spans);
+        }
+    }
+    /*Восстановление сохраненного индекса без пересчета: дороги и отрезки линий берутся как есть,
+    в том виде, в каком их выдал ForEachLine. Дороги линий должны быть уже добавлены*/
+    void RestoreRoads(Roads roads);
+    void RestoreLine(bool horizontal, int64_t line_coord, LineSpans spans);
+    /*Время расчета не зависит от пройденного расстояния: край дороги по ходу движения находится сразу.
+    Без построенного индекса бросает std::logic_error*/
     std::tuple<Position, Velocity> GetValidMove(const Position& old_position,
                             const Position& potential_new_position,
-                            const Velocity& old_velocity);
+                            const Velocity& old_velocity) const;
 private:
     struct MatrixMapCoord {
         int64_t x;
@@ -36,29 +74,48 @@ private:
             return (x == other.x) && (y == other.y); 
         };
     };
-    using MatrixMap = std::map< int64_t, std::map<int64_t, std::unordered_set<size_t> > >;
-    MatrixMap matrix_map_;
+    // Дороги одной ячейки. Больше нескольких дорог в ячейке бывает только при наложении дорог
+    using CellRoads = boost::container::small_vector<size_t, 4>;
+
+    // Прямоугольник ячеек [x_begin, x_end] x [y_begin, y_end], занятый дорогой вместе с обочиной
+    struct RoadCells {
+        int64_t x_begin;
+        int64_t x_end;
+        int64_t y_begin;
+        int64_t y_end;
+    };
+    using Lines = std::unordered_map<int64_t, LineSpans>;
+
+    Lines horizontal_lines_;
+    Lines vertical_lines_;
     Roads roads_;
+    bool indexed_{true};
 
     std::optional<const MatrixMapCoord> GetDestinationRoadsOfRoute(
         std::optional<const MatrixMapCoord> start,
         std::optional<const MatrixMapCoord> end,
-        const Velocity& old_velocity);
-    std::optional<const MatrixMapCoord> GetCoordinatesOfPosition(const Position& position);
-    const Direction VelocityToDirection(const Velocity& velocity);
-    const std::unordered_map<Direction, Position> MatrixCoordinateToPosition(const MatrixMapCoord& coord,
-                                                                            const Position& target_position);
-    bool IsCrossedSets(const std::unordered_set<size_t>& lhs,
-                        const std::unordered_set<size_t>& rhs);
-    bool ValidateCoordinates(const MatrixMapCoord& coordinates);
+        const Velocity& old_velocity) const;
+    std::optional<const MatrixMapCoord> GetCoordinatesOfPosition(const Position& position) const;
+    const Direction VelocityToDirection(const Velocity& velocity) const;
+    // Точка на границе ячейки со стороны direction, вторая координата берется из target_position
+    Position GetCellBorder(const MatrixMapCoord& coord, const Position& target_position,
+                            Direction direction) const;
+    bool IsCrossedSets(const CellRoads& lhs,
+                        const CellRoads& rhs) const;
+    bool ValidateCoordinates(const MatrixMapCoord& coordinates) const;
+    // Дороги клетки. Поиск не изменяет индекс, поэтому карту можно читать из нескольких потоков
+    CellRoads GetCell(int64_t x, int64_t y) const;
+    // Дороги линий, проходящие через ячейку across по поперечной координате и along - по продольной
+    static void CollectLineRoads(const Lines& lines, int64_t across, int64_t along, CellRoads& roads);
+    static void IndexLines(Lines& lines);
+    static RoadCells GetRoadCells(const Road& road);
     const Position GetFarestPoinOfRoute(const MatrixMapCoord& roads_coord,
                                         const Position& old_position,
-                                        const Velocity& old_velocity);
-    bool IsValidPosition(const std::unordered_set<size_t>& roads_ind,
-                        const Position& position);
+                                        const Velocity& old_velocity) const;
+    bool IsValidPosition(const CellRoads& roads_ind,
+                        const Position& position) const;
     
-    bool IsValidPositionOnRoad(const Road& road, const Position& position);
-    void CopyContent(const Roads& roads);
+    bool IsValidPositionOnRoad(const Road& road, const Position& position) const;
 };
 
 }
\ No newline at end of file
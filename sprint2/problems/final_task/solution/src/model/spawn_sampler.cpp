@@ -0,0 +1,71 @@
+#include "spawn_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace model {
+
+SpawnSampler::SpawnSampler(const std::vector<Road>& roads) {
+    const size_t count = roads.size();
+    segments_.reserve(count);
+    std::vector<double> weights;
+    weights.reserve(count);
+    for(const auto& road : roads) {
+        const Position start{static_cast<double>(road.GetStart().x), static_cast<double>(road.GetStart().y)};
+        const Position direction{road.GetEnd().x - start.x, road.GetEnd().y - start.y};
+        segments_.push_back({start, direction});
+        weights.push_back(std::abs(direction.x) + std::abs(direction.y));
+    }
+    if(count == 0) {
+        return;
+    }
+    const double total_length = std::accumulate(weights.begin(), weights.end(), 0.0);
+    if(total_length == 0) {
+        std::fill(weights.begin(), weights.end(), 1.0);
+    }
+    const double mean = (total_length == 0 ? static_cast<double>(count) : total_length) / static_cast<double>(count);
+
+    // Веса нормируются к среднему, столбцы с весом меньше единицы добираются из столбцов с большим весом
+    columns_.resize(count);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for(size_t i = 0; i < count; ++i) {
+        weights[i] /= mean;
+        (weights[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    while(!small.empty() && !large.empty()) {
+        const uint32_t less = small.back();
+        small.pop_back();
+        const uint32_t more = large.back();
+        columns_[less] = {weights[less], more};
+        weights[more] -= 1.0 - weights[less];
+        if(weights[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // Оставшиеся столбцы заполнены своей дорогой с точностью до ошибок округления
+    for(const auto index : large) {
+        columns_[index] = {1.0, index};
+    }
+    for(const auto index : small) {
+        columns_[index] = {1.0, index};
+    }
+}
+
+bool SpawnSampler::IsEmpty() const noexcept {
+    return columns_.empty();
+}
+
+Position SpawnSampler::GetPosition(double road_pick, double offset_pick) const noexcept {
+    const double scaled = road_pick * static_cast<double>(columns_.size());
+    const size_t column = std::min(static_cast<size_t>(scaled), columns_.size() - 1);
+    // Дробная часть выбора столбца используется как второе случайное число
+    const double coin = scaled - static_cast<double>(column);
+    const auto& [probability, alias] = columns_[column];
+    const auto& segment = segments_[coin < probability ? column : alias];
+    return {segment.start.x + offset_pick * segment.direction.x, segment.start.y + offset_pick * segment.direction.y};
+}
+
+}  // namespace model
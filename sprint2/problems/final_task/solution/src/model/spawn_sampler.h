@@ -0,0 +1,53 @@
+#pragma once
+#include "road.h"
+#include "support_types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace model {
+
+/*Выбор случайной точки на дорогах карты, равномерный по их общей длине: длинная дорога выпадает
+чаще короткой. Дорога выбирается по таблице псевдонимов (метод Уокера-Воуза) за O(1), таблица
+строится один раз при изменении дорог карты. Случайные числа передает вызывающий, поэтому выбор
+не зависит от генератора и воспроизводим.*/
+class SpawnSampler {
+public:
+    SpawnSampler() = default;
+    explicit SpawnSampler(const std::vector<Road>& roads);
+
+    bool IsEmpty() const noexcept;
+    /*road_pick и offset_pick - равномерно распределенные числа из [0, 1). Если у всех дорог нулевая
+    длина, дорога выбирается равновероятно*/
+    Position GetPosition(double road_pick, double offset_pick) const noexcept;
+    /*Пачка из count точек за один проход, например все трофеи сеанса, которые LootGenerator::Generate
+    выдал за тик. next_pick() возвращает очередное число из [0, 1), на точку берется два числа*/
+    template <typename PickSource>
+    void GetPositions(size_t count, PickSource&& next_pick, std::vector<Position>& positions) const {
+        if(IsEmpty()) {
+            return;
+        }
+        positions.reserve(positions.size() + count);
+        for(size_t i = 0; i < count; ++i) {
+            const double road_pick = next_pick();
+            positions.push_back(GetPosition(road_pick, next_pick()));
+        }
+    }
+
+private:
+    // Дорога как начало и вектор до конца, точка на ней - start + offset * direction
+    struct Segment {
+        Position start;
+        Position direction;
+    };
+    // Столбец таблицы: своя дорога выпадает с вероятностью probability, иначе выпадает alias
+    struct Column {
+        double probability;
+        uint32_t alias;
+    };
+
+    std::vector<Segment> segments_;
+    std::vector<Column> columns_;
+};
+
+}  // namespace model
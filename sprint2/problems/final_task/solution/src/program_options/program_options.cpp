@@ -15,9 +15,40 @@ using namespace std::literals;
     desc.add_options()
         ("help,h", "produce help message")
         ("tick-period,t", po::value(&args.tick_period)->value_name("milliseconds"s), "set tick period")
+        ("tick-catch-up", po::value(&args.tick_catch_up)->value_name("steps|coalesce"s),
+            "run overdue ticks one by one (steps) or as one long tick (coalesce)")
+        ("tick-max-catch-up-steps", po::value(&args.tick_max_catch_up_steps)->value_name("count"s),
+            "set max number of overdue ticks to run one by one, the rest are dropped")
+        ("tick-threads", po::value(&args.tick_threads)->value_name("count"s),
+            "set number of threads moving dogs in parallel on tick (0 - move in tick thread)")
+        ("tick-batch-size", po::value(&args.tick_batch_size)->value_name("count"s),
+            "set number of dogs moved by one parallel tick task")
         ("config-file,c", po::value(&args.config_file)->value_name("file"s), "set config file path")
+        ("compile-maps", po::value(&args.compile_maps)->value_name("file"s),
+            "write maps from config file to binary artifact and exit")
+        ("maps-artifact", po::value(&args.maps_artifact)->value_name("file"s),
+            "load maps from binary artifact if it was compiled from the same config file")
         ("www-root,w", po::value(&args.www_root)->value_name("dir"s), "set static files root")
-        ("randomize-spawn-points", po::value(&args.randomize_spawn_points), "spawn dogs at random positions");
+        ("randomize-spawn-points", po::value(&args.randomize_spawn_points), "spawn dogs at random positions")
+        ("random-seed", po::value<uint64_t>()->value_name("number"s),
+            "seed gameplay random generators to reproduce runs (tokens stay unpredictable)")
+        ("idle-timeout", po::value(&args.idle_timeout)->value_name("seconds"s), "set keep-alive connection idle timeout")
+        ("max-requests-per-connection", po::value(&args.max_requests_per_connection)->value_name("count"s),
+            "set max number of requests per keep-alive connection (0 - unlimited)")
+        ("threads", po::value(&args.threads)->value_name("count"s),
+            "set number of worker threads (0 - number of cores not taken by simulation threads)")
+        ("io-context-per-thread", po::bool_switch(&args.io_context_per_thread),
+            "run own io_context and SO_REUSEPORT acceptor in each worker thread")
+        ("pin-threads", po::bool_switch(&args.pin_threads),
+            "pin io_context-per-thread workers to CPU cores not taken by simulation threads")
+        ("simulation-threads", po::value(&args.simulation_threads)->value_name("count"s),
+            "run game sessions on own threads apart from network threads (0 - on network threads)")
+        ("pin-simulation-threads", po::bool_switch(&args.pin_simulation_threads),
+            "pin simulation threads to the last CPU cores")
+        ("compression", po::bool_switch(&args.compression), "compress game state and players responses (gzip/deflate)")
+        ("compression-level", po::value(&args.compression_level)->value_name("1-9"s), "set zlib compression level")
+        ("compression-min-size", po::value(&args.compression_min_size)->value_name("bytes"s),
+            "set minimal response body size to compress");
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
     po::notify(vm);
@@ -27,6 +58,10 @@ using namespace std::literals;
         std::exit(0);
     }
 
+    if (vm.contains("random-seed"s)) {
+        args.random_seed = vm["random-seed"s].as<uint64_t>();
+    }
+
     if (!vm.contains("config-file"s)) {
         std::string error_msg = "Config file have not been specified"s;
         BOOST_LOG_TRIVIAL(error) << logware::CreateLogMessage(error_msg,
@@ -34,7 +69,8 @@ using namespace std::literals;
         throw ConfigFileNotSpecifiedException();
     }
 
-    if (!vm.contains("www-root"s)) {
+    // Сборке артефакта карт статический контент не нужен
+    if (!vm.contains("www-root"s) && !vm.contains("compile-maps"s)) {
         std::string error_msg = "Static content path is not specified"s;
         BOOST_LOG_TRIVIAL(error) << logware::CreateLogMessage(error_msg,
                                                             logware::ExitCodeLogData(EXIT_FAILURE));
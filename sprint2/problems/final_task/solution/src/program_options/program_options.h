@@ -1,14 +1,34 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 
 namespace prog_opt {
 
 struct Args {
     size_t tick_period{0};
+    std::string tick_catch_up{"steps"};
+    size_t tick_max_catch_up_steps{5};
+    size_t tick_threads{0};
+    size_t tick_batch_size{256};
     std::string config_file;
+    std::string compile_maps;
+    std::string maps_artifact;
     std::string www_root;
     bool randomize_spawn_points{false};
+    // Зерно генераторов игровых сеансов, без него генераторы засеваются из std::random_device
+    std::optional<uint64_t> random_seed;
+    size_t idle_timeout{30};
+    size_t max_requests_per_connection{0};
+    size_t threads{0};
+    bool io_context_per_thread{false};
+    bool pin_threads{false};
+    size_t simulation_threads{0};
+    bool pin_simulation_threads{false};
+    bool compression{false};
+    int compression_level{6};
+    size_t compression_min_size{1024};
 };
 
 [[nodiscard]] Args ParseCommandLine(int argc, const char* const argv[]);
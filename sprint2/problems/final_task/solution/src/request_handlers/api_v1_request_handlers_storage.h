@@ -3,96 +3,184 @@
 #include "player_tokens.h"
 #include "json_converter.h"
 #include "request_handlers_utils.h"
+#include "request_context.h"
+#include "response_cache.h"
 #include "api_url_storage.h"
+#include "metrics.h"
+#include "http_compression.h"
 
 #include <vector>
 #include <optional>
 #include <boost/beast/http.hpp>
 #include <chrono>
-#include <unordered_set>
+#include <tuple>
 
 namespace rh_storage{
 
 namespace net = boost::asio;
 namespace beast = boost::beast;
 namespace http = beast::http;
-using StringResponse = http::response<http::string_body>;
-
-const size_t SIZE_OF_TWO_SEGMENT_URL = 2;
-const size_t SIZE_OF_THREE_SEGMENT_URL = 3;
-const size_t SIZE_OF_FOUR_SEGMENT_URL = 4;
-const size_t SIZE_OF_FIVE_SEGMENT_URL = 5;
-
-const std::unordered_set<std::string_view> GAME_API_URLS_WITH_AUTHORIZATION = {
-    api_urls::GET_PLAYERS_LIST_API,
-    api_urls::GET_PLAYERS_LIST_API + "/",
-    api_urls::GET_GAME_STATE_API,
-    api_urls::GET_GAME_STATE_API + "/",
-    api_urls::MAKE_ACTION_API,
-    api_urls::MAKE_ACTION_API + "/"
-};
 
-const std::unordered_set<std::string_view> GAME_API_URLS_WITH_JSON_REQ = {
-    api_urls::JOIN_TO_GAME_API,
-    api_urls::JOIN_TO_GAME_API + "/",
-    api_urls::MAKE_ACTION_API,
-    api_urls::MAKE_ACTION_API + "/"
-};
+const std::string CONTENT_TYPE_PROMETHEUS_TEXT = "text/plain; version=0.0.4";
+const size_t MAP_ID_SEGMENT_INDEX = 3;
+
+
+// Ответ создается с аллокатором запроса, поэтому его заголовки и тело размещаются в арене запроса
+template <typename Request>
+auto MakeStringResponse(const Request& req, http::status status) {
+    using Allocator = std::decay_t<decltype(req.get_allocator())>;
+    using Body = http::basic_string_body<char, std::char_traits<char>, Allocator>;
+    return http::response< Body, http::basic_fields<Allocator> >(status, req.version(),
+                                                                 req.get_allocator(), req.get_allocator());
+}
+
+
+// Отправляет заранее сериализованный ответ, если он есть для версии HTTP запроса
+template <typename Request, typename Send>
+bool SendPreparedResponse(const Request& req, const http_server::PreparedResponsePtr& prepared, Send&& send) {
+    if(!prepared || req.version() != http_server::PreparedResponse::HTTP_VERSION) {
+        return false;
+    }
+    send(http_server::PreparedResponseRef{prepared, req.keep_alive()});
+    return true;
+}
+
+/*Отправляет тело из снимка игрового сеанса в кодировке, которую принимает клиент.
+Сжатый вариант и его ETag создаются первым запросом в этой кодировке, следующие его только копируют.
+Если ETag варианта совпал с If-None-Match, отправляется 304 без тела*/
+template <typename Request, typename Send>
+void SendSnapshotBody(const Request& req, const app::SnapshotBody& body, Send&& send) {
+    const auto& compressor = utils::ResponseCompressor::GetInstance();
+    const auto encoding = compressor.Negotiate(req[http::field::accept_encoding], body.GetIdentity().data.size());
+    const auto& encoded = body.Get(encoding);
+    const bool not_modified = IsEtagMatched(req[http::field::if_none_match], encoded.etag);
+    auto response = MakeStringResponse(req, not_modified ? http::status::not_modified : http::status::ok);
+    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
+    response.set(http::field::cache_control, NO_CACHE_CONTROL);
+    response.set(http::field::etag, encoded.etag);
+    if(compressor.IsEnabled()) {
+        // Ответ зависит от Accept-Encoding, даже если сжатие не применилось
+        response.set(http::field::vary, http::to_string(http::field::accept_encoding));
+    }
+    if(!not_modified) {
+        if(&encoded != &body.GetIdentity()) {
+            response.set(http::field::content_encoding, utils::GetContentEncodingName(encoding));
+            compressor.CountCompressedResponse(body.GetIdentity().data.size(), encoded.data.size());
+        }
+        response.body().assign(encoded.data.data(), encoded.data.size());
+        response.content_length(response.body().size());
+    }
+    response.keep_alive(req.keep_alive());
+    send(response);
+}
+
+/*Отвечает по снимку игрового сеанса. Обычно снимок читается сразу в потоке соединения.
+Если после входа игроков он еще не опубликован, запрос переходит в strand сеанса
+и публикует снимок там, чтобы вошедший игрок сразу видел себя в ответе*/
+template <typename Request, typename Send>
+void SendSessionSnapshot(const Request& req, std::shared_ptr<app::GameSession> session,
+                         app::SnapshotBody app::GameSessionSnapshot::* body, Send&& send) {
+    if(!session->IsSnapshotStale()) {
+        SendSnapshotBody(req, (*session->GetSnapshot()).*body, send);
+        return;
+    }
+    auto& strand = *session->GetStrand();
+    net::dispatch(strand, [req = req, session = std::move(session), body, send = std::forward<Send>(send)]() mutable {
+        SendSnapshotBody(req, (*session->GetFreshSnapshot()).*body, send);
+    });
+}
+
+/*Отправляет закэшированный ресурс: 304 без тела, если ETag совпал с If-None-Match,
+иначе готовый ответ 200. Возвращает false, если ответ 200 нужно сформировать обычным образом*/
+template <typename Request, typename Send>
+bool SendCachedResource(const Request& req, const CachedResource* resource, Send&& send) {
+    if(resource == nullptr) {
+        return false;
+    }
+    if(IsEtagMatched(req[http::field::if_none_match], resource->etag)) {
+        if(!SendPreparedResponse(req, resource->not_modified_response, send)) {
+            auto response = MakeStringResponse(req, http::status::not_modified);
+            SetCacheHeaders(response, resource);
+            response.keep_alive(req.keep_alive());
+            send(response);
+        }
+        return true;
+    }
+    return SendPreparedResponse(req, resource->ok_response, send);
+}
+
+template <typename Request, typename Send>
+void SendConstantResponse(const Request& req, ConstantResponse id, Send&& send) {
+    if(SendPreparedResponse(req, ResponseCache::GetInstance().GetConstantResponse(id), send)) {
+        return;
+    }
+    auto response = MakeStringResponse(req, GetConstantResponseDescription(id).status);
+    FillConstantResponse(response, GetConstantResponseDescription(id));
+    response.keep_alive(req.keep_alive());
+    send(response);
+}
 
-const std::string CONTENT_TYPE_APPLICATION_JSON = "application/json";
-const std::string NO_CACHE_CONTROL = "no-cache";
 
+/*Условия стадий маршрутизатора. URL уже сопоставлен деревом путей, а тело запроса
+и токен разобраны один раз при построении RequestContext.*/
+template <typename Request>
+bool HasInvalidContentType(const Request& req, const RequestContext& context) {
+    return req[http::field::content_type].empty() ||
+            req[http::field::content_type] != CONTENT_TYPE_APPLICATION_JSON;
+}
 
 template <typename Request>
-bool BadRequestActivator(const Request& req) {
-    auto url = SplitUrl(req.target());
-    return !url.empty() &&
-            url[0] == "api" &&
-            (
-                url.size() > SIZE_OF_FIVE_SEGMENT_URL ||
-                url.size() < SIZE_OF_THREE_SEGMENT_URL ||
-                (url.size() >= SIZE_OF_TWO_SEGMENT_URL && 
-                    url[1] != "v1") ||
-                (url.size() >= SIZE_OF_THREE_SEGMENT_URL &&
-                    url[2] != "maps" &&
-                    url[2] != "game" &&
-                    url[3] != "join" &&
-                    url[3] != "players" &&
-                    url[3] != "state" &&
-                    url[3] != "player" &&
-                    url[3] != "tick" &&
-                    (url.size() == SIZE_OF_FIVE_SEGMENT_URL && url[4] != "action"))
-            ); // todo: need refactor
-};
+bool HasEmptyAuthorization(const Request& req, const RequestContext& context) {
+    return !context.token.has_value();
+}
+
+template <typename Request>
+bool HasInvalidJoinToGameBody(const Request& req, const RequestContext& context) {
+    return !context.join_to_game.has_value();
+}
+
+template <typename Request>
+bool HasEmptyPlayerName(const Request& req, const RequestContext& context) {
+    return context.join_to_game.has_value() && std::get<0>(*context.join_to_game).empty();
+}
+
+template <typename Request>
+bool HasInvalidPlayerAction(const Request& req, const RequestContext& context) {
+    return !context.player_action.has_value() ||
+            !model::STRING_TO_DIRECTION.contains(*context.player_action);
+}
+
+template <typename Request>
+bool HasInvalidSetDeltaTimeBody(const Request& req, const RequestContext& context) {
+    return !context.delta_time.has_value();
+}
+
 
 template <typename Request, typename Send>
 std::optional<size_t> BadRequestHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.body() = json_converter::CreateBadRequestResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::BAD_REQUEST, send);
     return std::nullopt;
 };
 
 
-template <typename Request>
-bool GetMapListActivator(const Request& req) {
-    return IsEqualUrls(api_urls::GET_MAPS_LIST_API, req.target());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> GetMapListHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::ok, req.version());
+    const auto* resource = ResponseCache::GetInstance().GetMapListResource();
+    if(SendCachedResource(req, resource, send)) {
+        return std::nullopt;
+    }
+    auto response = MakeStringResponse(req, http::status::ok);
     response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
+    SetCacheHeaders(response, resource);
     response.body() = json_converter::ConvertMapListToJson(application.ListMap());
     response.content_length(response.body().size());
     response.keep_alive(req.keep_alive());
@@ -101,28 +189,25 @@ std::optional<size_t> GetMapListHandler(
 }
 
 
-template <typename Request>
-bool GetMapByIdActivator(const Request& req) {
-    auto url = SplitUrl(req.target());
-    return url.size() == SIZE_OF_FOUR_SEGMENT_URL &&
-            url[0] == "api" &&
-            url[1] == "v1" &&
-            url[2] == "maps";
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> GetMapByIdHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    auto id = SplitUrl(req.target())[3];
+    auto id = context.url.Get(req.target(), MAP_ID_SEGMENT_INDEX);
+    const auto* resource = ResponseCache::GetInstance().FindMapResource(id);
+    if(SendCachedResource(req, resource, send)) {
+        return std::nullopt;
+    }
     auto map = application.FindMap(model::Map::Id(std::string(id)));
     if(map == nullptr) {
         return 0;
     }
-    http::response<http::string_body> response(http::status::ok, req.version());
+    auto response = MakeStringResponse(req, http::status::ok);
     response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
+    SetCacheHeaders(response, resource);
     response.body() = json_converter::ConvertMapToJson(*map);
     response.content_length(response.body().size());
     response.keep_alive(req.keep_alive());
@@ -133,90 +218,54 @@ std::optional<size_t> GetMapByIdHandler(
 template <typename Request, typename Send>
 std::optional<size_t> MapNotFoundHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send)                                                                                                                                                                          {
-    StringResponse response(http::status::not_found, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.body() = json_converter::CreateMapNotFoundResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::MAP_NOT_FOUND, send);
     return std::nullopt;
 };
 
 
-template <typename Request>
-bool JoinToGameInvalidJsonReqActivator(const Request& req) {
-    return IsEqualUrls(api_urls::JOIN_TO_GAME_API, req.target()) &&
-        !json_converter::ParseJoinToGameRequest(req.body());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> JoinToGameInvalidJsonReqHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateJoinToGameInvalidArgumentResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::JOIN_TO_GAME_INVALID_ARGUMENT, send);
     return std::nullopt;
 }
 
 
-template <typename Request>
-bool JoinToGameEmptyPlayerNameActivator(const Request& req) {
-    if(IsEqualUrls(api_urls::JOIN_TO_GAME_API, req.target())) {
-        auto res = json_converter::ParseJoinToGameRequest(req.body());
-        if(!res) {
-            return false;
-        }
-        auto [player_name, map_id] = res.value();
-        return player_name.empty();
-    }
-    return false;
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> JoinToGameEmptyPlayerNameHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateJoinToGameEmptyPlayerNameResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::JOIN_TO_GAME_EMPTY_PLAYER_NAME, send);
     return std::nullopt;
 }
 
 
-template <typename Request>
-bool JoinToGameActivator(const Request& req) {
-    return IsEqualUrls(api_urls::JOIN_TO_GAME_API, req.target());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> JoinToGameHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    auto [player_name, map_id] = json_converter::ParseJoinToGameRequest(req.body()).value();
-    if(application.FindMap(map_id) == nullptr) {
+    if(application.FindMap(std::get<1>(*context.join_to_game)) == nullptr) {
         return 0;
     }
-    net::dispatch(*application.GetStrand(), [req = std::move(req), application = &application, send = std::move(send)]{
-        auto [player_name, map_id] = json_converter::ParseJoinToGameRequest(req.body()).value();
-        auto [token, player_id] = application->JoinGame(player_name, map_id);
-        StringResponse response(http::status::ok, req.version());
+    const auto& [player_name, map_id] = *context.join_to_game;
+    application.JoinGame(player_name, map_id, [req = std::move(req), send = std::move(send)](const app::JoinGameResult& result){
+        auto response = MakeStringResponse(req, http::status::ok);
         response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
         response.set(http::field::cache_control, NO_CACHE_CONTROL);
-        response.body() = json_converter::CreateJoinToGameResponse(*token, *player_id);
+        response.body() = json_converter::CreateJoinToGameResponse(*result.token, *result.player->GetId());
         response.content_length(response.body().size());
         response.keep_alive(req.keep_alive());
         send(response);
@@ -227,206 +276,118 @@ std::optional<size_t> JoinToGameHandler(
 template <typename Request, typename Send>
 std::optional<size_t> JoinToGameMapNotFoundHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::not_found, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateJoinToGameMapNotFoundResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::JOIN_TO_GAME_MAP_NOT_FOUND, send);
     return std::nullopt;
 }
 
 template <typename Request, typename Send>
 std::optional<size_t> OnlyPostMethodAllowedHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::method_not_allowed, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.set(http::field::allow, "POST");
-    response.body() = json_converter::CreateOnlyPostMethodAllowedResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::ONLY_POST_METHOD_ALLOWED, send);
     return std::nullopt;
 };
 
 
-template <typename Request>
-bool EmptyAuthorizationActivator(const Request& req) {
-    return (GAME_API_URLS_WITH_AUTHORIZATION.count(req.target()) > 0) &&
-            (req[http::field::authorization].empty() ||
-            GetTokenString(req[http::field::authorization]).empty());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> EmptyAuthorizationHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::unauthorized, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateEmptyAuthorizationResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::EMPTY_AUTHORIZATION, send);
     return std::nullopt;
 }
 
 
-template <typename Request>
-bool GetPlayersListActivator(const Request& req) {
-    return IsEqualUrls(api_urls::GET_PLAYERS_LIST_API, req.target());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> GetPlayersListHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    authentication::Token token{GetTokenString(req[http::field::authorization])};
-    if(!application.IsExistPlayer(token)) {
+    auto player = application.FindPlayerBy(*context.token);
+    if(player == nullptr) {
         return 0;
     }
-    net::dispatch(*application.GetStrand(), [req = std::move(req), application = &application, send = std::move(send)]{
-        authentication::Token token{GetTokenString(req[http::field::authorization])};
-        auto players = application->GetPlayersFromGameSession(token);
-        StringResponse response(http::status::ok, req.version());
-        response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-        response.set(http::field::cache_control, NO_CACHE_CONTROL);
-        response.body() = json_converter::CreatePlayersListOnMapResponse(players);
-        response.content_length(response.body().size());
-        response.keep_alive(req.keep_alive());
-        send(response);
-    });
+    SendSessionSnapshot(req, player->GetGameSession(), &app::GameSessionSnapshot::players_list, std::forward<Send>(send));
     return std::nullopt;
 }
 
 template <typename Request, typename Send>
 std::optional<size_t> InvalidMethodHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::method_not_allowed, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.set(http::field::allow, "GET, HEAD");
-    response.body() = json_converter::CreateInvalidMethodResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::INVALID_METHOD, send);
     return std::nullopt;
 };
 
 
-template <typename Request>
-bool GetGameStateActivator(const Request& req) {
-    return IsEqualUrls(api_urls::GET_GAME_STATE_API, req.target());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> GetGameStateHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    authentication::Token token{GetTokenString(req[http::field::authorization])};
-    if(!application.IsExistPlayer(token)) {
+    auto player = application.FindPlayerBy(*context.token);
+    if(player == nullptr) {
         return 0;
     }
-    net::dispatch(*application.GetStrand(), [req = std::move(req), application = &application, send = std::move(send)]{
-        authentication::Token token{GetTokenString(req[http::field::authorization])};
-        auto players = application->GetPlayersFromGameSession(token);
-        StringResponse response(http::status::ok, req.version());
-        response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-        response.set(http::field::cache_control, NO_CACHE_CONTROL);
-        response.body() = json_converter::CreateGameStateResponse(players);
-        response.content_length(response.body().size());
-        response.keep_alive(req.keep_alive());
-        send(response);
-    });
+    SendSessionSnapshot(req, player->GetGameSession(), &app::GameSessionSnapshot::state, std::forward<Send>(send));
     return std::nullopt;
 }
 
 
-template <typename Request>
-bool InvalidContentTypeActivator(const Request& req) {
-    return (GAME_API_URLS_WITH_JSON_REQ.count(req.target()) > 0) &&
-            (req[http::field::content_type].empty() ||
-            req[http::field::content_type] != CONTENT_TYPE_APPLICATION_JSON);
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> InvalidContentTypeHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateInvalidContentTypeResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::INVALID_CONTENT_TYPE, send);
     return std::nullopt;
 }
 
-template <typename Request>
-bool PlayerActionInvalidActionActivator(const Request& req) {
-    if(IsEqualUrls(api_urls::MAKE_ACTION_API, req.target())) {
-        auto res = json_converter::ParsePlayerActionRequest(req.body());
-        if(res.has_value()) {
-            return !model::STRING_TO_DIRECTION.contains(res.value());
-        }
-    }
-    return false;
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> PlayerActionInvalidActionHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreatePlayerActionInvalidActionResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::PLAYER_ACTION_INVALID_ACTION, send);
     return std::nullopt;
 }
 
-template <typename Request>
-bool PlayerActionActivator(const Request& req) {
-    return IsEqualUrls(api_urls::MAKE_ACTION_API, req.target());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> PlayerActionHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    authentication::Token token{GetTokenString(req[http::field::authorization])};
-    if(!application.IsExistPlayer(token)) {
+    auto player = application.FindPlayerBy(*context.token);
+    if(player == nullptr) {
         return 0;
     }
-    net::dispatch(*application.GetStrand(), [req = std::move(req), application = &application, send = std::move(send)]{
-        authentication::Token token{GetTokenString(req[http::field::authorization])};
-        std::string directionStr = json_converter::ParsePlayerActionRequest(req.body()).value();
-        application->SetPlayerAction(token, model::STRING_TO_DIRECTION.at(directionStr));
-        StringResponse response(http::status::ok, req.version());
-        response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-        response.set(http::field::cache_control, NO_CACHE_CONTROL);
-        response.body() = json_converter::CreatePlayerActionResponse();
-        response.content_length(response.body().size());
-        response.keep_alive(req.keep_alive());
-        send(response);
-    });
+    // Команда применится в начале следующего тика сеанса, ответ отправляется сразу
+    auto direction = model::STRING_TO_DIRECTION.at(*context.player_action);
+    if(!player->GetGameSession()->PushAction(*player, direction)) {
+        SendConstantResponse(req, ConstantResponse::PLAYER_ACTION_QUEUE_OVERFLOW, send);
+        return std::nullopt;
+    }
+    SendConstantResponse(req, ConstantResponse::PLAYER_ACTION, send);
     return std::nullopt;
 }
 
@@ -434,15 +395,10 @@ std::optional<size_t> PlayerActionHandler(
 template <typename Request, typename Send>
 std::optional<size_t> UnknownTokenHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::unauthorized, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateUnknownTokenResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::UNKNOWN_TOKEN, send);
     return std::nullopt;
 }
 
@@ -450,70 +406,43 @@ std::optional<size_t> UnknownTokenHandler(
 template <typename Request, typename Send>
 std::optional<size_t> PageNotFoundHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::not_found, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.body() = json_converter::CreatePageNotFoundResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::PAGE_NOT_FOUND, send);
     return std::nullopt;
 };
 
 
-template <typename Request>
-bool TimeTickInvalidMsgActivator(const Request& req) {
-    if(IsEqualUrls(api_urls::MAKE_TIME_TICK_API, req.target())) {
-        auto res = json_converter::ParseSetDeltaTimeRequest(req.body());
-        return !res.has_value();
-    }
-    return false;
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> TimeTickInvalidMsgHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
     if(!application.IsManualTimeManagement()) {
         return 0;
     }
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-    response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateSetDeltaTimeInvalidMsgResponse();
-    response.content_length(response.body().size());
-    response.keep_alive(req.keep_alive());
-    send(response);
+    SendConstantResponse(req, ConstantResponse::SET_DELTA_TIME_INVALID_MSG, send);
     return std::nullopt;
 }
 
 
-template <typename Request>
-bool TimeTickActivator(const Request& req) {
-    return IsEqualUrls(api_urls::MAKE_TIME_TICK_API, req.target());
-}
 
 template <typename Request, typename Send>
 std::optional<size_t> TimeTickHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
     if(!application.IsManualTimeManagement()) {
         return 0;
     }
-    net::dispatch(*application.GetStrand(), [req = std::move(req), application = &application, send = std::move(send)]{
-        int delta_time = json_converter::ParseSetDeltaTimeRequest(req.body()).value();
-        std::chrono::milliseconds dtime(delta_time);
-        application->UpdateGameState(dtime);
-        StringResponse response(http::status::ok, req.version());
-        response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
-        response.set(http::field::cache_control, NO_CACHE_CONTROL);
-        response.body() = json_converter::CreateSetDeltaTimeResponse();
-        response.content_length(response.body().size());
-        response.keep_alive(req.keep_alive());
-        send(response);
+    // Ответ отправляется после того, как обновятся все сеансы
+    std::chrono::milliseconds dtime(*context.delta_time);
+    application.UpdateGameState(dtime, [req = std::move(req), send = std::move(send)]{
+        SendConstantResponse(req, ConstantResponse::SET_DELTA_TIME, send);
     });
     return std::nullopt;
 }
@@ -521,12 +450,29 @@ std::optional<size_t> TimeTickHandler(
 template <typename Request, typename Send>
 std::optional<size_t> InvalidEndpointHandler(
         const Request& req,
+        const RequestContext& context,
         app::Application& application,
         Send&& send) {
-    StringResponse response(http::status::bad_request, req.version());
-    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
+    SendConstantResponse(req, ConstantResponse::INVALID_ENDPOINT, send);
+    return std::nullopt;
+}
+
+
+template <typename Request>
+bool GetMetricsActivator(const Request& req) {
+    return IsEqualUrls(api_urls::METRICS_API, req.target());
+}
+
+template <typename Request, typename Send>
+std::optional<size_t> GetMetricsHandler(
+        const Request& req,
+        const RequestContext& context,
+        app::Application& application,
+        Send&& send) {
+    auto response = MakeStringResponse(req, http::status::ok);
+    response.set(http::field::content_type, CONTENT_TYPE_PROMETHEUS_TEXT);
     response.set(http::field::cache_control, NO_CACHE_CONTROL);
-    response.body() = json_converter::CreateInvalidEndpointResponse();
+    response.body() = metrics::Registry::GetInstance().Serialize();
     response.content_length(response.body().size());
     response.keep_alive(req.keep_alive());
     send(response);
@@ -0,0 +1,171 @@
+#pragma once
+#include "api_v1_request_handlers_storage.h"
+#include "request_context.h"
+#include "url_radix_tree.h"
+
+#include <array>
+#include <initializer_list>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rh_storage{
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+/*Стадия маршрута. Если условие стадии выполнено (пустое условие выполняется всегда),
+обработчик выбирается по методу запроса из таблицы, индексируемой значением http::verb.
+Обработчик может вернуть индекс аварийного обработчика стадии, как в RequestHandlerNode.*/
+template<typename Guard, typename Handler>
+class RouteStage {
+public:
+    RouteStage(Guard guard,
+                std::initializer_list< std::pair<http::verb, Handler> > handlers,
+                Handler not_allowed_handler,
+                std::vector<Handler>&& emerge_handlers = std::vector<Handler>()) :
+        guard_(guard),
+        emerge_handlers_(std::move(emerge_handlers)) {
+        handlers_.fill(not_allowed_handler);
+        for(const auto& [method, handler] : handlers) {
+            handlers_[static_cast<size_t>(method)] = handler;
+        }
+    };
+
+    bool IsActive(const auto& req, const RequestContext& context) const {
+        return guard_ == nullptr || guard_(req, context);
+    };
+
+    Handler GetHandler(http::verb method) const {
+        auto index = static_cast<size_t>(method);
+        return index < handlers_.size() ? handlers_[index] : handlers_[static_cast<size_t>(http::verb::unknown)];
+    };
+
+    Handler GetEmergeHandlerByIndex(size_t index) const {
+        if(index < emerge_handlers_.size()) {
+            return emerge_handlers_[index];
+        }
+        return nullptr;
+    };
+
+private:
+    static constexpr size_t VERBS_COUNT = static_cast<size_t>(http::verb::unlink) + 1;
+
+    Guard guard_;
+    std::array<Handler, VERBS_COUNT> handlers_;
+    std::vector<Handler> emerge_handlers_;
+};
+
+/*Маршрутизатор API v1. Путь запроса сопоставляется с деревом путей, построенным один раз,
+затем строится RequestContext с телом, которое ожидает маршрут, и по порядку проверяются
+стадии найденного маршрута.*/
+template<typename Request, typename Send>
+class ApiV1Router{
+    using GuardType = bool(*)(const Request&, const RequestContext&);
+    using HandlerType = std::optional<size_t>(*)(const Request&, const RequestContext&, app::Application&, Send&&);
+    using Stage = RouteStage<GuardType, HandlerType>;
+
+    struct Route {
+        RequestBodyType body_type;
+        std::vector<Stage> stages;
+    };
+public:
+    // убираем конструктор копирования
+    ApiV1Router(const ApiV1Router&) = delete;
+    ApiV1Router& operator=(const ApiV1Router&) = delete;
+    ApiV1Router(ApiV1Router&&) = delete;
+    ApiV1Router& operator=(ApiV1Router&&) = delete;
+
+    // получение ссылки на единственный объект
+    static ApiV1Router& GetInstance() {
+        static ApiV1Router obj;
+        return obj;
+    };
+
+    // Возвращает false, если путь не найден: такой запрос обрабатывается как некорректный
+    bool Execute(const Request& req, app::Application& application, Send&& send) const {
+        const Route* route = routes_.Find(req.target());
+        if(route == nullptr) {
+            return false;
+        }
+        auto context = MakeRequestContext(req.target(), req[http::field::authorization], req.body(), route->body_type);
+        for(const auto& stage : route->stages) {
+            if(stage.IsActive(req, context)) {
+                auto res = stage.GetHandler(req.method())(req, context, application, std::forward<Send>(send));
+                while(res.has_value()){
+                    res = stage.GetEmergeHandlerByIndex(res.value())(req, context, application, std::forward<Send>(send));
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+private:
+    UrlRadixTree<Route> routes_;
+
+    // Маршрут доступен как без завершающего "/", так и с ним
+    void AddRoute(const std::string& url, RequestBodyType body_type, std::vector<Stage> stages) {
+        Route route{body_type, std::move(stages)};
+        routes_.Insert(url, route);
+        routes_.Insert(url + "/", route);
+    }
+
+    ApiV1Router() {
+        const Stage invalid_content_type_stage(HasInvalidContentType,
+                                                {{http::verb::post, InvalidContentTypeHandler}},
+                                                InvalidContentTypeHandler);
+        const Stage empty_authorization_stage(HasEmptyAuthorization,
+                                                {{http::verb::get, EmptyAuthorizationHandler},
+                                                {http::verb::head, EmptyAuthorizationHandler}},
+                                                InvalidMethodHandler);
+
+        AddRoute(api_urls::GET_MAPS_LIST_API, RequestBodyType::NONE, {
+            Stage(nullptr, {{http::verb::get, GetMapListHandler}}, BadRequestHandler)
+        });
+        routes_.Insert(api_urls::GET_MAPS_LIST_API + "/{id}", Route{RequestBodyType::NONE, {
+            Stage(nullptr, {{http::verb::get, GetMapByIdHandler}}, BadRequestHandler, {MapNotFoundHandler})
+        }});
+
+        AddRoute(api_urls::JOIN_TO_GAME_API, RequestBodyType::JOIN_TO_GAME, {
+            invalid_content_type_stage,
+            Stage(HasInvalidJoinToGameBody, {{http::verb::post, JoinToGameInvalidJsonReqHandler}},
+                    OnlyPostMethodAllowedHandler),
+            Stage(HasEmptyPlayerName, {{http::verb::post, JoinToGameEmptyPlayerNameHandler}},
+                    OnlyPostMethodAllowedHandler),
+            Stage(nullptr, {{http::verb::post, JoinToGameHandler}},
+                    OnlyPostMethodAllowedHandler, {JoinToGameMapNotFoundHandler})
+        });
+
+        AddRoute(api_urls::GET_PLAYERS_LIST_API, RequestBodyType::NONE, {
+            empty_authorization_stage,
+            Stage(nullptr, {{http::verb::get, GetPlayersListHandler}, {http::verb::head, GetPlayersListHandler}},
+                    InvalidMethodHandler, {UnknownTokenHandler})
+        });
+        AddRoute(api_urls::GET_GAME_STATE_API, RequestBodyType::NONE, {
+            empty_authorization_stage,
+            Stage(nullptr, {{http::verb::get, GetGameStateHandler}, {http::verb::head, GetGameStateHandler}},
+                    InvalidMethodHandler, {UnknownTokenHandler})
+        });
+
+        AddRoute(api_urls::MAKE_ACTION_API, RequestBodyType::PLAYER_ACTION, {
+            invalid_content_type_stage,
+            empty_authorization_stage,
+            Stage(HasInvalidPlayerAction, {{http::verb::post, PlayerActionInvalidActionHandler}},
+                    OnlyPostMethodAllowedHandler),
+            Stage(nullptr, {{http::verb::post, PlayerActionHandler}},
+                    InvalidMethodHandler, {UnknownTokenHandler})
+        });
+
+        AddRoute(api_urls::MAKE_TIME_TICK_API, RequestBodyType::SET_DELTA_TIME, {
+            Stage(HasInvalidSetDeltaTimeBody, {{http::verb::post, TimeTickInvalidMsgHandler}},
+                    InvalidMethodHandler, {InvalidEndpointHandler}),
+            Stage(nullptr, {{http::verb::post, TimeTickHandler}},
+                    InvalidMethodHandler, {InvalidEndpointHandler})
+        });
+
+        routes_.Compress();
+    };
+};
+
+}
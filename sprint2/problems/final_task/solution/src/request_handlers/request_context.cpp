@@ -0,0 +1,57 @@
+#include "request_context.h"
+#include "request_handlers_utils.h"
+
+namespace rh_storage{
+
+UrlSegments::UrlSegments(std::string_view target) noexcept {
+    if(target.empty() || target.front() != '/') {
+        return;
+    }
+    size_t begin = 1; // Ignore first slash
+    while(size_ < MAX_SEGMENTS) {
+        auto end = target.find('/', begin);
+        auto size = (end == std::string_view::npos ? target.size() : end) - begin;
+        segments_[size_++] = Segment{static_cast<uint32_t>(begin), static_cast<uint32_t>(size)};
+        if(end == std::string_view::npos) {
+            break;
+        }
+        begin = end + 1;
+    }
+};
+
+std::string_view UrlSegments::Get(std::string_view target, size_t index) const noexcept {
+    if(index >= size_) {
+        return {};
+    }
+    return target.substr(segments_[index].begin, segments_[index].size);
+};
+
+RequestContext MakeRequestContext(std::string_view target,
+                                    std::string_view authorization,
+                                    std::string_view body,
+                                    RequestBodyType body_type) {
+    RequestContext context;
+    context.url = UrlSegments(target);
+    if(!authorization.empty()) {
+        auto token = GetTokenString(authorization);
+        if(!token.empty()) {
+            context.token = authentication::Token{std::move(token)};
+        }
+    }
+    switch(body_type) {
+        case RequestBodyType::JOIN_TO_GAME:
+            context.join_to_game = json_converter::ParseJoinToGameRequest(body);
+            break;
+        case RequestBodyType::PLAYER_ACTION:
+            context.player_action = json_converter::ParsePlayerActionRequest(body);
+            break;
+        case RequestBodyType::SET_DELTA_TIME:
+            context.delta_time = json_converter::ParseSetDeltaTimeRequest(body);
+            break;
+        case RequestBodyType::NONE:
+            break;
+    }
+    return context;
+};
+
+}
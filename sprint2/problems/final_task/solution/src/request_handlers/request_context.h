@@ -0,0 +1,64 @@
+#pragma once
+#include "json_converter.h"
+#include "player_tokens.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace rh_storage{
+
+// Тело запроса, которое ожидает маршрут
+enum class RequestBodyType {
+    NONE,
+    JOIN_TO_GAME,
+    PLAYER_ACTION,
+    SET_DELTA_TIME
+};
+
+/*Сегменты пути запроса. Вместо string_view хранятся смещения в target: контекст копируется
+вместе с запросом в strand игрового сеанса, и указатели на исходный запрос там недействительны.*/
+class UrlSegments {
+public:
+    static constexpr size_t MAX_SEGMENTS = 8;
+
+    UrlSegments() = default;
+    explicit UrlSegments(std::string_view target) noexcept;
+
+    size_t Size() const noexcept {
+        return size_;
+    };
+
+    // Возвращает сегмент с номером index или пустую строку, если такого сегмента нет
+    std::string_view Get(std::string_view target, size_t index) const noexcept;
+
+private:
+    struct Segment {
+        uint32_t begin = 0;
+        uint32_t size = 0;
+    };
+
+    std::array<Segment, MAX_SEGMENTS> segments_;
+    size_t size_ = 0;
+};
+
+/*Данные запроса, разобранные один раз перед выбором обработчика. Условия стадий и обработчики
+читают их вместо повторного разбора заголовков и тела. Пустое значение поля тела означает,
+что тело не ожидалось маршрутом или не прошло проверку.*/
+struct RequestContext {
+    UrlSegments url;
+    std::optional<authentication::Token> token;
+    std::optional< std::tuple<std::string, model::Map::Id> > join_to_game;
+    std::optional<std::string> player_action;
+    std::optional<int> delta_time;
+};
+
+RequestContext MakeRequestContext(std::string_view target,
+                                    std::string_view authorization,
+                                    std::string_view body,
+                                    RequestBodyType body_type);
+
+}
@@ -1,7 +1,7 @@
 #pragma once
 #include "http_server.h"
 #include "application.h"
-#include "api_v1_request_handlers_executor.h"
+#include "api_v1_router.h"
 #include "static_file_request_handlers_executor.h"
 
 #include <filesystem>
@@ -17,12 +17,10 @@ using namespace std::string_literals;
 
 class RequestHandler {
 public:
-    explicit RequestHandler(app::Application& application, fs::path static_content_root_path, net::io_context& io)
-        : application_{application}, static_content_root_path_{static_content_root_path},io_{io},strand_{net::make_strand(io_)} {
+    explicit RequestHandler(app::Application& application, fs::path static_content_root_path)
+        : application_{application}, static_content_root_path_{static_content_root_path} {
     }
 
-    using Strand = net::strand<net::io_context::executor_type>;
-
     RequestHandler(const RequestHandler&) = delete;
     RequestHandler& operator=(const RequestHandler&) = delete;
 
@@ -33,13 +31,21 @@ public:
     void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {// 
         // Обработать запрос request и отправить ответ, используя send
 
+        if(rh_storage::GetMetricsActivator(req)) {
+            // Метрики читаются из атомарных счетчиков, strand сеанса не нужен
+            rh_storage::GetMetricsHandler(req, rh_storage::RequestContext{}, application_, send);
+            return;
+        }
         if(req.target().starts_with("/api/"s)){
-            auto foo =[this, &req, send0=std::move(send)]()mutable {
-                rh_storage::ApiV1RequestHandlerExecutor<http::request<Body, http::basic_fields<Allocator>>, Send>
+            // Маршрутизатор выполняется прямо в executor'е соединения: изменения состояния игры
+            // сериализует strand игрового сеанса (см. GameSession), общий strand здесь не нужен
+            bool b = rh_storage::ApiV1Router<http::request<Body, http::basic_fields<Allocator>>, Send>
                 ::GetInstance()
-                .Execute(req, application_, std::move(send0));
-            };
-            net::dispatch(strand_, foo);
+                .Execute(req, application_, std::move(send));
+            if(!b) {
+                // Ответ нужен на каждый запрос, иначе остановится отправка ответов на последующие запросы соединения
+                rh_storage::BadRequestHandler(req, rh_storage::RequestContext{}, application_, send);
+            }
             return;
         } else {
             bool b =rh_storage::StaticFileRequestHandlerExecutor<http::request<Body, http::basic_fields<Allocator>>, Send>
@@ -48,16 +54,13 @@ public:
             if(b)
                 return;
             else
-                rh_storage::PageNotFoundHandler(req, application_, send);
+                rh_storage::PageNotFoundHandler(req, rh_storage::RequestContext{}, application_, send);
         };
     }
 
 private:
     app::Application& application_;
     fs::path static_content_root_path_;
-    net::io_context& io_;
-    Strand strand_;
-    
 };
 
 }  // namespace http_handler
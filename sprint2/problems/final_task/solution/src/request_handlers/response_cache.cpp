@@ -0,0 +1,111 @@
+#include "response_cache.h"
+#include "json_converter.h"
+#include "request_handlers_utils.h"
+
+namespace rh_storage{
+
+namespace {
+
+const std::string ALLOW_POST = "POST";
+const std::string ALLOW_GET_HEAD = "GET, HEAD";
+
+std::array<ConstantResponseDescription, static_cast<size_t>(ConstantResponse::COUNT)> CreateConstantResponseDescriptions() {
+    std::array<ConstantResponseDescription, static_cast<size_t>(ConstantResponse::COUNT)> result;
+    auto set = [&result](ConstantResponse id, http::status status, std::string body, bool no_cache, std::string allow = {}) {
+        result[static_cast<size_t>(id)] = ConstantResponseDescription{status, std::move(body), no_cache, std::move(allow)};
+    };
+    set(ConstantResponse::BAD_REQUEST, http::status::bad_request,
+        json_converter::CreateBadRequestResponse(), false);
+    set(ConstantResponse::MAP_NOT_FOUND, http::status::not_found,
+        json_converter::CreateMapNotFoundResponse(), false);
+    set(ConstantResponse::PAGE_NOT_FOUND, http::status::not_found,
+        json_converter::CreatePageNotFoundResponse(), false);
+    set(ConstantResponse::ONLY_POST_METHOD_ALLOWED, http::status::method_not_allowed,
+        json_converter::CreateOnlyPostMethodAllowedResponse(), true, ALLOW_POST);
+    set(ConstantResponse::JOIN_TO_GAME_INVALID_ARGUMENT, http::status::bad_request,
+        json_converter::CreateJoinToGameInvalidArgumentResponse(), true);
+    set(ConstantResponse::JOIN_TO_GAME_EMPTY_PLAYER_NAME, http::status::bad_request,
+        json_converter::CreateJoinToGameEmptyPlayerNameResponse(), true);
+    set(ConstantResponse::JOIN_TO_GAME_MAP_NOT_FOUND, http::status::not_found,
+        json_converter::CreateJoinToGameMapNotFoundResponse(), true);
+    set(ConstantResponse::INVALID_METHOD, http::status::method_not_allowed,
+        json_converter::CreateInvalidMethodResponse(), true, ALLOW_GET_HEAD);
+    set(ConstantResponse::EMPTY_AUTHORIZATION, http::status::unauthorized,
+        json_converter::CreateEmptyAuthorizationResponse(), true);
+    set(ConstantResponse::UNKNOWN_TOKEN, http::status::unauthorized,
+        json_converter::CreateUnknownTokenResponse(), true);
+    set(ConstantResponse::PLAYER_ACTION, http::status::ok,
+        json_converter::CreatePlayerActionResponse(), true);
+    set(ConstantResponse::PLAYER_ACTION_INVALID_ACTION, http::status::bad_request,
+        json_converter::CreatePlayerActionInvalidActionResponse(), true);
+    set(ConstantResponse::PLAYER_ACTION_QUEUE_OVERFLOW, http::status::service_unavailable,
+        json_converter::CreatePlayerActionQueueOverflowResponse(), true);
+    set(ConstantResponse::INVALID_CONTENT_TYPE, http::status::bad_request,
+        json_converter::CreateInvalidContentTypeResponse(), true);
+    set(ConstantResponse::SET_DELTA_TIME, http::status::ok,
+        json_converter::CreateSetDeltaTimeResponse(), true);
+    set(ConstantResponse::SET_DELTA_TIME_INVALID_MSG, http::status::bad_request,
+        json_converter::CreateSetDeltaTimeInvalidMsgResponse(), true);
+    set(ConstantResponse::INVALID_ENDPOINT, http::status::bad_request,
+        json_converter::CreateInvalidEndpointResponse(), true);
+    return result;
+}
+
+CachedResource PrepareJsonResource(std::string body) {
+    CachedResource resource;
+    resource.etag = MakeStrongEtag(body);
+
+    http::response<http::string_body> response{http::status::ok, http_server::PreparedResponse::HTTP_VERSION};
+    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
+    SetCacheHeaders(response, &resource);
+    response.body() = std::move(body);
+    response.content_length(response.body().size());
+    resource.ok_response = http_server::PreparedResponse::Create(std::move(response));
+
+    // Ответ 304 не содержит тела, но повторяет заголовки кэширования
+    http::response<http::empty_body> not_modified{http::status::not_modified, http_server::PreparedResponse::HTTP_VERSION};
+    SetCacheHeaders(not_modified, &resource);
+    resource.not_modified_response = http_server::PreparedResponse::Create(std::move(not_modified));
+    return resource;
+}
+
+}
+
+const ConstantResponseDescription& GetConstantResponseDescription(ConstantResponse id) {
+    static const auto descriptions = CreateConstantResponseDescriptions();
+    return descriptions.at(static_cast<size_t>(id));
+};
+
+ResponseCache& ResponseCache::GetInstance() {
+    static ResponseCache obj;
+    return obj;
+};
+
+void ResponseCache::Build(const model::Game::Maps& maps) {
+    for(size_t i = 0; i < constant_responses_.size(); ++i) {
+        const auto& description = GetConstantResponseDescription(static_cast<ConstantResponse>(i));
+        http::response<http::string_body> response{description.status, http_server::PreparedResponse::HTTP_VERSION};
+        FillConstantResponse(response, description);
+        constant_responses_[i] = http_server::PreparedResponse::Create(std::move(response));
+    }
+    map_list_resource_ = PrepareJsonResource(json_converter::ConvertMapListToJson(maps));
+    map_resources_.clear();
+    for(const auto& map : maps) {
+        map_resources_.emplace(*map->GetId(), PrepareJsonResource(json_converter::ConvertMapToJson(*map)));
+    }
+};
+
+const http_server::PreparedResponsePtr& ResponseCache::GetConstantResponse(ConstantResponse id) const noexcept {
+    return constant_responses_[static_cast<size_t>(id)];
+};
+
+const CachedResource* ResponseCache::GetMapListResource() const noexcept {
+    return map_list_resource_ ? &*map_list_resource_ : nullptr;
+};
+
+const CachedResource* ResponseCache::FindMapResource(std::string_view id) const noexcept {
+    auto it = map_resources_.find(id);
+    return it != map_resources_.end() ? &it->second : nullptr;
+};
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "game.h"
+#include "prepared_response.h"
+
+#include <array>
+#include <boost/beast/http.hpp>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace rh_storage{
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+const std::string CONTENT_TYPE_APPLICATION_JSON = "application/json";
+const std::string NO_CACHE_CONTROL = "no-cache";
+// Клиент может хранить карты, но перед использованием проверяет их по ETag. Карты не меняются,
+// пока работает сервер, поэтому проверка почти всегда заканчивается ответом 304 без тела,
+// а после перезапуска с другой конфигурацией клиент сразу получит новые карты
+const std::string MAPS_CACHE_CONTROL = "public, no-cache";
+
+// Ответы API, которые не зависят от содержимого запроса
+enum class ConstantResponse {
+    BAD_REQUEST,
+    MAP_NOT_FOUND,
+    PAGE_NOT_FOUND,
+    ONLY_POST_METHOD_ALLOWED,
+    JOIN_TO_GAME_INVALID_ARGUMENT,
+    JOIN_TO_GAME_EMPTY_PLAYER_NAME,
+    JOIN_TO_GAME_MAP_NOT_FOUND,
+    INVALID_METHOD,
+    EMPTY_AUTHORIZATION,
+    UNKNOWN_TOKEN,
+    PLAYER_ACTION,
+    PLAYER_ACTION_INVALID_ACTION,
+    PLAYER_ACTION_QUEUE_OVERFLOW,
+    INVALID_CONTENT_TYPE,
+    SET_DELTA_TIME,
+    SET_DELTA_TIME_INVALID_MSG,
+    INVALID_ENDPOINT,
+    COUNT
+};
+
+struct ConstantResponseDescription {
+    http::status status;
+    std::string body;
+    bool no_cache;
+    std::string allow;
+};
+
+const ConstantResponseDescription& GetConstantResponseDescription(ConstantResponse id);
+
+// Заполняет заголовки и тело ответа по описанию. Используется и для кэша, и для ответов вне его
+template <typename Response>
+void FillConstantResponse(Response& response, const ConstantResponseDescription& description) {
+    response.set(http::field::content_type, CONTENT_TYPE_APPLICATION_JSON);
+    if(description.no_cache) {
+        response.set(http::field::cache_control, NO_CACHE_CONTROL);
+    }
+    if(!description.allow.empty()) {
+        response.set(http::field::allow, description.allow);
+    }
+    response.body().assign(description.body.data(), description.body.size());
+    response.content_length(response.body().size());
+}
+
+// Неизменяемый ресурс API: строгий ETag и готовые ответы 200 и 304
+struct CachedResource {
+    std::string etag;
+    http_server::PreparedResponsePtr ok_response;
+    http_server::PreparedResponsePtr not_modified_response;
+};
+
+// Устанавливает заголовки кэширования ресурса. Без ресурса в кэше ответ не кэшируется клиентом
+template <typename Response>
+void SetCacheHeaders(Response& response, const CachedResource* resource) {
+    if(resource == nullptr) {
+        response.set(http::field::cache_control, NO_CACHE_CONTROL);
+        return;
+    }
+    response.set(http::field::cache_control, MAPS_CACHE_CONTROL);
+    response.set(http::field::etag, resource->etag);
+}
+
+/*Заранее сериализованные ответы: постоянные ответы API и карты, которые не меняются после
+загрузки игры. Кэш строится один раз при старте, до запуска рабочих потоков, и дальше
+только читается, поэтому доступ к нему не синхронизируется. Пока кэш не построен,
+обработчики формируют ответы обычным образом.*/
+class ResponseCache {
+public:
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    static ResponseCache& GetInstance();
+
+    void Build(const model::Game::Maps& maps);
+
+    const http_server::PreparedResponsePtr& GetConstantResponse(ConstantResponse id) const noexcept;
+    // Возвращают nullptr, если кэш не построен или карты с таким id нет
+    const CachedResource* GetMapListResource() const noexcept;
+    const CachedResource* FindMapResource(std::string_view id) const noexcept;
+
+private:
+    // Поиск по string_view без создания временной строки
+    struct StringHasher {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const noexcept {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    std::array<http_server::PreparedResponsePtr, static_cast<size_t>(ConstantResponse::COUNT)> constant_responses_;
+    std::optional<CachedResource> map_list_resource_;
+    std::unordered_map<std::string, CachedResource, StringHasher, std::equal_to<>> map_resources_;
+
+    ResponseCache() = default;
+};
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rh_storage{
+
+/*Радикс-дерево путей URL. Ребра помечены одним или несколькими сегментами пути ("api/v1"),
+цепочки узлов без ветвлений сжимаются при построении. Сегмент шаблона вида "{id}" совпадает
+с любым непустым сегментом запроса, литеральные сегменты проверяются раньше него (без возврата
+при неудаче глубже по дереву). Дерево строится один раз при старте, поиск выполняется
+за время, пропорциональное длине пути, и не выделяет память.*/
+template<typename Value>
+class UrlRadixTree {
+public:
+    UrlRadixTree() = default;
+    UrlRadixTree(const UrlRadixTree&) = delete;
+    UrlRadixTree& operator=(const UrlRadixTree&) = delete;
+    UrlRadixTree(UrlRadixTree&&) = default;
+    UrlRadixTree& operator=(UrlRadixTree&&) = default;
+
+    // Добавляет шаблон пути, например "/api/v1/maps/{id}". Завершающий "/" образует отдельный пустой сегмент
+    void Insert(std::string_view pattern, Value value) {
+        Node* node = &root_;
+        for(auto segment : SplitPattern(pattern)) {
+            node = node->GetOrCreateChild(segment);
+        }
+        node->value = std::move(value);
+    }
+
+    // Сжимает цепочки узлов с единственным потомком. Вызывается после добавления всех путей
+    void Compress() {
+        root_.Compress();
+    }
+
+    const Value* Find(std::string_view path) const noexcept {
+        if(path.empty() || path.front() != '/') {
+            return nullptr;
+        }
+        path.remove_prefix(1);
+        const Node* node = &root_;
+        while(true) {
+            const Node* next = nullptr;
+            for(const auto& child : node->children) {
+                if(MatchLabel(child->label, path)) {
+                    next = child.get();
+                    break;
+                }
+            }
+            if(next == nullptr && node->param_child) {
+                auto segment_end = path.find('/');
+                if(!path.empty() && segment_end != 0) {
+                    next = node->param_child.get();
+                    path.remove_prefix(segment_end == std::string_view::npos ? path.size() : segment_end);
+                    if(path.empty()) {
+                        return next->value ? &*next->value : nullptr;
+                    }
+                    path.remove_prefix(1);
+                    node = next;
+                    continue;
+                }
+            }
+            if(next == nullptr) {
+                return nullptr;
+            }
+            if(path.size() == next->label.size()) {
+                return next->value ? &*next->value : nullptr;
+            }
+            path.remove_prefix(next->label.size() + 1);
+            node = next;
+        }
+    }
+
+private:
+    static constexpr char PARAM_BEGIN = '{';
+
+    struct Node {
+        std::string label;
+        std::optional<Value> value;
+        std::vector< std::unique_ptr<Node> > children;
+        std::unique_ptr<Node> param_child;
+
+        Node* GetOrCreateChild(std::string_view segment) {
+            if(!segment.empty() && segment.front() == PARAM_BEGIN) {
+                if(!param_child) {
+                    param_child = std::make_unique<Node>();
+                    param_child->label = segment;
+                }
+                return param_child.get();
+            }
+            for(auto& child : children) {
+                if(child->label == segment) {
+                    return child.get();
+                }
+            }
+            children.push_back(std::make_unique<Node>());
+            children.back()->label = segment;
+            return children.back().get();
+        }
+
+        void Compress() {
+            for(auto& child : children) {
+                // Узел без значения с единственным литеральным потомком сливается с ним
+                while(!child->value && !child->param_child && child->children.size() == 1) {
+                    auto grandchild = std::move(child->children.front());
+                    grandchild->label = child->label + "/" + grandchild->label;
+                    child = std::move(grandchild);
+                }
+                child->Compress();
+            }
+            if(param_child) {
+                param_child->Compress();
+            }
+        }
+    };
+
+    Node root_;
+
+    static std::vector<std::string_view> SplitPattern(std::string_view pattern) {
+        std::vector<std::string_view> result;
+        if(!pattern.empty() && pattern.front() == '/') {
+            pattern.remove_prefix(1);
+        }
+        while(true) {
+            auto end = pattern.find('/');
+            result.push_back(pattern.substr(0, end));
+            if(end == std::string_view::npos) {
+                return result;
+            }
+            pattern.remove_prefix(end + 1);
+        }
+    }
+
+    // Метка совпадает, если путь начинается с нее и дальше идет конец пути или разделитель
+    static bool MatchLabel(std::string_view label, std::string_view path) noexcept {
+        return path.starts_with(label) && (path.size() == label.size() || path[label.size()] == '/');
+    }
+};
+
+}
@@ -20,40 +20,161 @@ void SessionBase::Run() {
 void SessionBase::Read() { 
     /* Асинхронное чтение запроса */
     using namespace std::literals;
-    // Очищаем запрос от прежнего значения (метод Read может быть вызван несколько раз)
-    request_ = {};
-    stream_.expires_after(30s);
+    // Очищаем запрос от прежнего значения (метод Read может быть вызван несколько раз).
+    // Каждый запрос получает свою арену. Память под арену берется из пула потока и возвращается
+    // в пул, когда уничтожены запрос, ответ на него и их копии - в том числе при конвейерной
+    // обработке, когда ответы на предыдущие запросы еще не отправлены
+    request_.reset();
+    ArenaAllocator allocator{std::allocate_shared<utils::RequestArena>(utils::RecyclingAllocator<utils::RequestArena>{})};
+    request_.emplace(std::piecewise_construct, std::make_tuple(allocator), std::make_tuple(allocator));
+    reading_ = true;
+    // Соединение, простаивающее дольше idle_timeout, будет закрыто
+    idle_deadline_ = std::chrono::steady_clock::now() + config_.idle_timeout;
+    if(!idle_timer_armed_) {
+        ArmIdleTimer();
+    }
     // Считываем request_ из stream_, используя buffer_ для хранения считанных данных
-    http::async_read(stream_, buffer_, request_,
+    http::async_read(stream_, buffer_, *request_,
                      // По окончании операции будет вызван метод OnRead
-                     beast::bind_front_handler(&SessionBase::OnRead, GetSharedThis()));
+                     BindRecyclingAllocator(beast::bind_front_handler(&SessionBase::OnRead, GetSharedThis())));
+};
+
+void SessionBase::ArmIdleTimer() {
+    idle_timer_armed_ = true;
+    idle_timer_.expires_at(idle_deadline_);
+    idle_timer_.async_wait(BindRecyclingAllocator(beast::bind_front_handler(&SessionBase::OnIdleTimer, GetSharedThis())));
+};
+
+void SessionBase::OnIdleTimer(beast::error_code ec) {
+    idle_timer_armed_ = false;
+    if(ec || closed_ || !reading_) {
+        // Таймер отменен, или сессия не ждет запроса - очередное чтение запустит таймер заново
+        return;
+    }
+    if(std::chrono::steady_clock::now() < idle_deadline_) {
+        // После запуска таймера были прочитаны запросы, срок ожидания сдвинулся
+        return ArmIdleTimer();
+    }
+    // Прерываем ожидание запроса, OnRead закроет соединение
+    idle_timed_out_ = true;
+    beast::error_code cancel_ec;
+    stream_.socket().cancel(cancel_ec);
+};
+
+void SessionBase::ReadIfAllowed() {
+    if(reading_ || read_closed_ || closed_) {
+        return;
+    }
+    if(config_.max_requests_per_connection != 0 &&
+        next_request_sequence_ >= config_.max_requests_per_connection) {
+        // Лимит запросов исчерпан, соединение закроется после отправки последнего ответа
+        read_closed_ = true;
+        idle_timer_.cancel();
+        return;
+    }
+    if(GetRequestsInProgressCount() >= config_.max_pipelined_requests) {
+        // Чтение продолжится после отправки очередного ответа
+        return;
+    }
+    Read();
 };
 
 void SessionBase::OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
     using namespace std::literals;
-    if (ec == http::error::end_of_stream) {
-        // Нормальная ситуация - клиент закрыл соединение
-        return Close();
+    reading_ = false;
+    if (ec == http::error::end_of_stream || idle_timed_out_) {
+        // Нормальная ситуация - клиент закрыл соединение или долго не присылал запросов.
+        // Закрываем соединение после отправки ответов на уже прочитанные запросы
+        read_closed_ = true;
+        idle_timer_.cancel();
+        if(GetRequestsInProgressCount() == 0) {
+            Close();
+        }
+        return;
     }
     if (ec) {
+        read_closed_ = true;
+        idle_timer_.cancel();
         return error_report::ReportError(ec, "read"sv);
     }
-    HandleRequest(std::move(request_));
+    if(!request_->keep_alive()) {
+        // Клиент просит закрыть соединение после ответа на этот запрос
+        read_closed_ = true;
+        idle_timer_.cancel();
+    }
+    HandleRequest(next_request_sequence_++, std::move(*request_));
+    // Не дожидаясь ответа, читаем следующий запрос конвейера
+    ReadIfAllowed();
+};
+
+void SessionBase::DispatchResponse(RequestSequence sequence, ResponseWriterPtr&& writer) {
+    net::dispatch(stream_.get_executor(), BindRecyclingAllocator(
+        [self = GetSharedThis(), sequence, writer = std::move(writer)]() mutable {
+            self->EnqueueResponse(sequence, std::move(writer));
+        }));
+};
+
+void SessionBase::EnqueueResponse(RequestSequence sequence, ResponseWriterPtr&& writer) {
+    if(closed_) {
+        return;
+    }
+    pending_responses_.emplace(sequence, std::move(writer));
+    WriteNextResponse();
+};
+
+void SessionBase::WriteNextResponse() {
+    if(writing_ || closed_) {
+        return;
+    }
+    auto it = pending_responses_.find(next_response_sequence_);
+    if(it == pending_responses_.end()) {
+        // Ответ на очередной по порядку запрос еще не готов
+        return;
+    }
+    ResponseWriterPtr writer = std::move(it->second);
+    pending_responses_.erase(it);
+    writing_ = true;
+    writer->AsyncWrite(GetSharedThis());
 };
 
 void SessionBase::OnWrite(bool close, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written) {
+    writing_ = false;
     if (ec) {
+        closed_ = true;
+        read_closed_ = true;
+        pending_responses_.clear();
         return error_report::ReportError(ec, "write"sv);
     }
+    ++next_response_sequence_;
     if (close) {
         // Семантика ответа требует закрыть соединение
         return Close();
     }
-    // Считываем следующий запрос
-    Read();
+    if(read_closed_ && GetRequestsInProgressCount() == 0) {
+        // Ответы на все прочитанные запросы отправлены, новых запросов не будет
+        return Close();
+    }
+    WriteNextResponse();
+    // Считываем следующий запрос, если чтение было приостановлено
+    ReadIfAllowed();
 } 
 
+size_t SessionBase::GetRequestsInProgressCount() const {
+    return next_request_sequence_ - next_response_sequence_;
+};
+
+bool SessionBase::IsLastAllowedRequest(RequestSequence sequence) const {
+    return config_.max_requests_per_connection != 0 &&
+            sequence + 1 >= config_.max_requests_per_connection;
+};
+
 void SessionBase::Close() {
+    closed_ = true;
+    read_closed_ = true;
+    // Ответы, которые уже не будут отправлены, удерживают сессию - освобождаем их
+    pending_responses_.clear();
+    // Ожидание таймера удерживает сессию - отменяем его
+    idle_timer_.cancel();
     beast::error_code ec;
     stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
 }
@@ -2,12 +2,22 @@
 #include "sdk.h"
 #include "logger.h"
 #include "error_report.h"
+#include "recycling_allocator.h"
+#include "request_arena.h"
+#include "prepared_response.h"
 
 //
+#include <boost/asio/bind_allocator.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <map>
 #include <string_view>
 
 namespace http_server {
@@ -21,6 +31,31 @@ namespace sys = boost::system;
 using tcp = net::ip::tcp;
 using namespace std::literals;
 
+// Параметры постоянного (keep-alive) соединения
+struct SessionConfig {
+    // Время ожидания очередного запроса от клиента
+    std::chrono::seconds idle_timeout{30};
+    // Максимальное количество запросов в рамках одного соединения (0 - без ограничений)
+    size_t max_requests_per_connection{0};
+    // Максимальное количество прочитанных запросов, ответы на которые еще не отправлены
+    size_t max_pipelined_requests{16};
+};
+
+/*Сокет и поток соединения работают в strand с конкретным типом executor'а. Со стертым типом
+(net::any_io_executor) strand не помещается во встроенный буфер и копируется в кучу
+при запуске каждой асинхронной операции*/
+using SessionExecutor = net::strand<net::io_context::executor_type>;
+using SessionSocket = net::basic_stream_socket<tcp, SessionExecutor>;
+using SessionStream = beast::basic_stream<tcp, SessionExecutor>;
+using SessionTimer = net::basic_waitable_timer<std::chrono::steady_clock, net::wait_traits<std::chrono::steady_clock>,
+                                               SessionExecutor>;
+
+// Обработчики асинхронных операций получают аллокатор, переиспользующий память потока
+template <typename Handler>
+auto BindRecyclingAllocator(Handler&& handler) {
+    return net::bind_allocator(utils::RecyclingAllocator<void>{}, std::forward<Handler>(handler));
+}
+
 class SessionBase {
 public:
     // Запрещаем копирование и присваивание объектов SessionBase и его наследников
@@ -41,56 +76,166 @@ public:
     };
 
 protected:
-    explicit SessionBase(tcp::socket&& socket)
-        : stream_(std::move(socket)) {
+    explicit SessionBase(SessionSocket&& socket, const SessionConfig& config)
+        : stream_(std::move(socket))
+        , idle_timer_(stream_.get_executor())
+        , config_(config) {
     }
-    using HttpRequest = http::request<http::string_body>;
+    // Поля заголовка и тело запроса размещаются в арене запроса
+    using ArenaAllocator = utils::ArenaAllocator<char>;
+    using HttpRequest = http::request< http::basic_string_body<char, std::char_traits<char>, ArenaAllocator>,
+                                       http::basic_fields<ArenaAllocator> >;
+    // Порядковый номер запроса в соединении. Ответы отправляются строго в порядке номеров запросов
+    using RequestSequence = size_t;
 
     ~SessionBase() = default;
 
     template <typename Body, typename Fields>
-    void Write(http::response<Body, Fields>&& response) {
-        // Запись выполняется асинхронно, поэтому response перемещаем в область кучи
-        auto safe_response = std::make_shared<http::response<Body, Fields>>(std::move(response));
-
-        auto self = GetSharedThis();
-        http::async_write(stream_, *safe_response,
-                          [safe_response, self](beast::error_code ec, std::size_t bytes_written) {
-                                //self->OnWrite(safe_response->need_eof(), ec, bytes_written);
-                                self->OnWrite(true, ec, bytes_written); // todo: write close
-                                BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("response sent"sv,
-                                                                logware::ResponseLogData<Body, Fields>(self->GetRemoteIp(),
-                                                                    self->GetDurationFromTimeReceivedRequest_ms(boost::posix_time::microsec_clock::local_time()),
-                                                                    *safe_response));
-                          });
+    void Write(RequestSequence sequence,
+               const boost::posix_time::ptime& received_request_moment,
+               http::response<Body, Fields>&& response) {
+        if(IsLastAllowedRequest(sequence)) {
+            // Исчерпан лимит запросов на соединение - сообщаем клиенту о закрытии
+            response.keep_alive(false);
+        }
+        // Запись выполняется асинхронно, поэтому response перемещаем в объект, память под который берется из пула
+        DispatchResponse(sequence, std::allocate_shared<ResponseWriter<Body, Fields>>(
+            utils::RecyclingAllocator<ResponseWriter<Body, Fields>>{}, std::move(response), received_request_moment));
     }
 
-    void SetReceivedRequestTime(const boost::posix_time::ptime& received_request_moment){
-        received_request_moment_ = received_request_moment;
+    void Write(RequestSequence sequence,
+               const boost::posix_time::ptime& received_request_moment,
+               PreparedResponseRef&& response) {
+        if(IsLastAllowedRequest(sequence)) {
+            response.keep_alive = false;
+        }
+        DispatchResponse(sequence, std::allocate_shared<PreparedResponseWriter>(
+            utils::RecyclingAllocator<PreparedResponseWriter>{}, std::move(response), received_request_moment));
     }
 
-    long GetDurationFromTimeReceivedRequest_ms(const boost::posix_time::ptime& to_moment){
-        boost::posix_time::time_duration duration = to_moment - received_request_moment_;
+    static long GetDurationFromTimeReceivedRequest_ms(const boost::posix_time::ptime& received_request_moment,
+                                                      const boost::posix_time::ptime& to_moment){
+        boost::posix_time::time_duration duration = to_moment - received_request_moment;
         return duration.total_milliseconds();
     }
 
 private:
-    // tcp_stream содержит внутри себя сокет и добавляет поддержку таймаутов
-    beast::tcp_stream stream_;
-    beast::flat_buffer buffer_;
-    HttpRequest request_;
-    boost::posix_time::ptime received_request_moment_;
+    // Ответ, ожидающий своей очереди на отправку
+    class ResponseWriterBase {
+    public:
+        virtual ~ResponseWriterBase() = default;
+        virtual void AsyncWrite(std::shared_ptr<SessionBase> session) = 0;
+    };
+
+    template <typename Body, typename Fields>
+    class ResponseWriter : public ResponseWriterBase,
+                           public std::enable_shared_from_this< ResponseWriter<Body, Fields> > {
+    public:
+        ResponseWriter(http::response<Body, Fields>&& response,
+                       const boost::posix_time::ptime& received_request_moment)
+            : response_(std::move(response))
+            , received_request_moment_(received_request_moment) {
+        }
+
+        void AsyncWrite(std::shared_ptr<SessionBase> session) override {
+            auto& stream = session->stream_;
+            http::async_write(stream, response_, BindRecyclingAllocator(
+                [session = std::move(session), self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_written) {
+                    session->OnWrite(self->response_.need_eof(), ec, bytes_written);
+                    BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("response sent"sv,
+                                                    logware::ResponseLogData<Body, Fields>(session->GetRemoteIp(),
+                                                        GetDurationFromTimeReceivedRequest_ms(self->received_request_moment_,
+                                                            boost::posix_time::microsec_clock::local_time()),
+                                                        self->response_));
+                }));
+        }
+
+    private:
+        http::response<Body, Fields> response_;
+        boost::posix_time::ptime received_request_moment_;
+    };
+
+    // Заранее сериализованный ответ отправляется как есть, одним буфером
+    class PreparedResponseWriter : public ResponseWriterBase,
+                                   public std::enable_shared_from_this<PreparedResponseWriter> {
+    public:
+        PreparedResponseWriter(PreparedResponseRef&& response,
+                               const boost::posix_time::ptime& received_request_moment)
+            : response_(std::move(response))
+            , received_request_moment_(received_request_moment) {
+        }
+
+        void AsyncWrite(std::shared_ptr<SessionBase> session) override {
+            auto& stream = session->stream_;
+            net::async_write(stream, net::buffer(response_.response->GetBytes(response_.keep_alive)), BindRecyclingAllocator(
+                [session = std::move(session), self = this->shared_from_this()](beast::error_code ec, std::size_t bytes_written) {
+                    session->OnWrite(!self->response_.keep_alive, ec, bytes_written);
+                    BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("response sent"sv,
+                                                    logware::ResponseLogData<http::empty_body, http::fields>(session->GetRemoteIp(),
+                                                        GetDurationFromTimeReceivedRequest_ms(self->received_request_moment_,
+                                                            boost::posix_time::microsec_clock::local_time()),
+                                                        self->response_.response->GetHeader()));
+                }));
+        }
+
+    private:
+        PreparedResponseRef response_;
+        boost::posix_time::ptime received_request_moment_;
+    };
+
+    using ResponseWriterPtr = std::shared_ptr<ResponseWriterBase>;
+    using PendingResponses = std::map< RequestSequence, ResponseWriterPtr, std::less<RequestSequence>,
+                                       utils::RecyclingAllocator< std::pair<const RequestSequence, ResponseWriterPtr> > >;
+
+    SessionStream stream_;
+    /*Таймаут простоя отслеживается своим таймером, а не таймаутами beast::basic_stream: таймер
+    потока работает через net::any_io_executor и обращается к куче при каждом чтении. Срок
+    ожидания сдвигается при каждом чтении, а таймер перезапускается только после срабатывания*/
+    SessionTimer idle_timer_;
+    std::chrono::steady_clock::time_point idle_deadline_;
+    beast::basic_flat_buffer< utils::RecyclingAllocator<char> > buffer_;
+    std::optional<HttpRequest> request_;
+    const SessionConfig config_;
+
+    // Состояние конвейера запросов. Изменяется только в executor'е объекта stream_
+    RequestSequence next_request_sequence_{0};
+    RequestSequence next_response_sequence_{0};
+    PendingResponses pending_responses_;
+    bool reading_{false};
+    bool writing_{false};
+    bool read_closed_{false};
+    bool closed_{false};
+    bool idle_timer_armed_{false};
+    bool idle_timed_out_{false};
 
     void Read();
 
+    void ArmIdleTimer();
+
+    void OnIdleTimer(beast::error_code ec);
+
+    void ReadIfAllowed();
+
     void OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read);
 
+    // Ответ может быть сформирован вне strand сессии (например, в strand игрового сеанса),
+    // поэтому постановку ответа в очередь выполняем, используя executor объекта stream_
+    void DispatchResponse(RequestSequence sequence, ResponseWriterPtr&& writer);
+
+    void EnqueueResponse(RequestSequence sequence, ResponseWriterPtr&& writer);
+
+    void WriteNextResponse();
+
     void OnWrite(bool close, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written);
 
+    size_t GetRequestsInProgressCount() const;
+
+    bool IsLastAllowedRequest(RequestSequence sequence) const;
+
     void Close();
 
     // Обработку запроса делегируем подклассу
-    virtual void HandleRequest(HttpRequest&& request) = 0;
+    virtual void HandleRequest(RequestSequence sequence, HttpRequest&& request) = 0;
 
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
 
@@ -100,8 +245,8 @@ template <typename RequestHandler>
 class Session : public SessionBase, public std::enable_shared_from_this<Session<RequestHandler>> {
 public:
     template <typename Handler>
-    Session(tcp::socket&& socket, Handler&& request_handler)
-        : SessionBase(std::move(socket))
+    Session(SessionSocket&& socket, const SessionConfig& config, Handler&& request_handler)
+        : SessionBase(std::move(socket), config)
         , request_handler_(std::forward<Handler>(request_handler)) {
     }
 private:
@@ -111,15 +256,16 @@ private:
         return this->shared_from_this();
     };
 
-    void HandleRequest(HttpRequest&& request) override {
-        SetReceivedRequestTime(boost::posix_time::microsec_clock::local_time());
+    void HandleRequest(RequestSequence sequence, HttpRequest&& request) override {
+        auto received_request_moment = boost::posix_time::microsec_clock::local_time();
         BOOST_LOG_TRIVIAL(info) << logware::CreateLogMessage("request received"sv,
                                                                 logware::RequestLogData(GetRemoteIp(), request));
         // Захватываем умный указатель на текущий объект Session в лямбде,
         // чтобы продлить время жизни сессии до вызова лямбды.
-        // Используется generic-лямбда функция, способная принять response произвольного типа
-        request_handler_(std::move(request), [self = this->shared_from_this()](auto&& response) {
-            self->Write(std::move(response));
+        // Используется generic-лямбда функция, способная принять response произвольного типа.
+        // Номер запроса позволяет отправить ответы в порядке поступления запросов
+        request_handler_(std::move(request), [self = this->shared_from_this(), sequence, received_request_moment](auto&& response) {
+            self->Write(sequence, received_request_moment, std::move(response));
         });
     }
 };
@@ -128,10 +274,12 @@ template <typename RequestHandler>
 class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
 public:
     template <typename Handler>
-    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler)
+    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, const SessionConfig& session_config,
+             bool reuse_port, Handler&& request_handler)
         : ioc_(ioc)
         // Обработчики асинхронных операций acceptor_ будут вызываться в своём strand
         , acceptor_(net::make_strand(ioc))
+        , session_config_(session_config)
         , request_handler_(std::forward<Handler>(request_handler)) {
         // Открываем acceptor, используя протокол (IPv4 или IPv6), указанный в endpoint
         acceptor_.open(endpoint.protocol());
@@ -141,6 +289,15 @@ public:
         // Однако это может помешать повторно открыть сокет в полузакрытом состоянии.
         // Флаг reuse_address разрешает открыть сокет, когда он "наполовину закрыт"
         acceptor_.set_option(net::socket_base::reuse_address(true));
+        if(reuse_port) {
+            // Флаг SO_REUSEPORT позволяет нескольким acceptor'ам (по одному на io_context) слушать
+            // один порт. Ядро само распределяет входящие соединения между ними
+#ifdef SO_REUSEPORT
+            acceptor_.set_option(ReusePort(true));
+#else
+            throw std::runtime_error("SO_REUSEPORT is not supported on this platform");
+#endif
+        }
         // Привязываем acceptor к адресу и порту endpoint
         acceptor_.bind(endpoint);
         // Переводим acceptor в состояние, в котором он способен принимать новые соединения
@@ -152,8 +309,13 @@ public:
         DoAccept();
     }
 private:
+#ifdef SO_REUSEPORT
+    using ReusePort = net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
     net::io_context& ioc_;
     tcp::acceptor acceptor_;
+    SessionConfig session_config_;
     RequestHandler request_handler_;
 
     void DoAccept() {
@@ -169,11 +331,12 @@ private:
             // Этот вызов bind_front_handler аналогичен
             // namespace ph = std::placeholders;
             // std::bind(&Listener::OnAccept, this->shared_from_this(), ph::_1, ph::_2)
-            beast::bind_front_handler(&Listener::OnAccept, this->shared_from_this()));
+            BindRecyclingAllocator(beast::bind_front_handler(&Listener::OnAccept, this->shared_from_this())));
     }
 
-    // Метод socket::async_accept создаст сокет и передаст его передан в OnAccept
-    void OnAccept(sys::error_code ec, tcp::socket socket) {
+    // Метод socket::async_accept создаст сокет и передаст его передан в OnAccept.
+    // Тип сокета задает executor, переданный в async_accept
+    void OnAccept(sys::error_code ec, SessionSocket socket) {
         using namespace std::literals;
 
         if (ec) {
@@ -187,18 +350,21 @@ private:
         DoAccept();
     }
 
-    void AsyncRunSession(tcp::socket&& socket) {
-        std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_)->Run();
+    void AsyncRunSession(SessionSocket&& socket) {
+        // Память под сессию берется из пула потока и возвращается в него после закрытия соединения
+        std::allocate_shared< Session<RequestHandler> >(utils::RecyclingAllocator< Session<RequestHandler> >{},
+                                                        std::move(socket), session_config_, request_handler_)->Run();
     }
 };
 
 template <typename RequestHandler>
-void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler) {
+void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, const SessionConfig& session_config,
+               bool reuse_port, RequestHandler&& handler) {
     // При помощи decay_t исключим ссылки из типа RequestHandler,
     // чтобы Listener хранил RequestHandler по значению
     using MyListener = Listener<std::decay_t<RequestHandler>>;
 
-    std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler))->Run();
+    std::make_shared<MyListener>(ioc, endpoint, session_config, reuse_port, std::forward<RequestHandler>(handler))->Run();
 }
 
 }  // namespace http_server
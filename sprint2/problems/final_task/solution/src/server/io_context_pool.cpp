@@ -0,0 +1,68 @@
+#include "io_context_pool.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace http_server {
+
+// io_context обслуживается ровно одним потоком
+const int IO_CONTEXT_CONCURRENCY_HINT = 1;
+
+IoContextPool::IoContextPool(size_t size) {
+    size = std::max(static_cast<size_t>(1), size);
+    io_contexts_.reserve(size);
+    for(size_t i = 0; i < size; ++i) {
+        io_contexts_.emplace_back(std::make_unique<net::io_context>(IO_CONTEXT_CONCURRENCY_HINT));
+    }
+};
+
+size_t IoContextPool::Size() const noexcept {
+    return io_contexts_.size();
+};
+
+net::io_context& IoContextPool::GetIoContext(size_t index) {
+    return *io_contexts_.at(index);
+};
+
+void IoContextPool::Run(bool pin_threads, size_t first_cpu, size_t cpu_count) {
+    if(cpu_count == 0) {
+        cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<std::jthread> workers;
+    workers.reserve(io_contexts_.size() - 1);
+    for(size_t i = 1; i < io_contexts_.size(); ++i) {
+        workers.emplace_back([this, i, pin_threads, first_cpu, cpu_count] {
+            if(pin_threads) {
+                PinCurrentThreadToCpu(first_cpu + i % cpu_count);
+            }
+            io_contexts_[i]->run();
+        });
+    }
+    if(pin_threads) {
+        PinCurrentThreadToCpu(first_cpu);
+    }
+    io_contexts_[0]->run();
+};
+
+void IoContextPool::Stop() {
+    for(auto& ioc : io_contexts_) {
+        ioc->stop();
+    }
+};
+
+void PinCurrentThreadToCpu(size_t cpu_index) {
+#ifdef __linux__
+    const size_t cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu_index % cpu_count, &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+};
+
+}  // namespace http_server
@@ -0,0 +1,37 @@
+#pragma once
+#include "sdk.h"
+
+#include <boost/asio/io_context.hpp>
+#include <memory>
+#include <vector>
+
+namespace http_server {
+
+namespace net = boost::asio;
+
+/*Пул io_context'ов для режима "io_context на поток". Каждый рабочий поток обслуживает
+свой io_context, поэтому соединения, таймеры и strand'ы потока не конкурируют
+за общую очередь планировщика и не переходят между ядрами.*/
+class IoContextPool {
+public:
+    explicit IoContextPool(size_t size);
+    IoContextPool(const IoContextPool&) = delete;
+    IoContextPool& operator=(const IoContextPool&) = delete;
+
+    size_t Size() const noexcept;
+    net::io_context& GetIoContext(size_t index);
+
+    // Запускает io_context'ы: нулевой - в текущем потоке, остальные - в отдельных потоках.
+    // При закреплении потоки занимают cpu_count ядер начиная с first_cpu (0 - все ядра), i-й поток -
+    // ядро first_cpu + i % cpu_count. Возвращает управление после остановки всех io_context'ов
+    void Run(bool pin_threads, size_t first_cpu = 0, size_t cpu_count = 0);
+    void Stop();
+
+private:
+    std::vector< std::unique_ptr<net::io_context> > io_contexts_;
+};
+
+// Привязывает текущий поток к ядру процессора с номером cpu_index (по модулю числа ядер)
+void PinCurrentThreadToCpu(size_t cpu_index);
+
+}  // namespace http_server
@@ -0,0 +1,63 @@
+#pragma once
+#include <boost/beast/http.hpp>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace http_server {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+/*Ответ, целиком сериализованный заранее: строка статуса, заголовки и тело. Хранит варианты
+для HTTP/1.1 с keep-alive и с закрытием соединения. Объект неизменяем и разделяется между
+потоками без синхронизации, отправляется без повторной сериализации и копирования.*/
+class PreparedResponse {
+public:
+    static constexpr unsigned HTTP_VERSION = 11;
+
+    template <typename Body, typename Fields>
+    static std::shared_ptr<const PreparedResponse> Create(http::response<Body, Fields> response) {
+        auto prepared = std::make_shared<PreparedResponse>();
+        response.version(HTTP_VERSION);
+        response.keep_alive(true);
+        prepared->keep_alive_bytes_ = Serialize(response);
+        response.keep_alive(false);
+        prepared->close_bytes_ = Serialize(response);
+        prepared->header_.result(response.result());
+        prepared->header_.set(http::field::content_type, response[http::field::content_type]);
+        return prepared;
+    }
+
+    const std::string& GetBytes(bool keep_alive) const noexcept {
+        return keep_alive ? keep_alive_bytes_ : close_bytes_;
+    }
+
+    // Статус и тип содержимого ответа для журнала
+    const http::response<http::empty_body>& GetHeader() const noexcept {
+        return header_;
+    }
+
+private:
+    std::string keep_alive_bytes_;
+    std::string close_bytes_;
+    http::response<http::empty_body> header_;
+
+    template <typename Body, typename Fields>
+    static std::string Serialize(const http::response<Body, Fields>& response) {
+        std::ostringstream out;
+        out << response;
+        return out.str();
+    }
+};
+
+using PreparedResponsePtr = std::shared_ptr<const PreparedResponse>;
+
+// Заранее сериализованный ответ на конкретный запрос
+struct PreparedResponseRef {
+    PreparedResponsePtr response;
+    bool keep_alive;
+};
+
+}  // namespace http_server
@@ -0,0 +1,62 @@
+#include "simulation_threads.h"
+
+#include <algorithm>
+
+namespace http_server {
+
+SimulationThreads::SimulationThreads(size_t threads_count, bool pin_threads) :
+        pin_threads_(pin_threads) {
+    if(threads_count != 0) {
+        pool_.emplace(threads_count);
+    }
+};
+
+SimulationThreads::~SimulationThreads() {
+    Stop();
+};
+
+bool SimulationThreads::IsEnabled() const noexcept {
+    return pool_.has_value();
+};
+
+SimulationThreads::IoContexts SimulationThreads::GetIoContexts() {
+    IoContexts io_contexts;
+    if(pool_) {
+        for(size_t i = 0; i < pool_->Size(); ++i) {
+            io_contexts.push_back(std::ref(pool_->GetIoContext(i)));
+        }
+    }
+    return io_contexts;
+};
+
+void SimulationThreads::Start() {
+    if(!pool_ || runner_.joinable()) {
+        return;
+    }
+    for(size_t i = 0; i < pool_->Size(); ++i) {
+        work_guards_.emplace_back(pool_->GetIoContext(i).get_executor());
+    }
+    // Потоки симуляции занимают последние ядра, первые ядра остаются сетевым потокам.
+    // Если ядер не больше, чем потоков симуляции, потоки симуляции делят все ядра
+    const size_t cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    const size_t first_cpu = cpu_count > pool_->Size() ? GetNetworkCpuCount(pool_->Size()) : 0;
+    runner_ = std::jthread([this, first_cpu] {
+        pool_->Run(pin_threads_, first_cpu);
+    });
+};
+
+void SimulationThreads::Stop() {
+    if(!runner_.joinable()) {
+        return;
+    }
+    work_guards_.clear();
+    pool_->Stop();
+    runner_.join();
+};
+
+size_t GetNetworkCpuCount(size_t simulation_threads) noexcept {
+    const size_t cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    return cpu_count > simulation_threads ? cpu_count - simulation_threads : 1;
+};
+
+}  // namespace http_server
@@ -0,0 +1,48 @@
+#pragma once
+#include "io_context_pool.h"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace http_server {
+
+/*Отдельные потоки симуляции. Игровые сеансы (strand'ы, тикеры) размещаются в io_context'ах
+этих потоков, а сетевые потоки общаются с ними только через очереди: вход в игру и ручной тик
+ставятся в strand сеанса, команды движения - в очередь команд, а состояние читается из
+опубликованных снимков. Поэтому разбор HTTP, раздача статики и логирование не задерживают
+тики, а долгий тик не задерживает чтение запросов. Потоки можно закрепить за последними
+ядрами процессора, сетевые потоки получают остальные ядра (см. GetNetworkCpuCount).*/
+class SimulationThreads {
+public:
+    using IoContexts = std::vector< std::reference_wrapper<net::io_context> >;
+
+    // threads_count = 0 - потоков симуляции нет, сеансы работают в сетевых io_context'ах
+    SimulationThreads(size_t threads_count, bool pin_threads);
+    SimulationThreads(const SimulationThreads&) = delete;
+    SimulationThreads& operator=(const SimulationThreads&) = delete;
+    ~SimulationThreads();
+
+    bool IsEnabled() const noexcept;
+    IoContexts GetIoContexts();
+
+    void Start();
+    // Останавливает io_context'ы и дожидается завершения потоков. Можно вызывать повторно
+    void Stop();
+
+private:
+    using WorkGuard = net::executor_work_guard<net::io_context::executor_type>;
+
+    std::optional<IoContextPool> pool_;
+    bool pin_threads_;
+    // Без ожидающих операций (например, при ручном управлении временем) io_context не должен завершаться
+    std::vector<WorkGuard> work_guards_;
+    std::jthread runner_;
+};
+
+// Сколько ядер остается сетевым потокам: все, кроме отданных потокам симуляции, но не меньше одного
+size_t GetNetworkCpuCount(size_t simulation_threads) noexcept;
+
+}  // namespace http_server
@@ -1,19 +1,44 @@
 #include "ticker.h"
 #include "error_report.h"
+#include "metrics.h"
+
+#include <algorithm>
 
 namespace time_m {
 
 using namespace std::literals;
 
+namespace {
+
+metrics::Histogram& GetLatenessHistogram() {
+    static metrics::Histogram& histogram = metrics::Registry::GetInstance().GetHistogram(
+        "game_tick_lateness_seconds", "Delay between the scheduled tick time and the tick handler start",
+        {0.0001, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0});
+    return histogram;
+}
+
+metrics::Counter& GetOverrunsCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "game_tick_overruns_total", "Ticks that started after the next tick was already due");
+    return counter;
+}
+
+metrics::Counter& GetDroppedStepsCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "game_tick_dropped_steps_total", "Overdue ticks skipped because of the catch-up steps limit");
+    return counter;
+}
+
+}
+
 void Ticker::Start() {
-    last_tick_ = std::chrono::steady_clock::now();
-    /* Выполнить SchedulTick внутри strand_ */
+    deadline_ = Clock::now() + config_.period;
     ScheduleTick();
 }
 
 void Ticker::ScheduleTick() {
-    /* выполнить OnTick через промежуток времени period_ */
-    timer_.expires_after(period_);
+    /* выполнить OnTick в момент deadline_ независимо от того, сколько длился предыдущий тик */
+    timer_.expires_at(deadline_);
     timer_.async_wait(net::bind_executor(*strand_, [self = shared_from_this()](sys::error_code ec) {
         self->OnTick(ec);
     }));
@@ -21,13 +46,34 @@ void Ticker::ScheduleTick() {
 
 void Ticker::OnTick(sys::error_code ec) {
     if (ec) {
-        error_report::ReportError(ec, "Update game state timer tick"sv);
+        // Таймер отменен или сломан: тики прекращаются
+        if (ec != net::error::operation_aborted) {
+            error_report::ReportError(ec, "Update game state timer tick"sv);
+        }
+        return;
     }
-    std::chrono::time_point<std::chrono::steady_clock> current_tick = std::chrono::steady_clock::now();
-    std::chrono::milliseconds duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_tick - last_tick_);
-    handler_(duration);
-    last_tick_ = current_tick;
+    const auto lateness = Clock::now() - deadline_;
+    GetLatenessHistogram().Observe(std::chrono::duration<double>(lateness).count());
+
+    // Сколько тиков наступило к текущему моменту, включая этот
+    const size_t due_steps = 1 + static_cast<size_t>(std::max(lateness, Clock::duration::zero()) / config_.period);
+    const auto due_duration = config_.period * static_cast<std::chrono::milliseconds::rep>(due_steps);
+    if (due_steps > 1) {
+        GetOverrunsCounter().Add();
+    }
+    if (config_.catch_up_policy == CatchUpPolicy::COALESCE) {
+        handler_(due_duration);
+    } else {
+        const size_t steps = std::min(due_steps, std::max<size_t>(config_.max_catch_up_steps, 1));
+        for (size_t i = 0; i < steps; ++i) {
+            handler_(config_.period);
+        }
+        if (steps < due_steps) {
+            GetDroppedStepsCounter().Add(due_steps - steps);
+        }
+    }
+    deadline_ += due_duration;
     ScheduleTick();
 }
 
-}
\ No newline at end of file
+}
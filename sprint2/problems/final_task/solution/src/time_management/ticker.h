@@ -11,15 +11,33 @@ namespace time_m {
 namespace net = boost::asio;
 namespace sys = boost::system;
 
+// Что делать, если к моменту срабатывания таймера наступило несколько тиков
+enum class CatchUpPolicy {
+    FIXED_STEPS,    // выполнить пропущенные тики по отдельности, но не больше max_catch_up_steps
+    COALESCE        // выполнить один тик с суммарной длительностью пропущенных
+};
+
+struct TickerConfig {
+    std::chrono::milliseconds period{0};
+    CatchUpPolicy catch_up_policy{CatchUpPolicy::FIXED_STEPS};
+    size_t max_catch_up_steps{5};
+};
+
+/*Тикер с фиксированной частотой. Моменты тиков отсчитываются от запуска с шагом period
+(expires_at), поэтому время выполнения обработчика не накапливается в отставание.
+Обработчик всегда получает длительность, кратную периоду. Если тикер не успевает,
+пропущенные тики догоняются по правилу catch_up_policy. Опоздания срабатывания таймера,
+перегрузки и отброшенные тики выдаются в метриках.*/
 class Ticker : public std::enable_shared_from_this<Ticker> {
 public:
     using Strand = net::strand<net::io_context::executor_type>;
     using Handler = std::function<void(const std::chrono::milliseconds& delta)>;
+    using Clock = std::chrono::steady_clock;
 
-    Ticker(std::shared_ptr<Strand> strand, const std::chrono::milliseconds& period, Handler handler):
+    Ticker(std::shared_ptr<Strand> strand, const TickerConfig& config, Handler handler):
         strand_{strand},
         timer_{*strand_},
-        period_{period},
+        config_{config},
         handler_{handler}{
     };
     ~Ticker() = default;
@@ -28,12 +46,12 @@ public:
 private:
     std::shared_ptr<Strand> strand_;;
     net::steady_timer timer_;
-    std::chrono::milliseconds period_;
+    TickerConfig config_;
     Handler handler_;
-    std::chrono::time_point<std::chrono::steady_clock> last_tick_;
+    Clock::time_point deadline_;
 
     void ScheduleTick();
     void OnTick(sys::error_code ec);
 }; 
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+
+/*Ограниченная очередь без блокировок: много производителей, один потребитель.
+Каждая ячейка кольцевого буфера хранит номер последовательности, по которому производитель
+понимает, свободна ли ячейка, а потребитель - записано ли в нее значение (схема Вьюкова).
+Производители соревнуются только за позицию записи, потребитель читает без атомарных
+операций чтения-модификации-записи. Вместимость округляется вверх до степени двойки.*/
+template <typename T>
+class BoundedMpscQueue {
+public:
+    explicit BoundedMpscQueue(std::size_t capacity) :
+            cells_(std::make_unique<Cell[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))),
+            mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1) {
+        for(std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    std::size_t Capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    // Вызывается из любого потока. Возвращает false, если очередь заполнена
+    bool TryPush(const T& value) noexcept {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while(true) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if(diff == 0) {
+                if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Вызывается только потребителем. Возвращает false, если очередь пуста
+    bool TryPop(T& value) noexcept {
+        Cell& cell = cells_[dequeue_pos_ & mask_];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeue_pos_ + 1) < 0) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    const std::size_t mask_;
+    // Позиции записи и чтения разнесены по разным кэш-линиям
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::size_t dequeue_pos_{0};
+};
+
+}  // namespace utils
@@ -0,0 +1,261 @@
+#include "http_compression.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <zlib.h>
+
+namespace utils {
+
+namespace {
+
+const std::string_view GZIP_NAME = "gzip";
+const std::string_view DEFLATE_NAME = "deflate";
+const std::string_view IDENTITY_NAME = "identity";
+const std::string_view ANY_ENCODING = "*";
+const std::string_view QUALITY_PARAM = "q=";
+const std::string_view WHITESPACES = " \t";
+const char LIST_DELIMITER = ',';
+const char PARAMS_DELIMITER = ';';
+
+const int WINDOW_BITS = 15;
+// Прибавка к размеру окна, при которой zlib пишет заголовок gzip вместо zlib
+const int GZIP_WINDOW_BITS_OFFSET = 16;
+const int MEMORY_LEVEL = 8;
+
+metrics::Counter& GetCompressedResponsesCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "compression_responses_total", "Responses sent with gzip or deflate content encoding");
+    return counter;
+}
+
+metrics::Counter& GetInputBytesCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "compression_input_bytes_total", "Bytes of sent compressed response bodies before compression");
+    return counter;
+}
+
+metrics::Counter& GetOutputBytesCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "compression_output_bytes_total", "Bytes of sent compressed response bodies after compression");
+    return counter;
+}
+
+metrics::Counter& GetCompressionTimeCounter() {
+    static metrics::Counter& counter = metrics::Registry::GetInstance().GetCounter(
+        "compression_time_microseconds_total", "Time spent compressing response bodies");
+    return counter;
+}
+
+std::string_view Trim(std::string_view str) {
+    auto begin = str.find_first_not_of(WHITESPACES);
+    if(begin == std::string_view::npos) {
+        return {};
+    }
+    return str.substr(begin, str.find_last_not_of(WHITESPACES) - begin + 1);
+}
+
+bool IsEqualIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char l, char r) {
+        return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+    });
+}
+
+const int MAX_QUALITY = 1000;
+const size_t MAX_QUALITY_DIGITS = 3;
+
+/*Вес q из параметров элемента Accept-Encoding в тысячных долях: "q=0.5" - 500. Без параметра q
+вес наибольший. Для недопустимого значения возвращается nullopt, такой элемент не учитывается*/
+std::optional<int> ParseQuality(std::string_view params) {
+    while(!params.empty()) {
+        auto delim_pos = params.find(PARAMS_DELIMITER);
+        auto param = Trim(params.substr(0, delim_pos));
+        params.remove_prefix(delim_pos == std::string_view::npos ? params.size() : delim_pos + 1);
+        if(param.size() <= QUALITY_PARAM.size() || !IsEqualIgnoreCase(param.substr(0, QUALITY_PARAM.size()), QUALITY_PARAM)) {
+            continue;
+        }
+        auto value = param.substr(QUALITY_PARAM.size());
+        if(value.front() != '0' && value.front() != '1') {
+            return std::nullopt;
+        }
+        int quality = (value.front() - '0') * MAX_QUALITY;
+        value.remove_prefix(1);
+        if(!value.empty()) {
+            if(value.front() != '.' || value.size() > MAX_QUALITY_DIGITS + 1) {
+                return std::nullopt;
+            }
+            value.remove_prefix(1);
+            int scale = MAX_QUALITY;
+            for(char digit : value) {
+                if(digit < '0' || digit > '9') {
+                    return std::nullopt;
+                }
+                scale /= 10;
+                quality += (digit - '0') * scale;
+            }
+        }
+        if(quality > MAX_QUALITY) {
+            return std::nullopt;
+        }
+        return quality;
+    }
+    return MAX_QUALITY;
+}
+
+// Поток zlib, который создается один раз на поток и сбрасывается перед каждым ответом
+class DeflateStream {
+public:
+    DeflateStream() = default;
+    DeflateStream(const DeflateStream&) = delete;
+    DeflateStream& operator=(const DeflateStream&) = delete;
+
+    ~DeflateStream() {
+        if(initialized_) {
+            deflateEnd(&stream_);
+        }
+    }
+
+    bool Compress(std::string_view input, ContentEncoding encoding, int level, std::string& output) {
+        if(!Prepare(encoding, level)) {
+            return false;
+        }
+        output.resize(deflateBound(&stream_, static_cast<uLong>(input.size())));
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream_.avail_in = static_cast<uInt>(input.size());
+        stream_.next_out = reinterpret_cast<Bytef*>(output.data());
+        stream_.avail_out = static_cast<uInt>(output.size());
+        // Выходного буфера размером deflateBound достаточно, чтобы сжать все за один вызов
+        if(deflate(&stream_, Z_FINISH) != Z_STREAM_END) {
+            output.clear();
+            return false;
+        }
+        output.resize(stream_.total_out);
+        return true;
+    }
+
+private:
+    z_stream stream_{};
+    bool initialized_{false};
+    int level_{Z_DEFAULT_COMPRESSION};
+
+    bool Prepare(ContentEncoding encoding, int level) {
+        if(initialized_ && level == level_) {
+            return deflateReset(&stream_) == Z_OK;
+        }
+        if(initialized_) {
+            deflateEnd(&stream_);
+            initialized_ = false;
+        }
+        stream_ = z_stream{};
+        int window_bits = encoding == ContentEncoding::GZIP ? WINDOW_BITS + GZIP_WINDOW_BITS_OFFSET : WINDOW_BITS;
+        if(deflateInit2(&stream_, level, Z_DEFLATED, window_bits, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        initialized_ = true;
+        level_ = level;
+        return true;
+    }
+};
+
+struct ThreadCompressionState {
+    DeflateStream gzip;
+    DeflateStream deflate;
+    std::string buffer;
+};
+
+ThreadCompressionState& GetThreadState() {
+    thread_local ThreadCompressionState state;
+    return state;
+}
+
+}
+
+std::string_view GetContentEncodingName(ContentEncoding encoding) {
+    switch(encoding) {
+        case ContentEncoding::GZIP:
+            return GZIP_NAME;
+        case ContentEncoding::DEFLATE:
+            return DEFLATE_NAME;
+        default:
+            return IDENTITY_NAME;
+    }
+};
+
+ResponseCompressor& ResponseCompressor::GetInstance() {
+    static ResponseCompressor obj;
+    return obj;
+};
+
+void ResponseCompressor::Configure(const CompressionConfig& config) {
+    config_ = config;
+    config_.level = std::clamp(config_.level, Z_BEST_SPEED, Z_BEST_COMPRESSION);
+};
+
+/*Выбирается кодировка с наибольшим весом q, при равных весах - gzip. "*" задает вес кодировок,
+не названных явно. Несжатый ответ выбирается, если ни одна сжатая кодировка не принята
+или identity указана явно с большим весом, чем у лучшей из них*/
+ContentEncoding ResponseCompressor::Negotiate(std::string_view accept_encoding, std::size_t body_size) const {
+    if(!IsCompressible(body_size)) {
+        return ContentEncoding::IDENTITY;
+    }
+    std::optional<int> gzip_quality;
+    std::optional<int> deflate_quality;
+    std::optional<int> identity_quality;
+    std::optional<int> any_quality;
+    while(!accept_encoding.empty()) {
+        auto delim_pos = accept_encoding.find(LIST_DELIMITER);
+        auto item = accept_encoding.substr(0, delim_pos);
+        accept_encoding.remove_prefix(delim_pos == std::string_view::npos ? accept_encoding.size() : delim_pos + 1);
+
+        auto params_pos = item.find(PARAMS_DELIMITER);
+        auto coding = Trim(item.substr(0, params_pos));
+        auto quality = params_pos == std::string_view::npos ? MAX_QUALITY : ParseQuality(item.substr(params_pos + 1));
+        if(!quality) {
+            continue;
+        }
+        if(IsEqualIgnoreCase(coding, GZIP_NAME)) {
+            gzip_quality = quality;
+        } else if(IsEqualIgnoreCase(coding, DEFLATE_NAME)) {
+            deflate_quality = quality;
+        } else if(IsEqualIgnoreCase(coding, IDENTITY_NAME)) {
+            identity_quality = quality;
+        } else if(coding == ANY_ENCODING) {
+            any_quality = quality;
+        }
+    }
+    const int gzip = gzip_quality.value_or(any_quality.value_or(0));
+    const int deflate = deflate_quality.value_or(any_quality.value_or(0));
+    const int best = std::max(gzip, deflate);
+    if(best == 0 || (identity_quality && *identity_quality > best)) {
+        return ContentEncoding::IDENTITY;
+    }
+    return gzip == best ? ContentEncoding::GZIP : ContentEncoding::DEFLATE;
+};
+
+std::string_view ResponseCompressor::Compress(std::string_view input, ContentEncoding encoding) const {
+    if(encoding == ContentEncoding::IDENTITY) {
+        return {};
+    }
+    auto& state = GetThreadState();
+    auto& stream = encoding == ContentEncoding::GZIP ? state.gzip : state.deflate;
+
+    auto start = std::chrono::steady_clock::now();
+    bool compressed = stream.Compress(input, encoding, config_.level, state.buffer);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    if(!compressed) {
+        return {};
+    }
+    GetCompressionTimeCounter().Add(static_cast<uint64_t>(elapsed.count()));
+    return state.buffer;
+};
+
+void ResponseCompressor::CountCompressedResponse(std::size_t input_size, std::size_t output_size) const {
+    GetCompressedResponsesCounter().Add();
+    GetInputBytesCounter().Add(input_size);
+    GetOutputBytesCounter().Add(output_size);
+};
+
+}  // namespace utils
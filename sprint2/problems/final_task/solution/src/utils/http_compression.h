@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace utils {
+
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    DEFLATE
+};
+
+struct CompressionConfig {
+    bool enabled{false};
+    int level{6};
+    std::size_t min_size{1024};
+};
+
+// Значение заголовка Content-Encoding для кодировки
+std::string_view GetContentEncodingName(ContentEncoding encoding);
+
+/*Сжатие тел динамических ответов. Кодировка выбирается по весам q из заголовка Accept-Encoding
+(при равных весах gzip предпочтительнее deflate), небольшие тела не сжимаются. Каждый рабочий
+поток держит свои потоки zlib и буфер результата и переиспользует их между ответами, поэтому
+сжатие не выделяет память на каждый ответ и не требует синхронизации. Время сжатия и объем
+данных до и после сжатия выдаются в метриках.*/
+class ResponseCompressor {
+public:
+    ResponseCompressor(const ResponseCompressor&) = delete;
+    ResponseCompressor& operator=(const ResponseCompressor&) = delete;
+
+    static ResponseCompressor& GetInstance();
+
+    // Вызывается при старте, до запуска рабочих потоков
+    void Configure(const CompressionConfig& config);
+
+    bool IsEnabled() const noexcept {
+        return config_.enabled;
+    }
+
+    // Сжимается ли тело такого размера при включенном сжатии
+    bool IsCompressible(std::size_t body_size) const noexcept {
+        return config_.enabled && body_size >= config_.min_size;
+    }
+
+    ContentEncoding Negotiate(std::string_view accept_encoding, std::size_t body_size) const;
+
+    /*Сжимает данные в буфер текущего потока. Результат действителен до следующего вызова
+    в этом потоке. При ошибке zlib возвращает пустую строку, тогда ответ отправляется без сжатия*/
+    std::string_view Compress(std::string_view input, ContentEncoding encoding) const;
+
+    /*Учитывает в метриках отправленный сжатый ответ. Вызывается при отправке, а не при сжатии:
+    одно сжатое тело может уйти многим клиентам или не уйти ни одному*/
+    void CountCompressedResponse(std::size_t input_size, std::size_t output_size) const;
+
+private:
+    CompressionConfig config_;
+
+    ResponseCompressor() = default;
+};
+
+}  // namespace utils
@@ -1,20 +1,118 @@
 #include "random_generators.h"
-#include <random>
+
+#include <sys/random.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
 
 namespace utils {
 
+namespace {
+
+const size_t SECURE_BUFFER_SIZE = 512;
+
+uint64_t SplitMix64(uint64_t& state) noexcept {
+    uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+uint64_t GetRandomDeviceSeed() {
+    std::random_device random_device;
+    return (static_cast<uint64_t>(random_device()) << 32) | random_device();
+}
+
+// FNV-1a: в отличие от std::hash, значение одинаково во всех сборках, поэтому зерно сеанса воспроизводимо
+uint64_t HashKey(std::string_view key) noexcept {
+    uint64_t hash = 0xcbf29ce484222325;
+    for(const char c : key) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+// Случайные байты ядра, выданные потоку, но еще не использованные
+struct SecureBuffer {
+    std::array<unsigned char, SECURE_BUFFER_SIZE> bytes;
+    size_t position{SECURE_BUFFER_SIZE};
+};
+
+void ReadKernelRandom(unsigned char* data, size_t size) {
+    while(size > 0) {
+        const ssize_t read = getrandom(data, size, 0);
+        if(read < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "getrandom");
+        }
+        data += read;
+        size -= static_cast<size_t>(read);
+    }
+}
+
+}  // namespace
+
+Xoshiro256::Xoshiro256(uint64_t seed) noexcept {
+    for(auto& word : state_) {
+        word = SplitMix64(seed);
+    }
+}
+
+RandomService& RandomService::GetInstance() {
+    static RandomService obj;
+    return obj;
+};
+
+void RandomService::SetSeed(uint64_t seed) {
+    seed_.store(seed, std::memory_order_relaxed);
+    seeded_.store(true, std::memory_order_release);
+}
+
+Xoshiro256 RandomService::MakeSessionGenerator(std::string_view map_id, uint64_t session_index) {
+    if(!seeded_.load(std::memory_order_acquire)) {
+        return Xoshiro256{GetThreadGenerator()()};
+    }
+    // Каждая часть ключа перемешивается отдельно, поэтому близкие зерна и номера дают несвязанные потоки
+    uint64_t state = seed_.load(std::memory_order_relaxed);
+    uint64_t key = SplitMix64(state) ^ HashKey(map_id);
+    key = SplitMix64(key) ^ session_index;
+    return Xoshiro256{SplitMix64(key)};
+}
+
+Xoshiro256& RandomService::GetThreadGenerator() {
+    thread_local Xoshiro256 generator{GetRandomDeviceSeed()};
+    return generator;
+}
+
 double GenerateDoubleFromInterval(const double lower, const double upper) {
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_real_distribution<double> distr(lower, upper);
-    return distr(eng);
+    return lower + (upper - lower) * RandomService::GetInstance().GetThreadGenerator().NextDouble();
 };
 
 int GenerateIntegerFromInterval(const int lower, const int upper) {
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_int_distribution<int> distr(lower,upper);
-    return distr(eng);
+    std::uniform_int_distribution<int> distr(lower, upper);
+    return distr(RandomService::GetInstance().GetThreadGenerator());
 };
 
-}
\ No newline at end of file
+void FillSecureRandomBytes(void* data, size_t size) {
+    thread_local SecureBuffer buffer;
+    auto* out = static_cast<unsigned char*>(data);
+    while(size > 0) {
+        if(buffer.position == buffer.bytes.size()) {
+            ReadKernelRandom(buffer.bytes.data(), buffer.bytes.size());
+            buffer.position = 0;
+        }
+        const size_t count = std::min(size, buffer.bytes.size() - buffer.position);
+        std::memcpy(out, buffer.bytes.data() + buffer.position, count);
+        // Выданные байты затираются, чтобы они не остались в памяти потока
+        std::memset(buffer.bytes.data() + buffer.position, 0, count);
+        buffer.position += count;
+        out += count;
+        size -= count;
+    }
+}
+
+}  // namespace utils
@@ -1,9 +1,92 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <string_view>
 
 namespace utils {
 
+/*Генератор xoshiro256++: 256 бит состояния, период 2^256 - 1, несколько наносекунд на число.
+Удовлетворяет требованиям UniformRandomBitGenerator и подходит для распределений из <random>.
+Криптостойким не является, для токенов используется FillSecureRandomBytes.*/
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    // Состояние заполняется из зерна генератором SplitMix64, как рекомендуют авторы алгоритма
+    explicit Xoshiro256(uint64_t seed) noexcept;
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() noexcept {
+        const uint64_t result = RotateLeft(state_[0] + state_[3], 23) + state_[0];
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = RotateLeft(state_[3], 45);
+        return result;
+    }
+
+    // Равномерное число из [0, 1) из старших 53 бит
+    double NextDouble() noexcept {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+private:
+    static uint64_t RotateLeft(uint64_t x, int k) noexcept {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::array<uint64_t, 4> state_;
+};
+
+/*Случайные числа игрового процесса. Каждый игровой сеанс получает свой генератор и пользуется
+им только в своем strand. С зерном генератор сеанса засевается зерном, id карты и номером сеанса
+на карте, поэтому его последовательность не зависит от потоков и от того, в каком порядке сеансы
+создавались и брали числа: прогон с тем же зерном повторяется. Без зерна генератор сеанса
+засевается числом из генератора потока. У каждого потока свой генератор, засеянный из
+std::random_device один раз, при первом обращении. Зерно на генераторы потоков не влияет.*/
+class RandomService {
+public:
+    RandomService(const RandomService&) = delete;
+    RandomService& operator=(const RandomService&) = delete;
+
+    static RandomService& GetInstance();
+
+    // Вызывается при старте, до создания игровых сеансов, или из замеров
+    void SetSeed(uint64_t seed);
+
+    // Генератор для сеанса с номером session_index среди сеансов на карте map_id
+    Xoshiro256 MakeSessionGenerator(std::string_view map_id, uint64_t session_index);
+
+    // Генератор потока для чисел, которые не нужно повторять между прогонами
+    Xoshiro256& GetThreadGenerator();
+
+private:
+    std::atomic<bool> seeded_{false};
+    std::atomic<uint64_t> seed_{0};
+
+    RandomService() = default;
+};
+
+// Равномерные числа из генератора потока: из [lower, upper) и из [lower, upper]
 double GenerateDoubleFromInterval(const double lower, const double upper);
 int GenerateIntegerFromInterval(const int lower, const int upper);
 
-}
\ No newline at end of file
+/*Криптостойкие случайные байты из getrandom(2) для токенов. Не зависят от зерна RandomService.
+Байты читаются из ядра блоками в буфер потока, поэтому системный вызов нужен не на каждый токен.
+Бросает std::system_error, если ядро не выдало байты*/
+void FillSecureRandomBytes(void* data, size_t size);
+
+}  // namespace utils
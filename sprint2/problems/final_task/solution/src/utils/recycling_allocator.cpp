@@ -0,0 +1,253 @@
+#include "recycling_allocator.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+
+namespace utils {
+
+namespace {
+
+const std::size_t MIN_BLOCK_SIZE_LOG2 = 4;     // 16 байт
+const std::size_t MAX_BLOCK_SIZE_LOG2 = 16;    // 64 Кб
+const std::size_t SIZE_CLASSES_COUNT = MAX_BLOCK_SIZE_LOG2 - MIN_BLOCK_SIZE_LOG2 + 1;
+const std::size_t MAX_CACHED_BYTES_PER_CLASS = 1 << 20;
+const std::size_t MIN_CACHED_BLOCKS_PER_CLASS = 4;
+
+/*Счетчики потока. Увеличивает их только поток-владелец, поэтому на горячем пути нет
+атомарных read-modify-write операций и разделяемых между ядрами кэш-линий. Потоки
+зарегистрированы в общем списке, суммы считаются при чтении метрик. Значения завершившихся
+потоков переносятся в общие итоги.*/
+struct ThreadAllocationStats {
+    std::atomic<uint64_t> heap{0};
+    std::atomic<uint64_t> recycled{0};
+    ThreadAllocationStats* prev{nullptr};
+    ThreadAllocationStats* next{nullptr};
+};
+
+void Increment(std::atomic<uint64_t>& counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+class AllocationStatsList {
+public:
+    // Список создается при первом обращении: пул может понадобиться до инициализации
+    // статических переменных этой единицы трансляции
+    static AllocationStatsList& GetInstance() {
+        static AllocationStatsList obj;
+        return obj;
+    }
+
+    void Register(ThreadAllocationStats& stats) {
+        std::lock_guard lock{mutex_};
+        stats.next = head_;
+        if(head_ != nullptr) {
+            head_->prev = &stats;
+        }
+        head_ = &stats;
+    }
+
+    void Unregister(ThreadAllocationStats& stats) {
+        std::lock_guard lock{mutex_};
+        retired_heap_.fetch_add(stats.heap.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        retired_recycled_.fetch_add(stats.recycled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        (stats.prev != nullptr ? stats.prev->next : head_) = stats.next;
+        if(stats.next != nullptr) {
+            stats.next->prev = stats.prev;
+        }
+    }
+
+    // Выделения потока, кэш которого уже уничтожен, учитываются сразу в общих итогах
+    void AddRetiredHeap() noexcept {
+        retired_heap_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t GetHeap() const {
+        return Sum(&ThreadAllocationStats::heap, retired_heap_);
+    }
+
+    uint64_t GetRecycled() const {
+        return Sum(&ThreadAllocationStats::recycled, retired_recycled_);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    ThreadAllocationStats* head_{nullptr};
+    std::atomic<uint64_t> retired_heap_{0};
+    std::atomic<uint64_t> retired_recycled_{0};
+
+    AllocationStatsList() {
+        auto& registry = metrics::Registry::GetInstance();
+        registry.GetCounterFunction("recycling_pool_heap_allocations_total",
+            "Allocations that missed the per-thread pool and went to the heap", [this] {
+                return GetHeap();
+            });
+        registry.GetCounterFunction("recycling_pool_recycled_allocations_total",
+            "Allocations served from the per-thread pool", [this] {
+                return GetRecycled();
+            });
+    }
+
+    uint64_t Sum(std::atomic<uint64_t> ThreadAllocationStats::* counter, const std::atomic<uint64_t>& retired) const {
+        std::lock_guard lock{mutex_};
+        uint64_t sum = retired.load(std::memory_order_relaxed);
+        for(const ThreadAllocationStats* stats = head_; stats != nullptr; stats = stats->next) {
+            sum += (stats->*counter).load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+};
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct FreeList {
+    FreeBlock* head{nullptr};
+    std::size_t size{0};
+};
+
+class ThreadCache {
+public:
+    ThreadCache() {
+        AllocationStatsList::GetInstance().Register(stats_);
+    }
+    ThreadCache(const ThreadCache&) = delete;
+    ThreadCache& operator=(const ThreadCache&) = delete;
+
+    ~ThreadCache() {
+        AllocationStatsList::GetInstance().Unregister(stats_);
+        for(auto& list : free_lists_) {
+            while(list.head != nullptr) {
+                FreeBlock* block = list.head;
+                list.head = block->next;
+                ::operator delete(block);
+            }
+        }
+    }
+
+    void* Pop(std::size_t size_class) noexcept {
+        FreeList& list = free_lists_[size_class];
+        if(list.head == nullptr) {
+            return nullptr;
+        }
+        FreeBlock* block = list.head;
+        list.head = block->next;
+        --list.size;
+        return block;
+    }
+
+    bool Push(std::size_t size_class, void* pointer) noexcept {
+        FreeList& list = free_lists_[size_class];
+        if(list.size >= GetMaxCachedBlocks(size_class)) {
+            return false;
+        }
+        list.head = new(pointer) FreeBlock{list.head};
+        ++list.size;
+        return true;
+    }
+
+    void CountHeapAllocation() noexcept {
+        Increment(stats_.heap);
+    }
+
+    void CountRecycledAllocation() noexcept {
+        Increment(stats_.recycled);
+    }
+
+private:
+    std::array<FreeList, SIZE_CLASSES_COUNT> free_lists_;
+    ThreadAllocationStats stats_;
+
+    static std::size_t GetMaxCachedBlocks(std::size_t size_class) noexcept {
+        const std::size_t block_size = std::size_t{1} << (size_class + MIN_BLOCK_SIZE_LOG2);
+        return std::max(MIN_CACHED_BLOCKS_PER_CLASS, MAX_CACHED_BYTES_PER_CLASS / block_size);
+    }
+};
+
+// Указатель тривиально разрушаемый, поэтому к нему можно обращаться и после
+// уничтожения кэша потока (например, при освобождении памяти в деструкторах других thread_local)
+thread_local ThreadCache* thread_cache = nullptr;
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCacheHolder {
+    ThreadCache cache;
+
+    ~ThreadCacheHolder() {
+        thread_cache = nullptr;
+        thread_cache_destroyed = true;
+    }
+};
+
+ThreadCache* GetThreadCache() noexcept {
+    if(thread_cache == nullptr && !thread_cache_destroyed) {
+        thread_local ThreadCacheHolder holder;
+        thread_cache = &holder.cache;
+    }
+    return thread_cache;
+}
+
+bool IsPoolable(std::size_t size, std::size_t alignment) noexcept {
+    return size <= (std::size_t{1} << MAX_BLOCK_SIZE_LOG2) &&
+            alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+std::size_t GetSizeClass(std::size_t size) noexcept {
+    const std::size_t size_log2 = std::bit_width(std::max(size, std::size_t{1}) - 1);
+    return std::max(size_log2, MIN_BLOCK_SIZE_LOG2) - MIN_BLOCK_SIZE_LOG2;
+}
+
+void CountHeapAllocation(ThreadCache* cache) noexcept {
+    if(cache != nullptr) {
+        cache->CountHeapAllocation();
+    } else {
+        AllocationStatsList::GetInstance().AddRetiredHeap();
+    }
+}
+
+}  // namespace
+
+void* RecyclingPool::Allocate(std::size_t size, std::size_t alignment) {
+    ThreadCache* cache = GetThreadCache();
+    if(!IsPoolable(size, alignment)) {
+        CountHeapAllocation(cache);
+        return ::operator new(size, std::align_val_t{alignment});
+    }
+    const std::size_t size_class = GetSizeClass(size);
+    if(cache != nullptr) {
+        if(void* pointer = cache->Pop(size_class); pointer != nullptr) {
+            cache->CountRecycledAllocation();
+            return pointer;
+        }
+    }
+    CountHeapAllocation(cache);
+    return ::operator new(std::size_t{1} << (size_class + MIN_BLOCK_SIZE_LOG2));
+};
+
+void RecyclingPool::Deallocate(void* pointer, std::size_t size, std::size_t alignment) noexcept {
+    if(pointer == nullptr) {
+        return;
+    }
+    if(!IsPoolable(size, alignment)) {
+        ::operator delete(pointer, std::align_val_t{alignment});
+        return;
+    }
+    if(ThreadCache* cache = GetThreadCache(); cache != nullptr && cache->Push(GetSizeClass(size), pointer)) {
+        return;
+    }
+    ::operator delete(pointer);
+};
+
+std::size_t RecyclingPool::GetHeapAllocationsCount() noexcept {
+    return AllocationStatsList::GetInstance().GetHeap();
+};
+
+std::size_t RecyclingPool::GetRecycledAllocationsCount() noexcept {
+    return AllocationStatsList::GetInstance().GetRecycled();
+};
+
+}  // namespace utils
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace utils {
+
+/*Пул блоков памяти текущего потока. Блоки разбиты на классы размеров (степени двойки),
+освобожденный блок попадает в список свободных блоков своего класса и переиспользуется
+при следующем запросе памяти того же класса. В установившемся режиме обращения к куче
+не происходят. Блок может быть освобожден в другом потоке - тогда он попадет в пул
+этого потока.*/
+class RecyclingPool {
+public:
+    static void* Allocate(std::size_t size, std::size_t alignment);
+    static void Deallocate(void* pointer, std::size_t size, std::size_t alignment) noexcept;
+
+    // Количество запросов памяти, которые не удалось обслужить из пула (обращения к куче)
+    static std::size_t GetHeapAllocationsCount() noexcept;
+    // Количество запросов памяти, обслуженных повторным использованием блоков пула
+    static std::size_t GetRecycledAllocationsCount() noexcept;
+};
+
+// Аллокатор, совместимый со стандартными контейнерами и associated_allocator из boost::asio
+template <typename T>
+class RecyclingAllocator {
+public:
+    using value_type = T;
+
+    RecyclingAllocator() noexcept = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) noexcept {
+    }
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(RecyclingPool::Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        RecyclingPool::Deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = RecyclingAllocator<U>;
+    };
+
+    template <typename U>
+    bool operator == (const RecyclingAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator != (const RecyclingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+// Специализация для void нужна boost::asio::bind_allocator
+template <>
+class RecyclingAllocator<void> {
+public:
+    using value_type = void;
+
+    RecyclingAllocator() noexcept = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) noexcept {
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = RecyclingAllocator<U>;
+    };
+
+    template <typename U>
+    bool operator == (const RecyclingAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator != (const RecyclingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+}  // namespace utils
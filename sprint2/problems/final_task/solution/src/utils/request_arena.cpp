@@ -0,0 +1,48 @@
+#include "request_arena.h"
+#include "recycling_allocator.h"
+
+namespace utils {
+
+namespace {
+
+class RecyclingMemoryResource : public std::pmr::memory_resource {
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return RecyclingPool::Allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+        RecyclingPool::Deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}  // namespace
+
+std::pmr::memory_resource* GetRecyclingMemoryResource() noexcept {
+    static RecyclingMemoryResource resource;
+    return &resource;
+};
+
+RequestArena::RequestArena(std::pmr::memory_resource* upstream)
+    : resource_(inline_buffer_.data(), inline_buffer_.size(), upstream) {
+};
+
+void* RequestArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    return resource_.allocate(bytes, alignment);
+};
+
+void RequestArena::do_deallocate([[maybe_unused]] void* pointer,
+                                 [[maybe_unused]] std::size_t bytes,
+                                 [[maybe_unused]] std::size_t alignment) {
+    // Монотонная арена не освобождает отдельные блоки, память вернется при уничтожении арены
+};
+
+bool RequestArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+};
+
+}  // namespace utils
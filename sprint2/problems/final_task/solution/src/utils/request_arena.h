@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace utils {
+
+// Ресурс памяти поверх RecyclingPool, общий для всех потоков
+std::pmr::memory_resource* GetRecyclingMemoryResource() noexcept;
+
+/*Монотонная арена одного запроса. Память выделяется сдвигом указателя (сначала во встроенном
+буфере, затем в блоках из upstream-ресурса), освобождение отдельных блоков ничего не делает.
+Вся память возвращается разом при уничтожении арены - когда уничтожены запрос, ответ на него
+и их копии, владеющие ареной через ArenaAllocator. Арена не синхронизирована: запрос и ответ
+обрабатываются последовательно, сначала в strand соединения, затем, возможно, в strand
+игрового сеанса, и одновременно к арене обращается только один поток.*/
+class RequestArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t INLINE_BUFFER_SIZE = 4096;
+
+    // По умолчанию блоки сверх встроенного буфера берутся из пула потока
+    explicit RequestArena(std::pmr::memory_resource* upstream = GetRecyclingMemoryResource());
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+private:
+    alignas(std::max_align_t) std::array<std::byte, INLINE_BUFFER_SIZE> inline_buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/*Аллокатор, выделяющий память в арене запроса. В отличие от std::pmr::polymorphic_allocator
+владеет ареной, поэтому арена переживает любой контейнер, созданный с этим аллокатором,
+даже если соединение уже закрыто. Копии контейнеров остаются в той же арене.
+Аллокатор, созданный по умолчанию, использует обычную кучу.*/
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+
+    explicit ArenaAllocator(std::shared_ptr<RequestArena> arena) noexcept
+        : arena_(std::move(arena)) {
+    }
+
+    // Перемещение аллокатора не должно менять исходный объект, поэтому оно выполняется копированием
+    ArenaAllocator(const ArenaAllocator& other) noexcept = default;
+    ArenaAllocator& operator=(const ArenaAllocator& other) noexcept = default;
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(other.GetArena()) {
+    }
+
+    T* allocate(std::size_t n) {
+        if(!arena_) {
+            return std::allocator<T>{}.allocate(n);
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if(!arena_) {
+            return std::allocator<T>{}.deallocate(pointer, n);
+        }
+        arena_->deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    const std::shared_ptr<RequestArena>& GetArena() const noexcept {
+        return arena_;
+    }
+
+    template <typename U>
+    bool operator == (const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.GetArena();
+    }
+
+    template <typename U>
+    bool operator != (const ArenaAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    std::shared_ptr<RequestArena> arena_;
+};
+
+}  // namespace utils
@@ -1,54 +1,75 @@
 #include "request_handlers_utils.h"
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
 #include <string>
 
 namespace rh_storage{
 
 const std::string BEARER = "Bearer";
 const size_t TOKEN_SIZE = 32;
-const size_t AUTHORIZATION_NUMBER_PARTS = 2;
-const size_t BEARER_INDEX = 0;
-const size_t TOKEN_INDEX = 1;
-
-std::vector<std::string_view> SplitUrl(std::string_view str) {
-    std::vector<std::string_view> result;
-    std::string delim = "/";
-    if(str.empty() or str == delim) return result;
-    auto start = 1U; // Ignore first slash
-    auto end = str.find(delim, start);
-    while (end != std::string::npos) {
-        result.push_back(str.substr(start, end - start));
-        start = end + delim.length();
-        end = str.find(delim, start);
-    }
-    result.push_back(str.substr(start, end));
-    return result;
-};
+const char AUTHORIZATION_DELIMITER = ' ';
+const char ETAG_LIST_DELIMITER = ',';
+const std::string_view ANY_ETAG = "*";
+const std::string_view WEAK_ETAG_PREFIX = "W/";
+const std::string_view WHITESPACES = " \t";
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
 
 std::string GetTokenString(std::string_view bearer_string) {
-    std::string token;
-    std::vector<std::string_view> splitted;
-    std::string delim = " ";
-    if(bearer_string.empty() or bearer_string == delim) {
-        return token;
-    }
-    auto start = 0U;
-    auto end = bearer_string.find(delim, start);
-    while (end != std::string::npos) {
-        splitted.push_back(bearer_string.substr(start, end - start));
-        start = end + delim.length();
-        end = bearer_string.find(delim, start);
+    // Заголовок должен состоять ровно из двух частей: "Bearer <token>"
+    auto delim_pos = bearer_string.find(AUTHORIZATION_DELIMITER);
+    if(delim_pos == std::string_view::npos) {
+        return {};
     }
-    splitted.push_back(bearer_string.substr(start, end));
-    if(splitted.size() != AUTHORIZATION_NUMBER_PARTS ||
-    splitted[BEARER_INDEX] != BEARER ||
-    splitted[TOKEN_INDEX].size() != TOKEN_SIZE) {
-        return token;
+    auto scheme = bearer_string.substr(0, delim_pos);
+    auto token = bearer_string.substr(delim_pos + 1);
+    if(scheme != BEARER ||
+    token.size() != TOKEN_SIZE ||
+    token.find(AUTHORIZATION_DELIMITER) != std::string_view::npos) {
+        return {};
     }
-    return std::string(splitted[TOKEN_INDEX]);
+    return std::string(token);
 };
 
 bool IsEqualUrls(const std::string& server_url, const std::string_view request_url){
     return request_url == server_url || request_url == server_url + "/";
 };
 
+bool IsEtagMatched(std::string_view if_none_match, std::string_view etag) {
+    while(!if_none_match.empty()) {
+        auto delim_pos = if_none_match.find(ETAG_LIST_DELIMITER);
+        auto candidate = if_none_match.substr(0, delim_pos);
+        if_none_match.remove_prefix(delim_pos == std::string_view::npos ? if_none_match.size() : delim_pos + 1);
+
+        auto begin = candidate.find_first_not_of(WHITESPACES);
+        if(begin == std::string_view::npos) {
+            continue;
+        }
+        candidate = candidate.substr(begin, candidate.find_last_not_of(WHITESPACES) - begin + 1);
+        if(candidate == ANY_ETAG) {
+            return true;
+        }
+        // Для If-None-Match используется слабое сравнение: префикс W/ не учитывается
+        if(candidate.starts_with(WEAK_ETAG_PREFIX)) {
+            candidate.remove_prefix(WEAK_ETAG_PREFIX.size());
+        }
+        if(candidate == etag) {
+            return true;
+        }
+    }
+    return false;
+};
+
+std::string MakeStrongEtag(std::string_view body) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for(unsigned char c : body) {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    std::ostringstream out;
+    out << '"' << std::hex << std::setw(16) << std::setfill('0') << hash << '"';
+    return out.str();
+};
+
 }
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
+#include <string>
 #include <string_view>
-#include <vector>
 
 namespace rh_storage{
 
-std::vector<std::string_view> SplitUrl(std::string_view str);
 std::string GetTokenString(std::string_view bearer_string);
 bool IsEqualUrls(const std::string& server_url, const std::string_view request_url);
+// Проверяет, совпадает ли ETag с одним из значений заголовка If-None-Match (слабое сравнение)
+bool IsEtagMatched(std::string_view if_none_match, std::string_view etag);
+// Строгий ETag - 64-битный хеш FNV-1a от сериализованного тела в кавычках
+std::string MakeStrongEtag(std::string_view body);
 
 }
\ No newline at end of file
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/*Иерархическое колесо таймеров. Время измеряется в единицах (например, миллисекундах),
+таймер хранит значение value и срабатывает, когда текущее время достигает срока. Каждый
+уровень - кольцо из SLOTS_COUNT ячеек, ячейка уровня l охватывает SLOTS_COUNT^l единиц.
+Таймер кладется на уровень, соответствующий остатку времени, и опускается на нижние уровни,
+когда до него доходит колесо. Постановка и отмена выполняются за O(1). Для каждого уровня
+хранится битовая карта занятых ячеек, поэтому продвижение времени перескакивает сразу
+к ближайшей занятой ячейке или границе оборота уровня: его цена зависит от числа сработавших
+и опущенных таймеров, а не от пройденного времени. Таймеры срабатывают в порядке сроков,
+а с одинаковым сроком - в порядке постановки. Узлы таймеров переиспользуются, поэтому память
+не растет сверх наибольшего числа одновременно поставленных таймеров. Колесо не синхронизировано.*/
+template <typename T>
+class TimingWheel {
+public:
+    using TimerId = uint32_t;
+    static constexpr TimerId INVALID_TIMER = std::numeric_limits<TimerId>::max();
+    static constexpr size_t LEVEL_BITS = 8;
+    static constexpr size_t SLOTS_COUNT = size_t{1} << LEVEL_BITS;
+    static constexpr size_t LEVELS_COUNT = 4;
+    // Более далекие сроки откладываются до конца последнего уровня
+    static constexpr uint64_t MAX_DELAY = (uint64_t{1} << (LEVEL_BITS * LEVELS_COUNT)) - 1;
+
+    TimingWheel() {
+        for(auto& level : slots_) {
+            level.fill(INVALID_TIMER);
+        }
+        for(auto& level : occupied_) {
+            level.fill(0);
+        }
+    }
+
+    uint64_t GetTime() const noexcept {
+        return now_;
+    }
+
+    size_t Size() const noexcept {
+        return active_count_;
+    }
+
+    // Ставит таймер со сроком через delay единиц. Таймер с нулевой задержкой сработает при следующем продвижении
+    TimerId Schedule(uint64_t delay, const T& value) {
+        TimerId id;
+        if(!free_nodes_.empty()) {
+            id = free_nodes_.back();
+            free_nodes_.pop_back();
+        } else {
+            id = static_cast<TimerId>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node& node = nodes_[id];
+        node.value = value;
+        node.expires = now_ + std::clamp<uint64_t>(delay, 1, MAX_DELAY);
+        node.sequence = next_sequence_++;
+        node.active = true;
+        Link(id);
+        ++active_count_;
+        return id;
+    }
+
+    // Отменяет таймер, если он еще не сработал
+    void Cancel(TimerId id) {
+        if(id >= nodes_.size() || !nodes_[id].active) {
+            return;
+        }
+        // Таймер из срабатывающей ячейки уже снят с нее
+        if(nodes_[id].level != FIRING_LEVEL) {
+            Unlink(id);
+        }
+        Release(id);
+    }
+
+    /*Продвигает время на elapsed единиц и вызывает on_expired(value) для сработавших таймеров в порядке сроков.
+    on_expired может ставить и отменять таймеры, но не продвигать колесо*/
+    template <typename Fn>
+    void Advance(uint64_t elapsed, Fn&& on_expired) {
+        const uint64_t target = now_ + elapsed;
+        while(now_ < target) {
+            if(active_count_ == 0) {
+                // Пустому колесу не нужно проходить ячейки
+                now_ = target;
+                return;
+            }
+            // До ближайшего события колесо не меняется, поэтому время переводится сразу к нему
+            now_ = std::min(GetNextEventTime(), target);
+            Cascade();
+            FireCurrentSlot(on_expired);
+        }
+    }
+
+private:
+    // Уровень узлов, снятых из ячейки, которая срабатывает сейчас
+    static constexpr uint8_t FIRING_LEVEL = LEVELS_COUNT;
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t WORDS_COUNT = SLOTS_COUNT / WORD_BITS;
+
+    struct Node {
+        T value{};
+        uint64_t expires{0};
+        // Порядок постановки: таймеры с одинаковым сроком срабатывают по нему
+        uint64_t sequence{0};
+        TimerId prev{INVALID_TIMER};
+        TimerId next{INVALID_TIMER};
+        uint8_t level{0};
+        uint8_t slot{0};
+        bool active{false};
+    };
+
+    // Таймер срабатывающей ячейки. sequence отличает его от таймера, поставленного в тот же узел обработчиком
+    struct FiringTimer {
+        uint64_t sequence;
+        TimerId id;
+    };
+
+    std::array<std::array<TimerId, SLOTS_COUNT>, LEVELS_COUNT> slots_;
+    std::array<std::array<uint64_t, WORDS_COUNT>, LEVELS_COUNT> occupied_;
+    std::vector<Node> nodes_;
+    std::vector<TimerId> free_nodes_;
+    std::vector<FiringTimer> firing_;
+    uint64_t now_{0};
+    uint64_t next_sequence_{0};
+    size_t active_count_{0};
+
+    static size_t GetSlotIndex(uint64_t time, size_t level) noexcept {
+        return static_cast<size_t>((time >> (LEVEL_BITS * level)) & (SLOTS_COUNT - 1));
+    }
+
+    void MarkOccupied(size_t level, size_t slot) noexcept {
+        occupied_[level][slot / WORD_BITS] |= uint64_t{1} << (slot % WORD_BITS);
+    }
+
+    void MarkEmpty(size_t level, size_t slot) noexcept {
+        occupied_[level][slot / WORD_BITS] &= ~(uint64_t{1} << (slot % WORD_BITS));
+    }
+
+    // Первая занятая ячейка уровня с номером не меньше from или SLOTS_COUNT, если такой нет
+    size_t FindOccupiedSlot(size_t level, size_t from) const noexcept {
+        for(size_t word = from / WORD_BITS; word < WORDS_COUNT; ++word) {
+            uint64_t bits = occupied_[level][word];
+            if(word == from / WORD_BITS) {
+                bits &= ~uint64_t{0} << (from % WORD_BITS);
+            }
+            if(bits != 0) {
+                return word * WORD_BITS + static_cast<size_t>(std::countr_zero(bits));
+            }
+        }
+        return SLOTS_COUNT;
+    }
+
+    /*Ближайший момент, когда срабатывает ячейка уровня 0 или ячейка верхнего уровня опускается ниже.
+    Ячейки уровня после текущей занимают остаток его оборота. Занятые ячейки до текущей относятся
+    к следующему обороту, тогда событие не позже конца оборота. Если уровень пуст, ближайшее событие
+    не раньше конца его оборота и определяется верхними уровнями*/
+    uint64_t GetNextEventTime() const noexcept {
+        for(size_t level = 0; level < LEVELS_COUNT; ++level) {
+            const size_t shift = LEVEL_BITS * level;
+            const uint64_t rotation_start = (now_ >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS);
+            const size_t next = FindOccupiedSlot(level, GetSlotIndex(now_, level) + 1);
+            if(next != SLOTS_COUNT) {
+                return rotation_start + (uint64_t{next} << shift);
+            }
+            if(FindOccupiedSlot(level, 0) != SLOTS_COUNT) {
+                return rotation_start + (uint64_t{1} << (shift + LEVEL_BITS));
+            }
+        }
+        const size_t wheel_bits = LEVEL_BITS * LEVELS_COUNT;
+        return ((now_ >> wheel_bits) + 1) << wheel_bits;
+    }
+
+    void Link(TimerId id) {
+        Node& node = nodes_[id];
+        const uint64_t delay = node.expires > now_ ? node.expires - now_ : 0;
+        size_t level = 0;
+        while(level + 1 < LEVELS_COUNT && delay >= (uint64_t{1} << (LEVEL_BITS * (level + 1)))) {
+            ++level;
+        }
+        const size_t slot = GetSlotIndex(std::max(node.expires, now_), level);
+        node.level = static_cast<uint8_t>(level);
+        node.slot = static_cast<uint8_t>(slot);
+        node.prev = INVALID_TIMER;
+        node.next = slots_[level][slot];
+        if(node.next != INVALID_TIMER) {
+            nodes_[node.next].prev = id;
+        }
+        slots_[level][slot] = id;
+        MarkOccupied(level, slot);
+    }
+
+    void Unlink(TimerId id) {
+        Node& node = nodes_[id];
+        if(node.prev != INVALID_TIMER) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            slots_[node.level][node.slot] = node.next;
+            if(node.next == INVALID_TIMER) {
+                MarkEmpty(node.level, node.slot);
+            }
+        }
+        if(node.next != INVALID_TIMER) {
+            nodes_[node.next].prev = node.prev;
+        }
+    }
+
+    void Release(TimerId id) {
+        nodes_[id].active = false;
+        free_nodes_.push_back(id);
+        --active_count_;
+    }
+
+    // Когда ячейка уровня проходит полный круг, таймеры очередной ячейки верхнего уровня опускаются ниже
+    void Cascade() {
+        for(size_t level = 1; level < LEVELS_COUNT; ++level) {
+            if(GetSlotIndex(now_, level - 1) != 0) {
+                return;
+            }
+            const size_t slot = GetSlotIndex(now_, level);
+            TimerId id = std::exchange(slots_[level][slot], INVALID_TIMER);
+            MarkEmpty(level, slot);
+            while(id != INVALID_TIMER) {
+                const TimerId next = nodes_[id].next;
+                Link(id);
+                id = next;
+            }
+        }
+    }
+
+    /*Ячейка снимается целиком и срабатывает в порядке постановки таймеров. Обработчик может ставить
+    и отменять таймеры, в том числе еще не сработавшие таймеры этой ячейки*/
+    template <typename Fn>
+    void FireCurrentSlot(Fn& on_expired) {
+        const size_t slot = GetSlotIndex(now_, 0);
+        TimerId id = std::exchange(slots_[0][slot], INVALID_TIMER);
+        if(id == INVALID_TIMER) {
+            return;
+        }
+        MarkEmpty(0, slot);
+        firing_.clear();
+        while(id != INVALID_TIMER) {
+            nodes_[id].level = FIRING_LEVEL;
+            firing_.push_back({nodes_[id].sequence, id});
+            id = nodes_[id].next;
+        }
+        std::sort(firing_.begin(), firing_.end(), [](const FiringTimer& lhs, const FiringTimer& rhs) {
+            return lhs.sequence < rhs.sequence;
+        });
+        // Обработчик не должен вызывать Advance: firing_ нужен до конца цикла
+        for(size_t i = 0; i < firing_.size(); ++i) {
+            const auto [sequence, timer] = firing_[i];
+            Node& node = nodes_[timer];
+            if(!node.active || node.sequence != sequence) {
+                continue;
+            }
+            Release(timer);
+            T value = std::move(node.value);
+            on_expired(value);
+        }
+    }
+};
+
+}  // namespace utils
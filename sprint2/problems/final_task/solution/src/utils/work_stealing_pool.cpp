@@ -0,0 +1,106 @@
+#include "work_stealing_pool.h"
+
+namespace utils {
+
+WorkStealingPool::WorkStealingPool(std::size_t threads_count) {
+    queues_.reserve(threads_count);
+    for(std::size_t i = 0; i < threads_count; ++i) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    workers_.reserve(threads_count);
+    for(std::size_t i = 0; i < threads_count; ++i) {
+        workers_.emplace_back([this, i] {
+            WorkerLoop(i);
+        });
+    }
+};
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock{sleep_mutex_};
+        stop_ = true;
+    }
+    wake_up_.notify_all();
+    workers_.clear();
+};
+
+void WorkStealingPool::Submit(RunFn run, void* job, std::size_t count, std::size_t grain,
+                            std::atomic<std::size_t>* remaining) {
+    {
+        // Счетчик увеличивается до того, как задачи появятся в очередях, чтобы он не уходил
+        // в минус, и под мьютексом, чтобы засыпающий поток не пропустил пробуждение
+        std::lock_guard lock{sleep_mutex_};
+        queued_tasks_.fetch_add(remaining->load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    wake_up_.notify_all();
+    // Части раскладываются по очередям по кругу, начиная со следующей после прошлого вызова
+    std::size_t queue_index = next_queue_.fetch_add(1, std::memory_order_relaxed);
+    for(std::size_t begin = 0; begin < count; begin += grain, ++queue_index) {
+        auto& queue = *queues_[queue_index % queues_.size()];
+        std::lock_guard lock{queue.mutex};
+        queue.tasks.push_back(Task{run, job, begin, std::min(begin + grain, count), remaining});
+    }
+};
+
+bool WorkStealingPool::TryPop(std::size_t queue_index, Task& task) {
+    auto& queue = *queues_[queue_index];
+    std::lock_guard lock{queue.mutex};
+    if(queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    queued_tasks_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+};
+
+bool WorkStealingPool::TrySteal(std::size_t first_queue_index, Task& task) {
+    for(std::size_t i = 0; i < queues_.size(); ++i) {
+        auto& queue = *queues_[(first_queue_index + i) % queues_.size()];
+        std::lock_guard lock{queue.mutex};
+        if(!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            queued_tasks_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+};
+
+void WorkStealingPool::Execute(const Task& task) {
+    task.run(task.job, task.begin, task.end);
+    task.remaining->fetch_sub(1, std::memory_order_acq_rel);
+};
+
+void WorkStealingPool::WaitFor(const std::atomic<std::size_t>& remaining) {
+    // Вызывающий поток помогает рабочим, а когда красть нечего, ждет последние части
+    Task task;
+    std::size_t steal_from = 0;
+    while(remaining.load(std::memory_order_acquire) != 0) {
+        if(TrySteal(steal_from++ % queues_.size(), task)) {
+            Execute(task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+void WorkStealingPool::WorkerLoop(std::size_t index) {
+    Task task;
+    while(true) {
+        if(TryPop(index, task) || TrySteal(index + 1, task)) {
+            Execute(task);
+            continue;
+        }
+        std::unique_lock lock{sleep_mutex_};
+        wake_up_.wait(lock, [this] {
+            return stop_ || queued_tasks_.load(std::memory_order_acquire) != 0;
+        });
+        if(stop_) {
+            return;
+        }
+    }
+};
+
+}  // namespace utils
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace utils {
+
+/*Пул потоков с кражей задач для параллельной обработки диапазонов. Диапазон делится
+на части, части раскладываются по очередям рабочих потоков. Поток берет задачи из конца
+своей очереди, а освободившись, крадет из начала чужих. Вызывающий поток тоже выполняет
+задачи, пока весь диапазон не будет обработан, поэтому пул без рабочих потоков выполняет
+диапазон последовательно. ParallelFor можно вызывать из нескольких потоков одновременно.*/
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(std::size_t threads_count);
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    ~WorkStealingPool();
+
+    std::size_t GetThreadsCount() const noexcept {
+        return workers_.size();
+    }
+
+    // Вызывает fn(begin, end) для частей [0, count) размером не больше grain и ждет их завершения
+    template <typename Fn>
+    void ParallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+        if(count == 0) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        if(workers_.empty() || count <= grain) {
+            fn(std::size_t{0}, count);
+            return;
+        }
+        std::atomic<std::size_t> remaining{(count + grain - 1) / grain};
+        auto run = [](void* job, std::size_t begin, std::size_t end) {
+            (*static_cast<std::remove_reference_t<Fn>*>(job))(begin, end);
+        };
+        Submit(run, const_cast<void*>(static_cast<const void*>(std::addressof(fn))), count, grain, &remaining);
+        WaitFor(remaining);
+    }
+
+private:
+    // Часть диапазона. Функция и счетчик живут в стеке вызвавшего ParallelFor до завершения всех частей
+    using RunFn = void (*)(void* job, std::size_t begin, std::size_t end);
+
+    struct Task {
+        RunFn run;
+        void* job;
+        std::size_t begin;
+        std::size_t end;
+        std::atomic<std::size_t>* remaining;
+    };
+
+    struct alignas(64) TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector< std::unique_ptr<TaskQueue> > queues_;
+    std::vector<std::jthread> workers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+    std::atomic<std::size_t> queued_tasks_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    bool stop_{false};
+
+    void Submit(RunFn run, void* job, std::size_t count, std::size_t grain, std::atomic<std::size_t>* remaining);
+    bool TryPop(std::size_t queue_index, Task& task);
+    bool TrySteal(std::size_t first_queue_index, Task& task);
+    void Execute(const Task& task);
+    void WaitFor(const std::atomic<std::size_t>& remaining);
+    void WorkerLoop(std::size_t index);
+};
+
+}  // namespace utils
@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/utils/http_compression.h"
+
+namespace {
+
+using utils::ContentEncoding;
+
+const std::size_t MIN_SIZE = 100;
+const std::size_t LARGE_BODY = 1000;
+
+ContentEncoding Negotiate(std::string_view accept_encoding, std::size_t body_size = LARGE_BODY) {
+    auto& compressor = utils::ResponseCompressor::GetInstance();
+    compressor.Configure({true, 6, MIN_SIZE});
+    return compressor.Negotiate(accept_encoding, body_size);
+}
+
+}
+
+TEST_CASE("Negotiate without weights prefers gzip", "[ResponseCompressor]") {
+    CHECK(Negotiate("gzip, deflate") == ContentEncoding::GZIP);
+    CHECK(Negotiate("deflate, gzip") == ContentEncoding::GZIP);
+    CHECK(Negotiate("deflate") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("GZip") == ContentEncoding::GZIP);
+    CHECK(Negotiate("br") == ContentEncoding::IDENTITY);
+    CHECK(Negotiate("") == ContentEncoding::IDENTITY);
+}
+
+TEST_CASE("Negotiate picks the highest weighted coding", "[ResponseCompressor]") {
+    CHECK(Negotiate("gzip;q=0.1, deflate") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=0.5, deflate;q=0.8") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=0.8, deflate;q=0.5") == ContentEncoding::GZIP);
+    CHECK(Negotiate("deflate;q=0.5, gzip;q=0.5") == ContentEncoding::GZIP);
+    CHECK(Negotiate("gzip ; Q=0.25 , deflate ; q=0.3") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=1.000, deflate;q=0.999") == ContentEncoding::GZIP);
+}
+
+TEST_CASE("Negotiate treats zero weight as refusal", "[ResponseCompressor]") {
+    CHECK(Negotiate("gzip;q=0") == ContentEncoding::IDENTITY);
+    CHECK(Negotiate("gzip;q=0.000, deflate") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=0, deflate;q=0.0") == ContentEncoding::IDENTITY);
+}
+
+TEST_CASE("Negotiate applies the wildcard to unlisted codings", "[ResponseCompressor]") {
+    CHECK(Negotiate("*") == ContentEncoding::GZIP);
+    CHECK(Negotiate("*, gzip;q=0") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=0.2, *;q=0.5") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("deflate;q=0, *") == ContentEncoding::GZIP);
+    CHECK(Negotiate("*;q=0") == ContentEncoding::IDENTITY);
+}
+
+TEST_CASE("Negotiate keeps identity when it is preferred or the body is small", "[ResponseCompressor]") {
+    CHECK(Negotiate("identity, gzip;q=0.5") == ContentEncoding::IDENTITY);
+    CHECK(Negotiate("identity;q=0.5, gzip") == ContentEncoding::GZIP);
+    CHECK(Negotiate("gzip", MIN_SIZE - 1) == ContentEncoding::IDENTITY);
+}
+
+TEST_CASE("Negotiate ignores malformed weights", "[ResponseCompressor]") {
+    CHECK(Negotiate("gzip;q=2, deflate") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=1.5, deflate;q=0.1") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=0.5000, deflate;q=0.1") == ContentEncoding::DEFLATE);
+    CHECK(Negotiate("gzip;q=abc") == ContentEncoding::IDENTITY);
+}
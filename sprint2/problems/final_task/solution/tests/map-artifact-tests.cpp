@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../src/json/json_loader.h"
+#include "../src/model/map_artifact.h"
+
+namespace {
+
+using namespace std::literals;
+namespace fs = std::filesystem;
+
+const int ROADS_PER_MAP = 200;
+const int MAP_SIZE = 100;
+
+// Каталог для файлов одного теста, удаляется вместе с ними
+struct ArtifactFixture {
+    fs::path dir = fs::temp_directory_path() / ("map-artifact-tests-"s + std::to_string(::getpid()));
+    fs::path config_path = dir / "config.json";
+    fs::path artifact_path = dir / "maps.bin";
+
+    ArtifactFixture() {
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        std::ofstream config(config_path);
+        config << R"({"defaultDogSpeed": 2.5, "dogRetirementTime": 15.0, "maps": [{"id": "config_map",
+            "name": "Config map", "roads": [{"x0": 0, "y0": 0, "x1": 40}, {"x0": 40, "y0": 0, "y1": 30}],
+            "buildings": [{"x": 5, "y": 5, "w": 30, "h": 20}],
+            "offices": [{"id": "o0", "x": 40, "y": 30, "offsetX": 5, "offsetY": 0}]}]})";
+    }
+
+    ~ArtifactFixture() {
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+
+    // Портит один байт содержимого, заголовок с хэшем конфигурации остается прежним
+    void CorruptArtifactPayload() const {
+        const auto size = fs::file_size(artifact_path);
+        std::fstream file(artifact_path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(size - 1));
+        const char last = static_cast<char>(file.get());
+        file.seekp(static_cast<std::streamoff>(size - 1));
+        file.put(static_cast<char>(last ^ 0x5a));
+    }
+};
+
+// Карты со случайными пересекающимися и наложенными дорогами, зданиями и офисами
+model::Game MakeGame(const std::string& prefix) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> coord_dist(0, MAP_SIZE);
+    model::Game game;
+    for(int m = 0; m < 3; ++m) {
+        model::Map map{model::Map::Id{prefix + std::to_string(m)}, "Map "s + std::to_string(m)};
+        for(int i = 0; i < ROADS_PER_MAP; ++i) {
+            const model::Point start{coord_dist(generator), coord_dist(generator)};
+            const int end = coord_dist(generator);
+            map.AddRoad((generator() % 2) ? model::Road{model::Road::HORIZONTAL, start, end}
+                                          : model::Road{model::Road::VERTICAL, start, end});
+        }
+        map.AddBuilding(model::Building{{{1, 2}, {3, 4}}});
+        map.AddOffice(model::Office{model::Office::Id{"o1"}, {5, 6}, {1, -1}});
+        map.AddOffice(model::Office{model::Office::Id{"o2"}, {7, 8}, {0, 2}});
+        if(m == 1) {
+            map.SetDogVelocity(4.0);
+        }
+        game.AddMap(std::move(map));
+    }
+    game.SetDefaultDogVelocity(2.5);
+    game.SetDogRetirementTime(15000ms);
+    return game;
+}
+
+using LineSpanRow = std::tuple<bool, int64_t, int64_t, int64_t, int64_t, size_t>;
+
+// Индекс дорог в виде упорядоченного списка: порядок обхода линий не задан
+std::vector<LineSpanRow> GetIndexRows(const model::Roadmap& roadmap) {
+    std::vector<LineSpanRow> rows;
+    roadmap.ForEachLine([&rows](bool horizontal, int64_t line_coord, const model::Roadmap::LineSpans& spans) {
+        for(const auto& span : spans) {
+            rows.emplace_back(horizontal, line_coord, span.begin, span.end, span.max_end, span.road);
+        }
+    });
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+void CheckMapsEqual(const model::Map& expected, const model::Map& actual) {
+    CHECK(*actual.GetId() == *expected.GetId());
+    CHECK(actual.GetName() == expected.GetName());
+    CHECK(actual.GetDogVelocity() == expected.GetDogVelocity());
+
+    REQUIRE(actual.GetRoads().size() == expected.GetRoads().size());
+    for(size_t i = 0; i < expected.GetRoads().size(); ++i) {
+        const auto& lhs = expected.GetRoads()[i];
+        const auto& rhs = actual.GetRoads()[i];
+        CHECK(lhs.IsHorizontal() == rhs.IsHorizontal());
+        CHECK((lhs.GetStart().x == rhs.GetStart().x && lhs.GetStart().y == rhs.GetStart().y));
+        CHECK((lhs.GetEnd().x == rhs.GetEnd().x && lhs.GetEnd().y == rhs.GetEnd().y));
+    }
+    CHECK(GetIndexRows(actual.GetRoadmap()) == GetIndexRows(expected.GetRoadmap()));
+
+    REQUIRE(actual.GetBuildings().size() == expected.GetBuildings().size());
+    for(size_t i = 0; i < expected.GetBuildings().size(); ++i) {
+        const auto& lhs = expected.GetBuildings()[i].GetBounds();
+        const auto& rhs = actual.GetBuildings()[i].GetBounds();
+        CHECK((lhs.position.x == rhs.position.x && lhs.position.y == rhs.position.y));
+        CHECK((lhs.size.width == rhs.size.width && lhs.size.height == rhs.size.height));
+    }
+
+    REQUIRE(actual.GetOffices().size() == expected.GetOffices().size());
+    for(size_t i = 0; i < expected.GetOffices().size(); ++i) {
+        const auto& lhs = expected.GetOffices()[i];
+        const auto& rhs = actual.GetOffices()[i];
+        CHECK(*lhs.GetId() == *rhs.GetId());
+        CHECK((lhs.GetPosition().x == rhs.GetPosition().x && lhs.GetPosition().y == rhs.GetPosition().y));
+        CHECK((lhs.GetOffset().dx == rhs.GetOffset().dx && lhs.GetOffset().dy == rhs.GetOffset().dy));
+    }
+}
+
+void CheckGamesEqual(const model::Game& expected, const model::Game& actual) {
+    CHECK(actual.GetDefaultDogVelocity() == expected.GetDefaultDogVelocity());
+    CHECK(actual.GetDogRetirementTime() == expected.GetDogRetirementTime());
+    REQUIRE(actual.GetMaps().size() == expected.GetMaps().size());
+    for(size_t i = 0; i < expected.GetMaps().size(); ++i) {
+        INFO("map " << i);
+        CheckMapsEqual(*expected.GetMaps()[i], *actual.GetMaps()[i]);
+    }
+}
+
+}  // namespace
+
+TEST_CASE_METHOD(ArtifactFixture, "Saved game loads back equal") {
+    const auto game = MakeGame("map");
+    const auto hash = map_artifact::HashConfigFile(config_path);
+    map_artifact::SaveGame(game, hash, artifact_path);
+    CHECK_FALSE(fs::exists(artifact_path.string() + ".tmp"));
+
+    const auto loaded = map_artifact::LoadGame(artifact_path, hash);
+    REQUIRE(loaded);
+    CheckGamesEqual(game, *loaded);
+}
+
+TEST_CASE_METHOD(ArtifactFixture, "Stale or damaged artifact is not loaded") {
+    const auto hash = map_artifact::HashConfigFile(config_path);
+    map_artifact::SaveGame(MakeGame("map"), hash, artifact_path);
+
+    SECTION("config hash differs") {
+        CHECK_FALSE(map_artifact::LoadGame(artifact_path, hash + 1));
+    }
+    SECTION("payload checksum does not match") {
+        CorruptArtifactPayload();
+        CHECK_FALSE(map_artifact::LoadGame(artifact_path, hash));
+    }
+    SECTION("file is truncated") {
+        fs::resize_file(artifact_path, fs::file_size(artifact_path) / 2);
+        CHECK_FALSE(map_artifact::LoadGame(artifact_path, hash));
+    }
+    SECTION("file is missing") {
+        CHECK_FALSE(map_artifact::LoadGame(dir / "missing.bin", hash));
+    }
+}
+
+TEST_CASE_METHOD(ArtifactFixture, "Game falls back to the JSON config when the artifact can't be used") {
+    const auto config_game = json_loader::LoadGame(config_path);
+    // Карты артефакта отличаются от карт конфигурации, поэтому видно, откуда загружена игра
+    const auto artifact_game = MakeGame("artifact_map");
+    const auto hash = map_artifact::HashConfigFile(config_path);
+
+    SECTION("artifact matches the config") {
+        map_artifact::SaveGame(artifact_game, hash, artifact_path);
+        CheckGamesEqual(artifact_game, json_loader::LoadGame(config_path, artifact_path));
+    }
+    SECTION("artifact is built from another config") {
+        map_artifact::SaveGame(artifact_game, hash + 1, artifact_path);
+        CheckGamesEqual(config_game, json_loader::LoadGame(config_path, artifact_path));
+    }
+    SECTION("artifact is corrupted") {
+        map_artifact::SaveGame(artifact_game, hash, artifact_path);
+        CorruptArtifactPayload();
+        CheckGamesEqual(config_game, json_loader::LoadGame(config_path, artifact_path));
+    }
+}
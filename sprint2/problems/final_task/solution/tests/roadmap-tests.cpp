@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/model/roadmap.h"
+#include "legacy/roadmap.h"
+
+namespace {
+
+using Roads = model::Roadmap::Roads;
+
+const unsigned GENERATOR_SEEDS[] = {7, 2024};
+const int MAPS_PER_SEED = 60;
+const int MOVES_PER_MAP = 1000;
+
+/*Результат перемещения в виде строки: так сравниваются и координаты, и исключения.
+Исходная реализация заполняет ячейки при поиске, поэтому индекс передается по неконстантной ссылке*/
+template <typename Index>
+std::string MoveToString(Index& index, const model::Position& position, const model::Position& target,
+                         const model::Velocity& velocity) {
+    std::ostringstream out;
+    out.precision(17);
+    try {
+        auto [new_position, new_velocity] = index.GetValidMove(position, target, velocity);
+        out << new_position.x << ' ' << new_position.y << ' ' << new_velocity.vx << ' ' << new_velocity.vy;
+    } catch(const std::exception&) {
+        // Исходная реализация бросает исключение для точек вне дорог, текущая должна делать так же
+        out << "exception";
+    }
+    return out.str();
+}
+
+// Дороги с отрицательными и положительными координатами, наложениями и перекрестками
+Roads GenerateRoads(std::mt19937& generator) {
+    std::uniform_int_distribution<int> coord_dist(-10, 29);
+    Roads roads;
+    const int roads_count = 3 + static_cast<int>(generator() % 12);
+    for(int i = 0; i < roads_count; ++i) {
+        const model::Point start{coord_dist(generator), coord_dist(generator)};
+        const int end = coord_dist(generator);
+        roads.push_back((generator() % 2) ? model::Road{model::Road::HORIZONTAL, start, end}
+                                          : model::Road{model::Road::VERTICAL, start, end});
+    }
+    return roads;
+}
+
+struct Move {
+    model::Position position;
+    model::Position target;
+    model::Velocity velocity;
+};
+
+/*Собака ставится на случайную дорогу со смещением в пределах обочины и бежит вдоль одной из осей,
+каждое десятое перемещение длиннее карты*/
+Move GenerateMove(std::mt19937& generator, const Roads& roads, int move_index) {
+    const model::Road& road = roads[generator() % roads.size()];
+    const double along = (generator() % 1000) / 1000.0;
+    const double across = (static_cast<int>(generator() % 81) - 40) / 100.0;
+    model::Position position;
+    if(road.IsHorizontal()) {
+        position = {road.GetStart().x + along * (road.GetEnd().x - road.GetStart().x), road.GetStart().y + across};
+    } else {
+        position = {road.GetStart().x + across, road.GetStart().y + along * (road.GetEnd().y - road.GetStart().y)};
+    }
+    const double speed = 0.5 + (generator() % 100) / 10.0;
+    const model::Velocity velocities[] = {{speed, 0}, {-speed, 0}, {0, speed}, {0, -speed}};
+    const model::Velocity velocity = velocities[generator() % std::size(velocities)];
+    const double dt = (move_index % 10 == 0) ? (generator() % 60000) / 1000.0 : (generator() % 3000) / 1000.0;
+    return {position, {position.x + velocity.vx * dt, position.y + velocity.vy * dt}, velocity};
+}
+
+}  // namespace
+
+TEST_CASE("Roadmap moves match the original cell grid on random maps") {
+    for(const unsigned seed : GENERATOR_SEEDS) {
+        std::mt19937 generator(seed);
+        for(int map_index = 0; map_index < MAPS_PER_SEED; ++map_index) {
+            const Roads roads = GenerateRoads(generator);
+            model::legacy::Roadmap legacy;
+            for(const auto& road : roads) {
+                legacy.AddRoad(road);
+            }
+            model::Roadmap roadmap;
+            roadmap.AddRoads(roads);
+
+            for(int k = 0; k < MOVES_PER_MAP; ++k) {
+                const auto move = GenerateMove(generator, roads, k);
+                INFO("seed " << seed << ", map " << map_index << ", move from (" << move.position.x << ", "
+                     << move.position.y << ") to (" << move.target.x << ", " << move.target.y << ")");
+                REQUIRE(MoveToString(roadmap, move.position, move.target, move.velocity) ==
+                        MoveToString(legacy, move.position, move.target, move.velocity));
+            }
+        }
+    }
+}
+
+/*Перемещение вычисляется сразу до края дороги, а исходная реализация проходит ячейки по одной.
+Собаки бегут по решетке из длинных дорог с перекрестками и наложениями и пересекают ее целиком*/
+TEST_CASE("Long moves across a road lattice match the original cell walk") {
+    const int lattice_size = 8;
+    const int lattice_step = 15;
+    const int lattice_end = lattice_size * lattice_step;
+    Roads roads;
+    for(int i = 0; i <= lattice_size; ++i) {
+        roads.push_back(model::Road{model::Road::HORIZONTAL, {0, i * lattice_step}, lattice_end});
+        roads.push_back(model::Road{model::Road::VERTICAL, {i * lattice_step, 0}, lattice_end});
+    }
+    // Дороги, продолжающие решетку за ее край и наложенные на ее части
+    roads.push_back(model::Road{model::Road::HORIZONTAL, {lattice_end, 0}, lattice_end + 40});
+    roads.push_back(model::Road{model::Road::HORIZONTAL, {lattice_end / 2, lattice_step}, -20});
+    roads.push_back(model::Road{model::Road::VERTICAL, {lattice_step * 2, lattice_end - 10}, lattice_end + 25});
+
+    model::legacy::Roadmap legacy;
+    for(const auto& road : roads) {
+        legacy.AddRoad(road);
+    }
+    model::Roadmap roadmap;
+    roadmap.AddRoads(roads);
+
+    std::mt19937 generator(GENERATOR_SEEDS[1]);
+    for(int k = 0; k < MOVES_PER_MAP; ++k) {
+        auto move = GenerateMove(generator, roads, k);
+        // Время движения до 100 с при скорости до 10.4: дальше края решетки
+        const double dt = (generator() % 100000) / 1000.0;
+        move.target = {move.position.x + move.velocity.vx * dt, move.position.y + move.velocity.vy * dt};
+        INFO("move from (" << move.position.x << ", " << move.position.y << ") to (" << move.target.x << ", "
+             << move.target.y << ")");
+        REQUIRE(MoveToString(roadmap, move.position, move.target, move.velocity) ==
+                MoveToString(legacy, move.position, move.target, move.velocity));
+    }
+}
+
+TEST_CASE("Roadmap index does not depend on the order roads are added in") {
+    std::mt19937 generator(GENERATOR_SEEDS[0]);
+    for(int map_index = 0; map_index < MAPS_PER_SEED; ++map_index) {
+        const Roads roads = GenerateRoads(generator);
+        model::Roadmap ordered;
+        ordered.AddRoads(roads);
+
+        // Дороги добавляются в два приема: индекс, построенный после первой половины, перестраивается
+        Roads shuffled = roads;
+        std::shuffle(shuffled.begin(), shuffled.end(), generator);
+        model::Roadmap incremental;
+        const size_t half = shuffled.size() / 2;
+        for(size_t i = 0; i < half; ++i) {
+            incremental.AddRoad(shuffled[i]);
+        }
+        incremental.BuildIndex();
+        for(size_t i = half; i < shuffled.size(); ++i) {
+            incremental.AddRoad(shuffled[i]);
+        }
+        incremental.BuildIndex();
+
+        for(int k = 0; k < MOVES_PER_MAP; ++k) {
+            const auto move = GenerateMove(generator, roads, k);
+            INFO("map " << map_index << ", move from (" << move.position.x << ", " << move.position.y << ")");
+            REQUIRE(MoveToString(incremental, move.position, move.target, move.velocity) ==
+                    MoveToString(ordered, move.position, move.target, move.velocity));
+        }
+    }
+}
+
+TEST_CASE("Roadmap requires the index to be built before moves") {
+    model::Roadmap roadmap;
+    roadmap.AddRoad(model::Road{model::Road::HORIZONTAL, {0, 0}, 10});
+    CHECK_FALSE(roadmap.IsIndexed());
+    CHECK_THROWS_AS(roadmap.GetValidMove({0, 0}, {1, 0}, {1, 0}), std::logic_error);
+
+    roadmap.BuildIndex();
+    CHECK(roadmap.IsIndexed());
+    const auto [position, velocity] = roadmap.GetValidMove({0, 0}, {20, 0}, {1, 0});
+    CHECK(position.x == 10.4);
+    CHECK(position.y == 0);
+    CHECK(velocity.vx == 0);
+}
@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../src/model/spawn_sampler.h"
+
+namespace {
+
+using Roads = std::vector<model::Road>;
+
+const unsigned GENERATOR_SEED = 42;
+const size_t BATCH_SIZE = 20000;
+
+// Точка лежит на отрезке дороги (без обочины)
+bool IsOnRoad(const model::Road& road, const model::Position& position) {
+    const double min_x = std::min(road.GetStart().x, road.GetEnd().x);
+    const double max_x = std::max(road.GetStart().x, road.GetEnd().x);
+    const double min_y = std::min(road.GetStart().y, road.GetEnd().y);
+    const double max_y = std::max(road.GetStart().y, road.GetEnd().y);
+    return position.x >= min_x && position.x <= max_x && position.y >= min_y && position.y <= max_y;
+}
+
+}
+
+TEST_CASE("Batch places count points with the same picks as GetPosition", "[SpawnSampler]") {
+    const Roads roads{model::Road{model::Road::HORIZONTAL, {0, 0}, 10},
+                      model::Road{model::Road::VERTICAL, {10, 0}, 3},
+                      model::Road{model::Road::HORIZONTAL, {-5, 7}, -1}};
+    const model::SpawnSampler sampler(roads);
+    std::mt19937_64 generator(GENERATOR_SEED);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+    std::vector<double> picks(2 * 100);
+    for(auto& pick : picks) {
+        pick = unit_dist(generator);
+    }
+
+    std::vector<model::Position> positions{{-100, -100}};
+    size_t next = 0;
+    sampler.GetPositions(100, [&] { return picks[next++]; }, positions);
+
+    REQUIRE(positions.size() == 101);
+    CHECK(next == picks.size());
+    // Пачка дописывается к уже размещенным точкам
+    CHECK(positions.front().x == -100);
+    for(size_t i = 0; i < 100; ++i) {
+        const auto expected = sampler.GetPosition(picks[2 * i], picks[2 * i + 1]);
+        CHECK(positions[i + 1].x == expected.x);
+        CHECK(positions[i + 1].y == expected.y);
+    }
+}
+
+TEST_CASE("Batch points lie on roads and follow road lengths", "[SpawnSampler]") {
+    const model::Road short_road{model::Road::HORIZONTAL, {0, 0}, 1};
+    const model::Road long_road{model::Road::VERTICAL, {20, 0}, 9};
+    const model::SpawnSampler sampler(Roads{short_road, long_road});
+    std::mt19937_64 generator(GENERATOR_SEED);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+
+    std::vector<model::Position> positions;
+    sampler.GetPositions(BATCH_SIZE, [&] { return unit_dist(generator); }, positions);
+
+    REQUIRE(positions.size() == BATCH_SIZE);
+    size_t on_long_road = 0;
+    for(const auto& position : positions) {
+        const bool on_short = IsOnRoad(short_road, position);
+        const bool on_long = IsOnRoad(long_road, position);
+        REQUIRE((on_short || on_long));
+        on_long_road += on_long ? 1 : 0;
+    }
+    // Длинная дорога занимает 9/10 общей длины
+    const double share = static_cast<double>(on_long_road) / BATCH_SIZE;
+    CHECK(std::abs(share - 0.9) < 0.01);
+}
+
+TEST_CASE("Batch on a map without roads places nothing", "[SpawnSampler]") {
+    const model::SpawnSampler sampler;
+    size_t picks = 0;
+    std::vector<model::Position> positions;
+    sampler.GetPositions(10, [&] { ++picks; return 0.5; }, positions);
+    CHECK(positions.empty());
+    CHECK(picks == 0);
+}
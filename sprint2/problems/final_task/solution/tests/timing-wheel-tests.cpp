@@ -0,0 +1,216 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../src/utils/timing_wheel.h"
+
+namespace {
+
+using Wheel = utils::TimingWheel<size_t>;
+
+// Значение сработавшего таймера и время колеса в момент срабатывания
+struct Fired {
+    size_t value;
+    uint64_t time;
+};
+
+struct Fixture {
+    Wheel wheel;
+    std::vector<Fired> fired;
+
+    void Advance(uint64_t elapsed) {
+        wheel.Advance(elapsed, [this](size_t value) {
+            fired.push_back({value, wheel.GetTime()});
+        });
+    }
+};
+
+const uint64_t LEVEL_0_SPAN = Wheel::SLOTS_COUNT;
+const uint64_t LEVEL_1_SPAN = LEVEL_0_SPAN * Wheel::SLOTS_COUNT;
+const uint64_t LEVEL_2_SPAN = LEVEL_1_SPAN * Wheel::SLOTS_COUNT;
+
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "Timer fires exactly at its expiry") {
+    wheel.Schedule(10, 1);
+    Advance(9);
+    CHECK(fired.empty());
+    Advance(1);
+    REQUIRE(fired.size() == 1);
+    CHECK(fired[0].value == 1);
+    CHECK(fired[0].time == 10);
+    CHECK(wheel.Size() == 0);
+}
+
+TEST_CASE_METHOD(Fixture, "Timers cascade from every level and fire at their expiry") {
+    // Сроки на границах уровней и внутри них, в том числе с переходом через оборот верхнего уровня
+    const std::vector<uint64_t> delays = {
+        1, LEVEL_0_SPAN - 1, LEVEL_0_SPAN, LEVEL_0_SPAN + 1,
+        LEVEL_1_SPAN - 1, LEVEL_1_SPAN, LEVEL_1_SPAN + 7,
+        LEVEL_2_SPAN - 1, LEVEL_2_SPAN, LEVEL_2_SPAN + LEVEL_1_SPAN + 3,
+        Wheel::MAX_DELAY
+    };
+
+    SECTION("when time advances in one jump") {
+        Advance(300);
+        for(size_t i = 0; i < delays.size(); ++i) {
+            wheel.Schedule(delays[i], i);
+        }
+        Advance(Wheel::MAX_DELAY);
+    }
+    SECTION("when time advances in uneven steps") {
+        Advance(300);
+        for(size_t i = 0; i < delays.size(); ++i) {
+            wheel.Schedule(delays[i], i);
+        }
+        uint64_t step = 1;
+        while(wheel.Size() != 0) {
+            Advance(step);
+            step = step * 3 + 1;
+        }
+    }
+
+    REQUIRE(fired.size() == delays.size());
+    for(size_t i = 0; i < delays.size(); ++i) {
+        INFO("timer " << i);
+        CHECK(fired[i].value == i);
+        CHECK(fired[i].time == 300 + delays[i]);
+    }
+}
+
+TEST_CASE_METHOD(Fixture, "Delays beyond the wheel range are clamped to MAX_DELAY") {
+    wheel.Schedule(Wheel::MAX_DELAY * 4, 1);
+    Advance(Wheel::MAX_DELAY - 1);
+    CHECK(fired.empty());
+    Advance(1);
+    REQUIRE(fired.size() == 1);
+    CHECK(fired[0].time == Wheel::MAX_DELAY);
+}
+
+TEST_CASE_METHOD(Fixture, "Timers fire in expiry order, equal expiries in scheduling order") {
+    // Первый таймер попадает на уровень 1 и опускается в ту же ячейку, куда второй поставлен сразу
+    wheel.Schedule(300, 0);
+    Advance(100);
+    wheel.Schedule(200, 1);
+    wheel.Schedule(200, 2);
+    wheel.Schedule(150, 3);
+    wheel.Schedule(201, 4);
+    Advance(1000);
+
+    REQUIRE(fired.size() == 5);
+    CHECK(fired[0].value == 3);
+    CHECK(fired[1].value == 0);
+    CHECK(fired[2].value == 1);
+    CHECK(fired[3].value == 2);
+    CHECK(fired[4].value == 4);
+    CHECK(fired[1].time == 300);
+    CHECK(fired[2].time == 300);
+}
+
+TEST_CASE_METHOD(Fixture, "Cancelled timers do not fire") {
+    const auto near = wheel.Schedule(5, 1);
+    const auto far = wheel.Schedule(LEVEL_1_SPAN + 5, 2);
+    wheel.Schedule(7, 3);
+    wheel.Cancel(near);
+    wheel.Cancel(far);
+    // Повторная отмена и отмена неизвестного таймера ничего не делают
+    wheel.Cancel(near);
+    wheel.Cancel(Wheel::INVALID_TIMER);
+    CHECK(wheel.Size() == 1);
+
+    Advance(2 * LEVEL_1_SPAN);
+    REQUIRE(fired.size() == 1);
+    CHECK(fired[0].value == 3);
+}
+
+TEST_CASE_METHOD(Fixture, "Rescheduled timer fires at the new expiry only") {
+    auto timer = wheel.Schedule(1000, 1);
+    Advance(500);
+    wheel.Cancel(timer);
+    timer = wheel.Schedule(1000, 1);
+    Advance(999);
+    CHECK(fired.empty());
+    Advance(1);
+    REQUIRE(fired.size() == 1);
+    CHECK(fired[0].time == 1500);
+}
+
+TEST_CASE("Expiry handler may cancel and schedule timers") {
+    Wheel wheel;
+    std::vector<size_t> fired;
+    const auto first = wheel.Schedule(10, 0);
+    const auto second = wheel.Schedule(10, 1);
+    wheel.Schedule(10, 2);
+    wheel.Advance(10, [&](size_t value) {
+        fired.push_back(value);
+        if(value == 0) {
+            // Второй таймер той же ячейки еще не сработал: отмена должна его снять
+            wheel.Cancel(second);
+            // Узел отмененного таймера переиспользуется, новый таймер не должен сработать в этой ячейке
+            wheel.Schedule(5, 3);
+            wheel.Cancel(first);
+        }
+    });
+    CHECK(fired == std::vector<size_t>{0, 2});
+
+    wheel.Advance(5, [&](size_t value) {
+        fired.push_back(value);
+    });
+    CHECK(fired == std::vector<size_t>{0, 2, 3});
+    CHECK(wheel.Size() == 0);
+}
+
+TEST_CASE("Random timers fire once at their expiry in expiry order") {
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<int> level_distribution{0, 3};
+    Wheel wheel;
+    struct Expected {
+        uint64_t expires = 0;
+        bool cancelled = false;
+        size_t fired_count = 0;
+    };
+    std::vector<Expected> expected;
+    std::vector<Wheel::TimerId> ids;
+    std::vector<size_t> order;
+
+    for(int round = 0; round < 20; ++round) {
+        for(int i = 0; i < 200; ++i) {
+            // Сроки равномерно по уровням колеса
+            const uint64_t span = uint64_t{1} << (Wheel::LEVEL_BITS * (level_distribution(random) + 1));
+            const uint64_t delay = 1 + random() % (span - 1);
+            ids.push_back(wheel.Schedule(delay, expected.size()));
+            expected.push_back({wheel.GetTime() + delay});
+        }
+        for(int i = 0; i < 50; ++i) {
+            const size_t victim = random() % ids.size();
+            if(expected[victim].fired_count == 0 && !expected[victim].cancelled) {
+                wheel.Cancel(ids[victim]);
+                expected[victim].cancelled = true;
+            }
+        }
+        wheel.Advance(random() % (LEVEL_1_SPAN * 4), [&](size_t value) {
+            ++expected[value].fired_count;
+            CHECK(wheel.GetTime() == expected[value].expires);
+            order.push_back(value);
+        });
+    }
+    wheel.Advance(Wheel::MAX_DELAY, [&](size_t value) {
+        ++expected[value].fired_count;
+        CHECK(wheel.GetTime() == expected[value].expires);
+        order.push_back(value);
+    });
+
+    CHECK(wheel.Size() == 0);
+    for(size_t i = 0; i < expected.size(); ++i) {
+        INFO("timer " << i);
+        CHECK(expected[i].fired_count == (expected[i].cancelled ? 0u : 1u));
+    }
+    for(size_t i = 1; i < order.size(); ++i) {
+        const auto& prev = expected[order[i - 1]];
+        const auto& current = expected[order[i]];
+        INFO("fired " << order[i - 1] << " then " << order[i]);
+        CHECK((prev.expires < current.expires || (prev.expires == current.expires && order[i - 1] < order[i])));
+    }
+}
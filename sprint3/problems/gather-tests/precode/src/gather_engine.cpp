@@ -0,0 +1,382 @@
+#include "gather_engine.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace collision_detector {
+
+namespace {
+
+// Запас к радиусу сбора при отборе клеток. Покрывает ошибки округления в TryCollectPoint,
+// из-за которых предмет чуть дальше радиуса всё же может считаться подобранным
+const double REACH_TOLERANCE = 1e-7;
+
+const size_t NOT_VISITED = std::numeric_limits<size_t>::max();
+// Координаты клеток ограничены, чтобы клетки далёких точек и бесконечных краёв выражались в int64_t
+const double MAX_CELL_COORD = 0x1p62;
+// Медианы для размера клетки считаются по выборке из стольких значений через равный шаг
+const size_t MEDIAN_SAMPLES = 1024;
+// Во столько раз клетка больше медианного шага: обычный отрезок задевает одну-четыре клетки
+const double CELL_SIZE_IN_STEPS = 4;
+
+bool IsFinite(geom::Point2D point) {
+    return std::isfinite(point.x) && std::isfinite(point.y);
+}
+
+void SortEvents(std::vector<GatheringEvent>& events) {
+    std::sort(events.begin(), events.end(), [](const GatheringEvent& lhs, const GatheringEvent& rhs) {
+        if (lhs.time != rhs.time) {
+            return lhs.time < rhs.time;
+        }
+        if (lhs.gatherer_id != rhs.gatherer_id) {
+            return lhs.gatherer_id < rhs.gatherer_id;
+        }
+        return lhs.item_id < rhs.item_id;
+    });
+}
+
+size_t GetSampleStride(size_t count) {
+    return std::max<size_t>(1, count / MEDIAN_SAMPLES);
+}
+
+double GetMedian(std::vector<double>& values) {
+    if (values.empty()) {
+        return 0;
+    }
+    const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+size_t HashCell(int64_t column, int64_t row) {
+    const uint64_t hash
+        = static_cast<uint64_t>(column) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(row) * 0xC2B2AE3D27D4EB4Full;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+// Предметы, лежащие в массивах подряд
+struct ItemBatch {
+    const double* xs;
+    const double* ys;
+    const double* widths;
+    const size_t* ids;
+    size_t count;
+};
+
+// Добавляет события для предметов пачки, отмеченных битами mask
+void AddCollected(int mask, const double* sq_distances, const double* proj_ratios, const ItemBatch& batch,
+                  size_t first, size_t gatherer_id, std::vector<GatheringEvent>& events) {
+    for (size_t lane = 0; mask != 0; ++lane, mask >>= 1) {
+        if (mask & 1) {
+            events.push_back({batch.ids[first + lane], gatherer_id, sq_distances[lane], proj_ratios[lane]});
+        }
+    }
+}
+
+/*
+ * Проверяет предметы пачки для отрезка из a в b. Векторные ветки выполняют те же операции
+ * в том же порядке, что TryCollectPoint и CollectionResult::IsCollected, поэтому результаты
+ * совпадают бит в бит. Хвост пачки проверяется самой TryCollectPoint.
+ */
+void CollectBatch(geom::Point2D a, geom::Point2D b, double gatherer_width, size_t gatherer_id,
+                  const ItemBatch& batch, std::vector<GatheringEvent>& events) {
+    size_t i = 0;
+#if defined(__AVX__)
+    {
+        const __m256d a_x = _mm256_set1_pd(a.x);
+        const __m256d a_y = _mm256_set1_pd(a.y);
+        const __m256d v_x = _mm256_set1_pd(b.x - a.x);
+        const __m256d v_y = _mm256_set1_pd(b.y - a.y);
+        const __m256d v_len2 = _mm256_add_pd(_mm256_mul_pd(v_x, v_x), _mm256_mul_pd(v_y, v_y));
+        const __m256d width = _mm256_set1_pd(gatherer_width);
+        const __m256d zero = _mm256_set1_pd(0.0);
+        const __m256d one = _mm256_set1_pd(1.0);
+        for (; i + 4 <= batch.count; i += 4) {
+            const __m256d u_x = _mm256_sub_pd(_mm256_loadu_pd(batch.xs + i), a_x);
+            const __m256d u_y = _mm256_sub_pd(_mm256_loadu_pd(batch.ys + i), a_y);
+            const __m256d u_dot_v = _mm256_add_pd(_mm256_mul_pd(u_x, v_x), _mm256_mul_pd(u_y, v_y));
+            const __m256d u_len2 = _mm256_add_pd(_mm256_mul_pd(u_x, u_x), _mm256_mul_pd(u_y, u_y));
+            const __m256d proj_ratio = _mm256_div_pd(u_dot_v, v_len2);
+            const __m256d sq_distance
+                = _mm256_sub_pd(u_len2, _mm256_div_pd(_mm256_mul_pd(u_dot_v, u_dot_v), v_len2));
+            const __m256d radius = _mm256_add_pd(width, _mm256_loadu_pd(batch.widths + i));
+            const __m256d collected
+                = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(proj_ratio, zero, _CMP_GE_OQ),
+                                              _mm256_cmp_pd(proj_ratio, one, _CMP_LE_OQ)),
+                                _mm256_cmp_pd(sq_distance, _mm256_mul_pd(radius, radius), _CMP_LE_OQ));
+            if (const int mask = _mm256_movemask_pd(collected); mask != 0) {
+                alignas(32) double sq_distances[4];
+                alignas(32) double proj_ratios[4];
+                _mm256_store_pd(sq_distances, sq_distance);
+                _mm256_store_pd(proj_ratios, proj_ratio);
+                AddCollected(mask, sq_distances, proj_ratios, batch, i, gatherer_id, events);
+            }
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    {
+        const __m128d a_x = _mm_set1_pd(a.x);
+        const __m128d a_y = _mm_set1_pd(a.y);
+        const __m128d v_x = _mm_set1_pd(b.x - a.x);
+        const __m128d v_y = _mm_set1_pd(b.y - a.y);
+        const __m128d v_len2 = _mm_add_pd(_mm_mul_pd(v_x, v_x), _mm_mul_pd(v_y, v_y));
+        const __m128d width = _mm_set1_pd(gatherer_width);
+        const __m128d zero = _mm_set1_pd(0.0);
+        const __m128d one = _mm_set1_pd(1.0);
+        for (; i + 2 <= batch.count; i += 2) {
+            const __m128d u_x = _mm_sub_pd(_mm_loadu_pd(batch.xs + i), a_x);
+            const __m128d u_y = _mm_sub_pd(_mm_loadu_pd(batch.ys + i), a_y);
+            const __m128d u_dot_v = _mm_add_pd(_mm_mul_pd(u_x, v_x), _mm_mul_pd(u_y, v_y));
+            const __m128d u_len2 = _mm_add_pd(_mm_mul_pd(u_x, u_x), _mm_mul_pd(u_y, u_y));
+            const __m128d proj_ratio = _mm_div_pd(u_dot_v, v_len2);
+            const __m128d sq_distance = _mm_sub_pd(u_len2, _mm_div_pd(_mm_mul_pd(u_dot_v, u_dot_v), v_len2));
+            const __m128d radius = _mm_add_pd(width, _mm_loadu_pd(batch.widths + i));
+            const __m128d collected
+                = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(proj_ratio, zero), _mm_cmple_pd(proj_ratio, one)),
+                             _mm_cmple_pd(sq_distance, _mm_mul_pd(radius, radius)));
+            if (const int mask = _mm_movemask_pd(collected); mask != 0) {
+                alignas(16) double sq_distances[2];
+                alignas(16) double proj_ratios[2];
+                _mm_store_pd(sq_distances, sq_distance);
+                _mm_store_pd(proj_ratios, proj_ratio);
+                AddCollected(mask, sq_distances, proj_ratios, batch, i, gatherer_id, events);
+            }
+        }
+    }
+#endif
+    for (; i < batch.count; ++i) {
+        const auto result = TryCollectPoint(a, b, {batch.xs[i], batch.ys[i]});
+        if (result.IsCollected(gatherer_width + batch.widths[i])) {
+            events.push_back({batch.ids[i], gatherer_id, result.sq_distance, result.proj_ratio});
+        }
+    }
+}
+
+}  // namespace
+
+std::vector<GatheringEvent> FindGatherEventsBruteForce(const ItemGathererProvider& provider) {
+    std::vector<GatheringEvent> events;
+    for (size_t gatherer_id = 0; gatherer_id < provider.GatherersCount(); ++gatherer_id) {
+        const Gatherer gatherer = provider.GetGatherer(gatherer_id);
+        if (gatherer.start_pos.x == gatherer.end_pos.x && gatherer.start_pos.y == gatherer.end_pos.y) {
+            continue;
+        }
+        for (size_t item_id = 0; item_id < provider.ItemsCount(); ++item_id) {
+            const Item item = provider.GetItem(item_id);
+            const auto result = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
+            if (result.IsCollected(gatherer.width + item.width)) {
+                events.push_back({item_id, gatherer_id, result.sq_distance, result.proj_ratio});
+            }
+        }
+    }
+    SortEvents(events);
+    return events;
+}
+
+std::vector<GatheringEvent> GatheringEngine::FindEvents(const ItemGathererProvider& provider) {
+    LoadItems(provider);
+    LoadGatherers(provider);
+    std::vector<GatheringEvent> events;
+    if (items_.empty() || segments_.empty()) {
+        return events;
+    }
+    BuildGrid();
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        CollectSegmentEvents(i, events);
+    }
+    SortEvents(events);
+    return events;
+}
+
+// Предметы с бесконечными координатами или шириной NaN подобрать нельзя, они не попадают в сетку
+void GatheringEngine::LoadItems(const ItemGathererProvider& provider) {
+    const size_t count = provider.ItemsCount();
+    items_.clear();
+    items_.reserve(count);
+    loaded_ids_.clear();
+    loaded_ids_.reserve(count);
+    max_item_width_ = 0;
+    for (size_t id = 0; id < count; ++id) {
+        const Item item = provider.GetItem(id);
+        if (!IsFinite(item.position) || std::isnan(item.width)) {
+            continue;
+        }
+        items_.push_back(item);
+        loaded_ids_.push_back(id);
+        max_item_width_ = std::max(max_item_width_, item.width);
+    }
+}
+
+// Собиратели, которые не сдвинулись или имеют бесконечные координаты, ничего не подбирают
+void GatheringEngine::LoadGatherers(const ItemGathererProvider& provider) {
+    const size_t count = provider.GatherersCount();
+    segments_.clear();
+    segments_.reserve(count);
+    for (size_t id = 0; id < count; ++id) {
+        const Gatherer gatherer = provider.GetGatherer(id);
+        if ((gatherer.start_pos.x == gatherer.end_pos.x && gatherer.start_pos.y == gatherer.end_pos.y)
+            || !IsFinite(gatherer.start_pos) || !IsFinite(gatherer.end_pos)) {
+            continue;
+        }
+        segments_.push_back({gatherer.start_pos, gatherer.end_pos, gatherer.width, id});
+    }
+}
+
+/*
+ * Размер клетки кратен медиане шага собирателя по большей из осей или медианному радиусу сбора,
+ * если он больше. Отдельные далёкие или длинные отрезки и широкие предметы на размер не влияют.
+ * Медианы берутся по выборке через равный шаг.
+ */
+double GatheringEngine::ChooseCellSize() {
+    const size_t segment_stride = GetSampleStride(segments_.size());
+    median_values_.clear();
+    for (size_t i = 0; i < segments_.size(); i += segment_stride) {
+        const Segment& segment = segments_[i];
+        median_values_.push_back(
+            std::max(std::abs(segment.end.x - segment.start.x), std::abs(segment.end.y - segment.start.y)));
+    }
+    const double step = GetMedian(median_values_);
+
+    median_values_.clear();
+    for (size_t i = 0; i < segments_.size(); i += segment_stride) {
+        if (!std::isnan(segments_[i].width)) {
+            median_values_.push_back(segments_[i].width);
+        }
+    }
+    const double gatherer_width = GetMedian(median_values_);
+
+    const size_t item_stride = GetSampleStride(items_.size());
+    median_values_.clear();
+    for (size_t i = 0; i < items_.size(); i += item_stride) {
+        median_values_.push_back(items_[i].width);
+    }
+    const double item_width = GetMedian(median_values_);
+    return CELL_SIZE_IN_STEPS * std::max(step, gatherer_width + item_width);
+}
+
+/*
+ * Клетки не хранятся: клетка хэшируется в одну из корзин, которых не меньше, чем предметов. Поэтому
+ * память и время построения зависят от числа предметов, а не от размаха их координат. В корзину
+ * попадают и предметы других клеток с тем же хэшем, их отсеивает точная проверка. Предметы
+ * раскладываются по корзинам сортировкой подсчётом, внутри корзины сохраняется порядок провайдера.
+ */
+void GatheringEngine::BuildGrid() {
+    grid_origin_ = items_.front().position;
+    for (const auto& item : items_) {
+        grid_origin_.x = std::min(grid_origin_.x, item.position.x);
+        grid_origin_.y = std::min(grid_origin_.y, item.position.y);
+    }
+    const double cell_size = ChooseCellSize();
+    inverse_cell_size_ = cell_size > 0 ? 1 / cell_size : 0;
+    if (!std::isfinite(inverse_cell_size_)) {
+        // Размер клетки не выражается в double: все предметы попадают в одну клетку
+        inverse_cell_size_ = 0;
+    }
+
+    buckets_count_ = std::bit_ceil(items_.size());
+    cell_begins_.assign(buckets_count_ + 1, 0);
+    item_cells_.resize(items_.size());
+    for (size_t i = 0; i < items_.size(); ++i) {
+        item_cells_[i] = GetBucket(GetCellCoord(items_[i].position.x, grid_origin_.x),
+                                   GetCellCoord(items_[i].position.y, grid_origin_.y));
+        ++cell_begins_[item_cells_[i] + 1];
+    }
+    for (size_t cell = 1; cell < cell_begins_.size(); ++cell) {
+        cell_begins_[cell] += cell_begins_[cell - 1];
+    }
+
+    // Сначала раскладывается только перестановка, а массивы предметов заполняются по ней подряд:
+    // так на каждый предмет приходится одна случайная запись вместо четырёх
+    cell_cursors_.assign(cell_begins_.begin(), cell_begins_.end() - 1);
+    cell_order_.resize(items_.size());
+    for (size_t i = 0; i < items_.size(); ++i) {
+        cell_order_[cell_cursors_[item_cells_[i]]++] = i;
+    }
+    item_xs_.resize(items_.size());
+    item_ys_.resize(items_.size());
+    item_widths_.resize(items_.size());
+    item_ids_.resize(items_.size());
+    for (size_t pos = 0; pos < items_.size(); ++pos) {
+        const size_t i = cell_order_[pos];
+        const auto& item = items_[i];
+        item_xs_[pos] = item.position.x;
+        item_ys_[pos] = item.position.y;
+        item_widths_[pos] = item.width;
+        item_ids_[pos] = loaded_ids_[i];
+    }
+    bucket_visits_.assign(buckets_count_, NOT_VISITED);
+}
+
+/*
+ * Проверяет предметы из клеток, которые пересекает прямоугольник отрезка, расширенный на наибольший
+ * радиус сбора. Разные клетки могут попасть в одну корзину, поэтому корзина, уже проверенная для этого
+ * отрезка, пропускается. Если прямоугольник задевает больше клеток, чем есть корзин, например у очень
+ * длинного отрезка, все предметы проверяются одной пачкой.
+ */
+void GatheringEngine::CollectSegmentEvents(size_t segment_index, std::vector<GatheringEvent>& events) {
+    const Segment& segment = segments_[segment_index];
+    const double radius = segment.width + max_item_width_;
+    const double scale = std::max({std::abs(segment.start.x), std::abs(segment.start.y), std::abs(segment.end.x),
+                                   std::abs(segment.end.y)});
+    const double length = std::abs(segment.end.x - segment.start.x) + std::abs(segment.end.y - segment.start.y);
+    const double reach = radius + (radius + length + scale) * REACH_TOLERANCE;
+    if (std::isnan(reach)) {
+        return;
+    }
+    const int64_t first_column = GetCellCoord(std::min(segment.start.x, segment.end.x) - reach, grid_origin_.x);
+    const int64_t last_column = GetCellCoord(std::max(segment.start.x, segment.end.x) + reach, grid_origin_.x);
+    const int64_t first_row = GetCellCoord(std::min(segment.start.y, segment.end.y) - reach, grid_origin_.y);
+    const int64_t last_row = GetCellCoord(std::max(segment.start.y, segment.end.y) + reach, grid_origin_.y);
+
+    const double range_cells = (static_cast<double>(last_column) - static_cast<double>(first_column) + 1)
+                             * (static_cast<double>(last_row) - static_cast<double>(first_row) + 1);
+    if (range_cells > static_cast<double>(buckets_count_)) {
+        const ItemBatch batch{item_xs_.data(), item_ys_.data(), item_widths_.data(), item_ids_.data(),
+                              item_ids_.size()};
+        CollectBatch(segment.start, segment.end, segment.width, segment.id, batch, events);
+        return;
+    }
+    for (int64_t row = first_row; row <= last_row; ++row) {
+        for (int64_t column = first_column; column <= last_column; ++column) {
+            const size_t bucket = GetBucket(column, row);
+            if (bucket_visits_[bucket] != segment_index) {
+                bucket_visits_[bucket] = segment_index;
+                CollectBucketEvents(segment, bucket, events);
+            }
+        }
+    }
+}
+
+void GatheringEngine::CollectBucketEvents(const Segment& segment, size_t bucket,
+                                        std::vector<GatheringEvent>& events) const {
+    const size_t first = cell_begins_[bucket];
+    const ItemBatch batch{item_xs_.data() + first, item_ys_.data() + first, item_widths_.data() + first,
+                          item_ids_.data() + first, cell_begins_[bucket + 1] - first};
+    CollectBatch(segment.start, segment.end, segment.width, segment.id, batch, events);
+}
+
+// Номер клетки монотонно зависит от координаты, поэтому предмет внутри прямоугольника всегда
+// лежит в клетке между клетками его углов. Бесконечности и NaN попадают в крайние клетки
+int64_t GatheringEngine::GetCellCoord(double value, double origin) const {
+    if (inverse_cell_size_ == 0) {
+        return 0;
+    }
+    const double coord = std::floor((value - origin) * inverse_cell_size_);
+    if (!(coord > -MAX_CELL_COORD)) {
+        return static_cast<int64_t>(-MAX_CELL_COORD);
+    }
+    return static_cast<int64_t>(std::min(coord, MAX_CELL_COORD));
+}
+
+size_t GatheringEngine::GetBucket(int64_t column, int64_t row) const {
+    return HashCell(column, row) & (buckets_count_ - 1);
+}
+
+}  // namespace collision_detector
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "collision_detector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace collision_detector {
+
+// Эталонный поиск событий: проверка всех пар собирателей и предметов.
+// События упорядочены по времени, при равном времени - по номеру собирателя, затем по номеру предмета.
+std::vector<GatheringEvent> FindGatherEventsBruteForce(const ItemGathererProvider& provider);
+
+/*
+ * Поиск событий сбора без перебора всех пар.
+ * За вызов данные провайдера один раз копируются в плоские массивы, предметы раскладываются
+ * по хэшированной сетке, и каждый собиратель проверяет только предметы из клеток, которые задевает
+ * его отрезок, расширенный на радиус сбора. Размер клетки берётся из длины шага и радиуса сбора,
+ * а не из размаха координат, поэтому далёкие от остальных предметы не укрупняют сетку. Предметы
+ * корзины лежат в массивах подряд, поэтому проверка идёт пачкой по непрерывному диапазону
+ * (SSE2/AVX, если они доступны).
+ * Результат совпадает с FindGatherEventsBruteForce бит в бит, включая порядок событий.
+ * Буферы переиспользуются между вызовами, поэтому движок стоит хранить между тиками.
+ */
+class GatheringEngine {
+public:
+    std::vector<GatheringEvent> FindEvents(const ItemGathererProvider& provider);
+
+private:
+    struct Segment {
+        geom::Point2D start;
+        geom::Point2D end;
+        double width;
+        size_t id;
+    };
+
+    void LoadItems(const ItemGathererProvider& provider);
+    void LoadGatherers(const ItemGathererProvider& provider);
+    double ChooseCellSize();
+    void BuildGrid();
+    void CollectSegmentEvents(size_t segment_index, std::vector<GatheringEvent>& events);
+    void CollectBucketEvents(const Segment& segment, size_t bucket, std::vector<GatheringEvent>& events) const;
+
+    int64_t GetCellCoord(double value, double origin) const;
+    size_t GetBucket(int64_t column, int64_t row) const;
+
+    // Предметы в порядке провайдера и их номера у провайдера
+    std::vector<Item> items_;
+    std::vector<size_t> loaded_ids_;
+    std::vector<size_t> item_cells_;
+    std::vector<size_t> cell_order_;
+    double max_item_width_ = 0;
+
+    // Собиратели, которые сдвинулись за тик
+    std::vector<Segment> segments_;
+    // Значения, из медиан которых выбирается размер клетки
+    std::vector<double> median_values_;
+
+    // Сетка: начало и величина, обратная размеру клетки
+    geom::Point2D grid_origin_;
+    double inverse_cell_size_ = 0;
+
+    // Число корзин (степень двойки) и номер отрезка, для которого корзина проверялась последней
+    size_t buckets_count_ = 0;
+    std::vector<size_t> bucket_visits_;
+
+    // Начала корзин в массивах предметов, последний элемент - число предметов
+    std::vector<size_t> cell_begins_;
+    std::vector<size_t> cell_cursors_;
+
+    // Предметы, упорядоченные по клеткам
+    std::vector<double> item_xs_;
+    std::vector<double> item_ys_;
+    std::vector<double> item_widths_;
+    std::vector<size_t> item_ids_;
+};
+
+}  // namespace collision_detector
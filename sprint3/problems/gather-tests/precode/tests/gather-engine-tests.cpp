@@ -0,0 +1,204 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../src/gather_engine.h"
+
+namespace {
+
+using namespace collision_detector;
+
+class VectorProvider : public ItemGathererProvider {
+public:
+    VectorProvider(std::vector<Item> items, std::vector<Gatherer> gatherers)
+        : items_(std::move(items))
+        , gatherers_(std::move(gatherers)) {
+    }
+
+    size_t ItemsCount() const override {
+        return items_.size();
+    }
+    Item GetItem(size_t idx) const override {
+        return items_[idx];
+    }
+    size_t GatherersCount() const override {
+        return gatherers_.size();
+    }
+    Gatherer GetGatherer(size_t idx) const override {
+        return gatherers_[idx];
+    }
+
+    void AddItem(Item item) {
+        items_.push_back(item);
+    }
+    void AddGatherer(Gatherer gatherer) {
+        gatherers_.push_back(gatherer);
+    }
+
+private:
+    std::vector<Item> items_;
+    std::vector<Gatherer> gatherers_;
+};
+
+bool BitEqual(double lhs, double rhs) {
+    return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+}
+
+void RequireSameEvents(const std::vector<GatheringEvent>& actual, const std::vector<GatheringEvent>& expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        INFO("event " << i);
+        CHECK(actual[i].item_id == expected[i].item_id);
+        CHECK(actual[i].gatherer_id == expected[i].gatherer_id);
+        CHECK(BitEqual(actual[i].sq_distance, expected[i].sq_distance));
+        CHECK(BitEqual(actual[i].time, expected[i].time));
+    }
+}
+
+// Предметы разбросаны по квадрату со стороной side, собиратели делают короткие шаги вдоль осей
+// или по диагонали, как собаки на картах с дорогами
+VectorProvider MakeRandomProvider(size_t items_count, size_t gatherers_count, double side, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coord_dist(0.0, side);
+    std::uniform_real_distribution<double> step_dist(-3.0, 3.0);
+    std::uniform_real_distribution<double> width_dist(0.0, 0.6);
+    std::vector<Item> items;
+    for (size_t i = 0; i < items_count; ++i) {
+        items.push_back({{coord_dist(generator), coord_dist(generator)}, width_dist(generator)});
+    }
+    std::vector<Gatherer> gatherers;
+    for (size_t i = 0; i < gatherers_count; ++i) {
+        const geom::Point2D start{coord_dist(generator), coord_dist(generator)};
+        geom::Vec2D step{step_dist(generator), step_dist(generator)};
+        switch (generator() % 3) {
+            case 0:
+                step.y = 0;
+                break;
+            case 1:
+                step.x = 0;
+                break;
+        }
+        gatherers.push_back({start, start + step, width_dist(generator)});
+    }
+    return {std::move(items), std::move(gatherers)};
+}
+
+}  // namespace
+
+SCENARIO("Gathering engine") {
+    GatheringEngine engine;
+
+    GIVEN("no items or no gatherers") {
+        THEN("no events are found") {
+            CHECK(engine.FindEvents(VectorProvider{{}, {{{0, 0}, {1, 0}, 1.}}}).empty());
+            CHECK(engine.FindEvents(VectorProvider{{{{0, 0}, 1.}}, {}}).empty());
+        }
+    }
+
+    GIVEN("a gatherer passing several items") {
+        const VectorProvider provider{{{{5, 0.5}, 0.}, {{1, 0}, 0.}, {{3, 2}, 0.5}, {{-1, 0}, 1.}, {{10.5, 0}, 0.}},
+                                      {{{0, 0}, {10, 0}, 0.6}}};
+        WHEN("events are found") {
+            const auto events = engine.FindEvents(provider);
+            THEN("they match the brute force search and are sorted by time") {
+                RequireSameEvents(events, FindGatherEventsBruteForce(provider));
+                REQUIRE(events.size() == 2);
+                CHECK(events[0].item_id == 1);
+                CHECK(events[1].item_id == 0);
+            }
+        }
+    }
+
+    GIVEN("items collected at the same time") {
+        const VectorProvider provider{{{{2, 0}, 0.}, {{0, 2}, 0.}, {{2, 0.1}, 0.}},
+                                      {{{0, 0}, {0, 4}, 0.5}, {{0, 0}, {4, 0}, 0.5}}};
+        THEN("events are ordered by gatherer and item") {
+            const auto events = engine.FindEvents(provider);
+            REQUIRE(events.size() == 3);
+            CHECK(events[0].gatherer_id == 0);
+            CHECK(events[1].gatherer_id == 1);
+            CHECK(events[1].item_id == 0);
+            CHECK(events[2].item_id == 2);
+            RequireSameEvents(events, FindGatherEventsBruteForce(provider));
+        }
+    }
+
+    GIVEN("gatherers that can't collect anything") {
+        const double inf = std::numeric_limits<double>::infinity();
+        const VectorProvider provider{{{{1, 1}, 1.}, {{inf, 0}, 1.}},
+                                      {{{1, 1}, {1, 1}, 1.}, {{0, 0}, {inf, 0}, 1.}, {{0, 1}, {2, 1}, 0.}}};
+        THEN("only moving gatherers with finite positions collect items") {
+            const auto events = engine.FindEvents(provider);
+            REQUIRE(events.size() == 1);
+            CHECK(events[0].gatherer_id == 2);
+            RequireSameEvents(events, FindGatherEventsBruteForce(provider));
+        }
+    }
+
+    GIVEN("random items and gatherers") {
+        THEN("events match the brute force search on every call") {
+            for (unsigned seed = 0; seed < 20; ++seed) {
+                INFO("seed: " << seed);
+                const auto provider = MakeRandomProvider(1000 + seed * 37, 300 + seed * 11, 50.0 + seed * 10, seed);
+                RequireSameEvents(engine.FindEvents(provider), FindGatherEventsBruteForce(provider));
+            }
+        }
+    }
+
+    GIVEN("an item far away from the others") {
+        auto provider = MakeRandomProvider(1000, 300, 100.0, 1);
+        provider.AddItem({{1e9, 1e9}, 0.});
+        provider.AddGatherer({{1e9 - 1, 1e9}, {1e9 + 1, 1e9}, 0.5});
+        THEN("events match the brute force search, including the far item") {
+            const auto events = engine.FindEvents(provider);
+            RequireSameEvents(events, FindGatherEventsBruteForce(provider));
+            CHECK(std::any_of(events.begin(), events.end(), [](const GatheringEvent& event) {
+                return event.item_id == 1000 && event.gatherer_id == 300;
+            }));
+        }
+    }
+
+    GIVEN("a gatherer crossing the whole map in one step") {
+        auto provider = MakeRandomProvider(1000, 300, 100.0, 2);
+        provider.AddGatherer({{-1e9, 50}, {1e9, 50}, 0.5});
+        provider.AddGatherer({{0, 0}, {100, 100}, 0.5});
+        THEN("events match the brute force search") {
+            RequireSameEvents(engine.FindEvents(provider), FindGatherEventsBruteForce(provider));
+        }
+    }
+
+    GIVEN("all items in one point") {
+        const VectorProvider provider{{{{1, 1}, 0.}, {{1, 1}, 0.2}, {{1, 1}, 0.}},
+                                      {{{0, 1}, {3, 1}, 0.}, {{1, 5}, {1, 1.1}, 0.1}}};
+        THEN("events match the brute force search") {
+            RequireSameEvents(engine.FindEvents(provider), FindGatherEventsBruteForce(provider));
+        }
+    }
+}
+
+// Замер на целевом размере тика, запускается явно: gather_engine_tests "[benchmark]"
+TEST_CASE("Gathering engine benchmark", "[.][benchmark]") {
+    const auto provider = MakeRandomProvider(100'000, 10'000, 2000.0, 1);
+    GatheringEngine engine;
+    BENCHMARK("10k gatherers x 100k items") {
+        return engine.FindEvents(provider);
+    };
+
+    // Один далёкий предмет или один очень длинный отрезок не должны сводить поиск к перебору всех пар
+    auto outlier_item_provider = provider;
+    outlier_item_provider.AddItem({{1e9, 1e9}, 0.});
+    BENCHMARK("10k gatherers x 100k items, one item far away") {
+        return engine.FindEvents(outlier_item_provider);
+    };
+    auto outlier_gatherer_provider = provider;
+    outlier_gatherer_provider.AddGatherer({{0, 0}, {1e9, 0}, 0.5});
+    BENCHMARK("10k gatherers x 100k items, one gatherer crossing the map") {
+        return engine.FindEvents(outlier_gatherer_provider);
+    };
+}
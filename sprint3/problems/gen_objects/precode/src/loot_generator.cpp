@@ -9,9 +9,13 @@ unsigned LootGenerator::Generate(TimeInterval time_delta, unsigned loot_count,
                                  unsigned looter_count) {
     time_without_loot_ += time_delta;
     const unsigned loot_shortage = loot_count > looter_count ? 0u : looter_count - loot_count;
+    if (loot_shortage == 0 || time_without_loot_.count() == 0) {
+        return 0;
+    }
     const double ratio = std::chrono::duration<double>{time_without_loot_} / base_interval_;
+    // Логарифм посчитан в конструкторе, вместо std::pow на каждом вызове остаётся одна экспонента
     const double probability
-        = std::clamp((1.0 - std::pow(1.0 - probability_, ratio)) * random_generator_(), 0.0, 1.0);
+        = std::clamp(-std::expm1(ratio * log_no_loot_probability_) * random_generator_(), 0.0, 1.0);
     const unsigned generated_loot = static_cast<unsigned>(std::round(loot_shortage * probability));
     if (generated_loot > 0) {
         time_without_loot_ = {};
@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include <cmath>
 #include <functional>
 
 namespace loot_gen {
@@ -20,7 +21,7 @@ public:
     LootGenerator(TimeInterval base_interval, double probability,
                   RandomGenerator random_gen = DefaultGenerator)
         : base_interval_{base_interval}
-        , probability_{probability}
+        , log_no_loot_probability_{std::log1p(-probability)}
         , random_generator_{std::move(random_gen)} {
     }
 
@@ -28,6 +29,7 @@ public:
      * Возвращает количество трофеев, которые должны появиться на карте спустя
      * заданный промежуток времени.
      * Количество трофеев, появляющихся на карте не превышает количество мародёров.
+     * Если трофеев на карте хватает всем мародёрам, генератор случайных чисел не вызывается.
      *
      * time_delta - отрезок времени, прошедший с момента предыдущего вызова Generate
      * loot_count - количество трофеев на карте до вызова Generate
@@ -40,7 +42,8 @@ private:
         return 1.0;
     };
     TimeInterval base_interval_;
-    double probability_;
+    // ln(1 - probability): вероятность, что за ratio базовых интервалов трофей не появится, - exp(ratio * ln(1 - probability))
+    double log_no_loot_probability_;
     TimeInterval time_without_loot_{};
     RandomGenerator random_generator_;
 };